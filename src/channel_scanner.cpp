@@ -0,0 +1,173 @@
+#include "channel_scanner.h"
+#include "radio_sx1262.h"
+#include "tx_module.h"
+#include <Arduino.h>
+#include <cstring>
+
+ChannelScanner::ChannelScanner(RadioSX1262& radio, TxModule& tx)
+    : radio_(radio), tx_(tx) {}
+
+bool ChannelScanner::start() {
+  if (isRunning()) {
+    return false;
+  }
+  const size_t count = radio_.getBankSize();
+  if (radio_.getBank() != bank_ || entries_.size() != count) {
+    entries_.assign(count, Entry{});       // таблица другого банка не годится
+    completedOnce_ = false;
+  }
+  bank_ = radio_.getBank();
+  channel_ = 0;
+  state_ = State::NEXT;
+  LOG_INFO("SEAR: обход %u каналов запущен", static_cast<unsigned>(count));
+  return true;
+}
+
+uint32_t ChannelScanner::resultAgeMs() const {
+  return completedOnce_ ? millis() - completedMs_ : 0;
+}
+
+void ChannelScanner::loop() {
+  switch (state_) {
+    case State::IDLE:
+      if (completedOnce_ && refreshMs_ > 0 && resultAgeMs() >= refreshMs_) {
+        start();                           // фоновое обновление таблицы
+      }
+      return;
+    case State::NEXT:
+      beginChannel();
+      return;
+    case State::CAD_WAIT: {
+      const ChannelState cad = radio_.pollChannelScan();
+      if (cad == ChannelState::PENDING) {
+        return;
+      }
+      Entry& e = entries_[channel_];
+      e.cadActivity = (cad == ChannelState::BUSY);
+      if (cad == ChannelState::UNSUPPORTED || shouldPing(e, millis())) {
+        startPing();
+      } else {
+        e.skipped = true;                  // канал молчит и раньше не отвечал — эфир не тратим
+        finishChannel();
+      }
+      return;
+    }
+    case State::PING_WAIT: {
+      std::array<uint8_t, DefaultSettings::PING_PACKET_SIZE> resp{};
+      size_t respLen = 0;
+      uint32_t elapsed = 0;
+      const int16_t state = radio_.pollPing(resp.data(), resp.size(), respLen, elapsed);
+      if (state == IRadio::ERR_PENDING) {
+        return;
+      }
+      tx_.completeExternalSend();
+      Entry& e = entries_[channel_];
+      if (state == IRadio::ERR_NONE && respLen == ping_.size() &&
+          std::memcmp(resp.data(), ping_.data(), ping_.size()) == 0) {
+        e.status = Status::ALIVE;
+        e.rssi = radio_.getLastRssi();
+        e.snr = radio_.getLastSnr();
+        e.rttUs = elapsed;
+        e.lastSeenMs = millis();
+      } else if (state == IRadio::ERR_NONE) {
+        e.status = Status::ERROR;          // принят чужой пакет вместо эха
+        e.lastError = 0;
+      } else if (state == RadioSX1262::ERR_PING_TIMEOUT) {
+        e.status = Status::NO_RESPONSE;
+      } else {
+        e.status = Status::ERROR;
+        e.lastError = state;
+      }
+      finishChannel();
+      return;
+    }
+  }
+}
+
+// Начало вылазки: TxModule приостанавливается, радио уходит на проверяемый канал
+void ChannelScanner::beginChannel() {
+  if (radio_.getBank() != bank_) {
+    LOG_WARN("SEAR: банк сменён во время обхода, обход прерван");
+    state_ = State::IDLE;
+    return;
+  }
+  if (channel_ >= entries_.size()) {
+    finishScan();
+    return;
+  }
+  if (tx_.isSending() || radio_.isTransmitting() || radio_.isPinging()) {
+    return;                                // дожидаемся окончания чужой передачи
+  }
+  home_ = radio_.getChannel();
+  tx_.setSuspended(true);
+  excursion_ = true;
+  Entry& e = entries_[channel_];
+  e.skipped = false;
+  if (channel_ != home_ && !radio_.setChannel(static_cast<uint8_t>(channel_))) {
+    e.status = Status::ERROR;
+    e.lastError = radio_.getLastErrorCode();
+    finishChannel();
+    return;
+  }
+  if (radio_.startChannelScan() != IRadio::ERR_NONE) {
+    e.cadActivity = false;
+    startPing();                           // без CAD решить нечего — пингуем
+    return;
+  }
+  state_ = State::CAD_WAIT;
+}
+
+void ChannelScanner::startPing() {
+  ping_[1] = radio_.randomByte();
+  ping_[2] = radio_.randomByte();          // ID пинга
+  ping_[0] = ping_[1] ^ ping_[2];          // контрольный байт
+  ping_[3] = 0;
+  ping_[4] = 0;
+  Entry& e = entries_[channel_];
+  tx_.prepareExternalSend();
+  e.lastPingMs = millis();
+  const int16_t state = radio_.startPing(ping_.data(), ping_.size(),
+                                         DefaultSettings::PING_WAIT_MS * 1000UL);
+  if (state != IRadio::ERR_NONE) {
+    tx_.completeExternalSend();
+    e.status = Status::ERROR;
+    e.lastError = state;
+    finishChannel();
+    return;
+  }
+  state_ = State::PING_WAIT;
+}
+
+// Конец вылазки: возврат на рабочий канал, если его не сменили за это время
+void ChannelScanner::finishChannel() {
+  if (excursion_) {
+    if (home_ != channel_ && radio_.getChannel() == channel_) {
+      radio_.setChannel(home_);
+    }
+    excursion_ = false;
+    tx_.setSuspended(false);
+  }
+  ++channel_;
+  state_ = State::NEXT;
+}
+
+void ChannelScanner::finishScan() {
+  state_ = State::IDLE;
+  completedMs_ = millis();
+  completedOnce_ = true;
+  size_t alive = 0;
+  for (const Entry& e : entries_) {
+    if (e.status == Status::ALIVE) ++alive;
+  }
+  LOG_INFO("SEAR: обход завершён, ответили %u из %u каналов",
+           static_cast<unsigned>(alive), static_cast<unsigned>(entries_.size()));
+}
+
+// Пинг нужен каналу с активностью по CAD, ещё не проверенному или отвечавшему;
+// молчащий канал перепроверяется не чаще SEAR_DEAD_RECHECK_MS
+bool ChannelScanner::shouldPing(const Entry& e, uint32_t now) const {
+  if (e.cadActivity || e.status != Status::NO_RESPONSE) {
+    return true;
+  }
+  return (now - e.lastPingMs) >= DefaultSettings::SEAR_DEAD_RECHECK_MS;
+}
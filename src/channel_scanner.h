@@ -0,0 +1,83 @@
+#pragma once
+// Фоновый обход каналов банка для команды SEAR.
+// Сканер работает как конечный автомат и продвигается из loop(): каждый канал проверяется
+// короткой вылазкой (перестройка, CAD, при необходимости пинг и возврат на рабочий канал),
+// между вылазками очередь TxModule обслуживается как обычно. Результаты остаются в таблице,
+// поэтому SEAR и вкладка каналов читают их мгновенно.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "channel_bank.h"
+#include "default_settings.h"
+
+class RadioSX1262;
+class TxModule;
+
+class ChannelScanner {
+public:
+  // Итог последней проверки канала
+  enum class Status : uint8_t {
+    UNKNOWN,      // канал ещё не проверялся
+    ALIVE,        // получено эхо на пинг
+    NO_RESPONSE,  // эхо не пришло за PING_WAIT_MS
+    ERROR,        // ошибка радио или чужой ответ
+  };
+
+  struct Entry {
+    Status status = Status::UNKNOWN;
+    bool cadActivity = false;   // CAD слышал LoRa на RX-частоте при последнем обходе
+    bool skipped = false;       // в последнем обходе пинг пропущен: канал молчит и не отвечал
+    float rssi = 0.0f;          // RSSI последнего эха (дБм)
+    float snr = 0.0f;           // SNR последнего эха (дБ)
+    uint32_t rttUs = 0;         // время от отправки пинга до эха
+    uint32_t lastSeenMs = 0;    // момент последнего эха (millis), 0 — не отвечал
+    uint32_t lastPingMs = 0;    // момент последнего пинга (millis)
+    int16_t lastError = 0;      // код радио при Status::ERROR
+  };
+
+  ChannelScanner(RadioSX1262& radio, TxModule& tx);
+
+  // Запуск обхода текущего банка; false — обход уже идёт
+  bool start();
+  // Шаг автомата; вызывается из основного цикла и никогда не ждёт эфира
+  void loop();
+
+  bool isRunning() const { return state_ != State::IDLE; }
+  // Идёт вылазка: радио настроено на проверяемый канал, сторонние пинги и передачи ждут
+  bool isProbing() const { return excursion_; }
+  // Есть ли завершённый обход и сколько ему миллисекунд
+  bool hasResults() const { return completedOnce_; }
+  uint32_t resultAgeMs() const;
+  // Проверено каналов в текущем обходе
+  size_t progress() const { return channel_; }
+  size_t size() const { return entries_.size(); }
+  const Entry& entry(size_t ch) const { return entries_[ch]; }
+  ChannelBank bank() const { return bank_; }
+  // Период фонового обновления после первого обхода (0 — только по запросу)
+  void setRefreshInterval(uint32_t ms) { refreshMs_ = ms; }
+
+private:
+  enum class State : uint8_t { IDLE, NEXT, CAD_WAIT, PING_WAIT };
+
+  void beginChannel();
+  void startPing();
+  void finishChannel();
+  void finishScan();
+  bool shouldPing(const Entry& e, uint32_t now) const;
+
+  RadioSX1262& radio_;
+  TxModule& tx_;
+  State state_ = State::IDLE;
+  ChannelBank bank_ = DefaultSettings::BANK;
+  std::vector<Entry> entries_;
+  size_t channel_ = 0;                   // проверяемый канал
+  uint8_t home_ = 0;                     // рабочий канал, на который возвращаемся после вылазки
+  bool excursion_ = false;               // радио сейчас настроено на проверяемый канал
+  std::array<uint8_t, DefaultSettings::PING_PACKET_SIZE> ping_{};
+  uint32_t refreshMs_ = DefaultSettings::SEAR_REFRESH_MS;
+  uint32_t completedMs_ = 0;             // окончание последнего обхода (millis)
+  bool completedOnce_ = false;
+};
@@ -29,17 +29,70 @@ namespace DefaultSettings {
   constexpr uint8_t CR_PRESET = 0;                // Индекс коэффициента кодирования
   // Параметры LoRa/RadioLib вынесены в отдельный заголовок
   constexpr bool RX_BOOSTED_GAIN = LoRaRadioLibSettings::DEFAULT_RX_BOOSTED_GAIN; // Режим повышенного усиления приёмника
+  constexpr bool USE_DUAL_RADIO = false;           // Второй SX1262 постоянно слушает RX-частоту, первый только передаёт
+  constexpr int DOWNLINK_RADIO_CS_PIN = 15;        // Выводы SX1262 даунлинка: NSS
+  constexpr int DOWNLINK_RADIO_IRQ_PIN = 33;       // DIO1
+  constexpr int DOWNLINK_RADIO_RST_PIN = 32;       // RESET
+  constexpr int DOWNLINK_RADIO_BUSY_PIN = 4;       // BUSY
   constexpr size_t GATHER_BLOCK_SIZE = 110;       // Размер блока для PacketGatherer
   constexpr uint32_t SEND_PAUSE_MS = 370;          // Ожидание между отправками и приёмом (мс)
+  constexpr bool USE_AIRTIME_PACING = true;        // Паузы по фактическому времени кадра в эфире вместо SEND_PAUSE_MS
+  constexpr uint32_t RX_TURNAROUND_MS = 30;        // Разворот станций TX→RX после кадра при airtime-пейсинге (мс)
+  constexpr uint8_t DUTY_CYCLE_PERCENT = 100;      // Допустимая доля занятого эфира (%), 100 — без ограничения
+  constexpr uint32_t DUTY_CYCLE_WINDOW_MS = 60000; // Окно учёта бюджета эфира (мс)
+  constexpr bool USE_TX_BURST = true;              // Фрагменты сообщения подряд одной серией без возврата в RX
+  constexpr size_t TX_BURST_MAX_FRAMES = 8;        // Максимум фрагментов в одной серии (задержка вытеснения QoS)
+  constexpr bool USE_LBT = true;                   // Проверка канала (CAD) перед передачей вместо слепой SEND_PAUSE_MS
+  constexpr uint32_t LBT_BACKOFF_MIN_MS = 20;      // Нижняя граница случайной отсрочки при занятом канале (мс)
+  constexpr uint32_t LBT_BACKOFF_MAX_MS = 640;     // Верхняя граница экспоненциальной отсрочки (мс)
+  constexpr uint8_t LBT_MAX_ATTEMPTS = 8;          // Подряд занятых CAD, после которых кадр уходит без проверки
+  constexpr bool USE_LINK_ADAPTATION = false;      // Подбор SF/CR/FEC по SNR и PER приёма с анонсом ступени пиру
+  constexpr float LINK_TARGET_PER = 0.1f;          // Допустимая доля потерянных кадров на выбранной ступени
+  constexpr float LINK_SNR_MARGIN_DB = 3.0f;       // Запас SNR над порогом демодуляции ступени (дБ)
+  constexpr float LINK_HYSTERESIS_DB = 2.0f;       // Дополнительный запас для перехода на более быструю ступень (дБ)
+  constexpr uint32_t LINK_HOLD_MS = 15000;         // Минимальный интервал между повышениями ступени (мс)
+  constexpr uint32_t LINK_ADVERT_MS = 30000;       // Период повторного анонса ступени пиру (мс)
+  constexpr uint32_t LINK_FALLBACK_MS = 60000;     // Тишина от пира, после которой профиль возвращается к базовому (мс)
+  constexpr uint8_t LINK_MIN_SAMPLES = 4;          // Принятых кадров до первого решения на новой ступени
   constexpr uint32_t ACK_TIMEOUT_MS = 320;         // Тайм-аут ожидания ACK перед повтором (мс)
   constexpr uint32_t PING_WAIT_MS = 500;           // Ожидание ответа на пинг (мс)
   constexpr size_t PING_PACKET_SIZE = 5;           // Размер пинг-пакета (байты)
+  constexpr uint32_t SEAR_CACHE_MS = 60000;        // Возраст таблицы SEAR, после которого запрос запускает обход (мс)
+  constexpr uint32_t SEAR_REFRESH_MS = 600000;     // Фоновое обновление таблицы SEAR после первого запроса (мс, 0 — выкл.)
+  constexpr uint32_t SEAR_DEAD_RECHECK_MS = 1800000; // Молчащий канал без активности по CAD снова пингуется не раньше (мс)
   constexpr size_t SERIAL_BUFFER_LIMIT = 500UL * 1024UL; // Максимальный размер буфера приёма по Serial (байты)
   constexpr uint16_t PREAMBLE_LENGTH = LoRaRadioLibSettings::DEFAULT_PREAMBLE_LENGTH;          // Длина преамбулы LoRa (символы)
   constexpr size_t TX_QUEUE_CAPACITY = 160;        // Ёмкость очередей TxModule (до четырёх сообщений по 5000 байт)
+  constexpr size_t TX_PLAIN_MAX_LEN = 256;         // Предел «сырого» кадра: длиннее — только фрагментами при USE_FRAMED_LONG
+  constexpr bool USE_FRAMED_LONG = false;          // Принимать сообщения длиннее TX_PLAIN_MAX_LEN (кадры с FrameHeader; приём пока не декодирует)
+  constexpr size_t TX_SUBMIT_QUEUE = 16;           // Заявок TxModule::submit() до переноса в очереди (степень двойки)
+  constexpr size_t TX_SUBMIT_INLINE = 128;         // Заявка длиннее (байт) копируется в отдельный блок памяти
+  constexpr uint8_t TX_BULK_QOS = 2;               // Класс QoS объёмных передач (изображения, TXL): чат вытесняет их между фрагментами
+  constexpr bool USE_AGGREGATION = false;          // Склеивать накопившиеся короткие сообщения в один кадр
+  constexpr uint8_t AGGREGATE_MAX_QOS = 1;         // Агрегируются только классы QoS 0..AGGREGATE_MAX_QOS
+  constexpr size_t AGGREGATE_MAX_RECORD = 64;      // Сообщение длиннее этого (байт) уходит отдельным кадром
+  constexpr size_t AGGREGATE_MAX_FRAME = 200;      // Наибольшая длина агрегированного кадра (байт)
+  constexpr bool USE_COMPRESSION = false;          // Сжимать «сырые» сообщения (LZSS), если кадр становится короче
+  constexpr bool COMPRESS_DICTIONARY = true;       // Подставлять в окно LZSS статический словарь чата и команд
+  constexpr size_t COMPRESS_MAX_OUTPUT = 512;      // Предел распакованного кадра на приёме (байт)
   constexpr bool USE_RS = false;                   // использовать кодирование RS(255,223)
   constexpr bool USE_CONV = true;                  // применять свёрточное кодирование
   constexpr bool USE_BIT_INTERLEAVER = true;       // включить битовый интерливинг после свёртки
+  constexpr uint8_t CONV_RATE = 0;                 // Скорость свёртки: 0 — 1/2, 1 — 2/3, 2 — 3/4, 3 — 5/6 (прокалывание)
+  constexpr bool USE_CONV_PUNCTURING = false;      // Проколотые скорости 2/3…5/6 на передаче: приёмник пока декодирует только 1/2
+  constexpr uint8_t FRAME_INTERLEAVE = 1;          // Межкадровый интерливинг: блоков в группе (1 — выкл., до 8)
+  constexpr bool USE_AIRTIME_PLANNER = true;       // Размер фрагментов по минимуму времени в эфире, а не по максимуму
+  constexpr bool USE_DELTA_HEADER = false;         // Дельта-заголовки 3–4 байта для фрагментов после полного заголовка
+  constexpr size_t DELTA_HEADER_REFRESH = 8;       // Полный заголовок повторяется каждые N фрагментов сообщения
+  constexpr bool USE_HARQ = false;                 // HARQ с нарастающей избыточностью: первая передача 5/6, остальное по NACK
+  constexpr size_t HARQ_HISTORY = 4;               // Сообщений, для которых передатчик хранит вход кодера под NACK
+  constexpr uint8_t OUTER_FEC_PERCENT = 0;         // Восстановительных фрагментов поверх сообщения, % от исходных (0 — выкл.)
+  constexpr size_t OUTER_FEC_MIN_FRAGMENTS = 4;    // Внешний код применяется к сообщениям не короче стольких фрагментов
+  constexpr bool USE_JPEG_UEP = false;             // Изображения JPEG с неравной защитой: заголовки усилены, скан облегчён
+  constexpr uint8_t UEP_HEADER_COPIES = 2;         // Передач каждого фрагмента с маркерными сегментами JPEG
+  constexpr uint8_t UEP_SCAN_RATE = 2;             // Скорость свёртки данных скана не ниже: 1 — 2/3, 2 — 3/4, 3 — 5/6
+  constexpr size_t CHASE_CACHE_SLOTS = 8;          // Фрагментов, копии которых приёмник держит одновременно
+  constexpr size_t CHASE_MAX_FRAME_LEN = 245;      // Наибольшая длина накапливаемой полезной нагрузки (байт)
   constexpr bool USE_ACK = false;                  // использовать подтверждения ACK
   constexpr uint8_t ACK_RETRY_LIMIT = 3;           // Количество повторных отправок при ожидании ACK
   constexpr uint32_t ACK_RESPONSE_DELAY_MS = 20;   // Задержка перед отправкой ACK после приёма (мс)
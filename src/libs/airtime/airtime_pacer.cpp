@@ -0,0 +1,62 @@
+#include "airtime_pacer.h"
+#include <algorithm>
+
+AirtimePacer::AirtimePacer(uint32_t turnaround_ms, uint8_t duty_percent, uint32_t window_ms)
+    : turnaround_ms_(turnaround_ms), window_ms_(window_ms) {
+  setDutyCycle(duty_percent);
+}
+
+void AirtimePacer::setTurnaround(uint32_t turnaround_ms) { turnaround_ms_ = turnaround_ms; }
+
+void AirtimePacer::setDutyCycle(uint8_t percent) {
+  duty_percent_ = std::min<uint8_t>(std::max<uint8_t>(percent, 1), 100); // ограничиваем 1..100 %
+}
+
+void AirtimePacer::setWindow(uint32_t window_ms) { window_ms_ = window_ms; }
+
+void AirtimePacer::onTransmit(Clock::time_point start, uint32_t airtime_us) {
+  last_start_ = start;
+  last_airtime_us_ = airtime_us;
+  prune(start);
+  if (history_.size() >= MAX_HISTORY) history_.pop_front(); // самые старые записи теряются
+  history_.push_back(Entry{start, airtime_us});
+}
+
+uint32_t AirtimePacer::gapAfterLastMs() const {
+  if (last_airtime_us_ == 0) return 0;
+  // Пауза выключенного передатчика, сохраняющая долю эфира: Toff = Ton * (100 - d) / d
+  const uint64_t off_us = static_cast<uint64_t>(last_airtime_us_) * (100U - duty_percent_) / duty_percent_;
+  const uint64_t idle_us = std::max<uint64_t>(off_us, static_cast<uint64_t>(turnaround_ms_) * 1000U);
+  return static_cast<uint32_t>((last_airtime_us_ + idle_us + 999U) / 1000U);
+}
+
+AirtimePacer::Clock::time_point AirtimePacer::nextAllowed() const {
+  return last_start_ + std::chrono::milliseconds(gapAfterLastMs());
+}
+
+uint32_t AirtimePacer::budgetMs() const {
+  return static_cast<uint32_t>(static_cast<uint64_t>(window_ms_) * duty_percent_ / 100U);
+}
+
+uint32_t AirtimePacer::remainingBudgetMs(Clock::time_point now) const {
+  const auto window_start = now - std::chrono::milliseconds(window_ms_);
+  uint64_t used_us = 0;
+  for (const auto& entry : history_) {
+    if (entry.start >= window_start) used_us += entry.airtime_us;
+  }
+  const uint64_t budget_us = static_cast<uint64_t>(budgetMs()) * 1000U;
+  return used_us >= budget_us ? 0 : static_cast<uint32_t>((budget_us - used_us) / 1000U);
+}
+
+void AirtimePacer::reset() {
+  history_.clear();
+  last_airtime_us_ = 0;
+  last_start_ = Clock::time_point{};
+}
+
+void AirtimePacer::prune(Clock::time_point now) {
+  const auto window_start = now - std::chrono::milliseconds(window_ms_);
+  while (!history_.empty() && history_.front().start < window_start) {
+    history_.pop_front();
+  }
+}
@@ -0,0 +1,57 @@
+#ifndef LIBS_AIRTIME_AIRTIME_PACER_H
+#define LIBS_AIRTIME_AIRTIME_PACER_H
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+// Планировщик интервалов между кадрами по фактическому времени в эфире.
+// После каждого кадра выдерживается разворот RX/TX и пауза, при которой доля
+// занятого эфира не превышает заданный duty cycle. Скользящее окно хранит
+// историю передач для отчёта об оставшемся бюджете.
+class AirtimePacer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  AirtimePacer(uint32_t turnaround_ms, uint8_t duty_percent, uint32_t window_ms);
+  // Время разворота на приём после передачи (мс)
+  void setTurnaround(uint32_t turnaround_ms);
+  uint32_t turnaround() const { return turnaround_ms_; }
+  // Допустимая доля эфира в процентах (1..100)
+  void setDutyCycle(uint8_t percent);
+  uint8_t dutyCycle() const { return duty_percent_; }
+  // Длина скользящего окна учёта бюджета (мс)
+  void setWindow(uint32_t window_ms);
+  uint32_t window() const { return window_ms_; }
+  // Регистрация кадра: момент начала передачи и время в эфире
+  void onTransmit(Clock::time_point start, uint32_t airtime_us);
+  // Пауза от начала последнего кадра до следующего разрешённого (мс)
+  uint32_t gapAfterLastMs() const;
+  // Момент, раньше которого следующий кадр отправлять нельзя
+  Clock::time_point nextAllowed() const;
+  // Время в эфире последнего кадра (мкс)
+  uint32_t lastAirtimeUs() const { return last_airtime_us_; }
+  // Полный бюджет эфира на окно (мс)
+  uint32_t budgetMs() const;
+  // Остаток бюджета в окне, заканчивающемся в момент now (мс)
+  uint32_t remainingBudgetMs(Clock::time_point now) const;
+  // Сброс истории передач
+  void reset();
+
+private:
+  struct Entry {
+    Clock::time_point start;                   // начало передачи
+    uint32_t airtime_us = 0;                   // длительность в эфире
+  };
+  void prune(Clock::time_point now);
+
+  static constexpr size_t MAX_HISTORY = 128;   // ограничение памяти истории
+  uint32_t turnaround_ms_ = 0;
+  uint8_t duty_percent_ = 100;
+  uint32_t window_ms_ = 0;
+  std::deque<Entry> history_;
+  Clock::time_point last_start_{};
+  uint32_t last_airtime_us_ = 0;
+};
+
+#endif // LIBS_AIRTIME_AIRTIME_PACER_H
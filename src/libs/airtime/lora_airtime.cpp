@@ -0,0 +1,86 @@
+#include "lora_airtime.h"
+
+namespace lora_airtime {
+
+bool autoLowDataRateOptimize(float bandwidthKhz, uint8_t spreadingFactor) {
+  return symbolTimeUs(bandwidthKhz, spreadingFactor) >= 16000U;
+}
+
+uint32_t symbolTimeUs(float bandwidthKhz, uint8_t spreadingFactor) {
+  if (bandwidthKhz <= 0.0f || spreadingFactor < 5 || spreadingFactor > 12) return 0;
+  const double chips = static_cast<double>(1UL << spreadingFactor);
+  return static_cast<uint32_t>(chips * 1000.0 / static_cast<double>(bandwidthKhz) + 0.5);
+}
+
+uint32_t timeOnAirUs(const ModemParams& params, size_t payloadLen) {
+  const uint8_t sf = params.spreadingFactor;
+  if (params.bandwidthKhz <= 0.0f || sf < 5 || sf > 12) return 0;
+  if (params.codingRateDenom < 5 || params.codingRateDenom > 8) return 0;
+
+  const bool ldro = params.lowDataRateOptimize && sf >= 7;   // для SF5/SF6 LDRO не применяется
+  const bool shortSf = sf < 7;                                 // у SF5/SF6 иная длина синхронизации
+  // Числитель формулы в битах: полезная нагрузка, CRC, заголовок и служебные поля
+  long bits = 8L * static_cast<long>(payloadLen) - 4L * sf;
+  if (params.crc) bits += 16;
+  if (!params.implicitHeader) bits += 20;
+  if (!shortSf) bits += 8;
+  if (bits < 0) bits = 0;
+  const long bitsPerBlock = 4L * (ldro ? sf - 2 : sf);
+  const long blocks = (bits + bitsPerBlock - 1) / bitsPerBlock;
+  const long payloadSymbols = 8 + blocks * params.codingRateDenom;
+
+  // Преамбула + синхрослово: 4.25 символа для SF7..12 и 6.25 для SF5/SF6 (в четвертях символа)
+  const long quarterSymbols = 4L * (static_cast<long>(params.preambleLength) + payloadSymbols) +
+                              (shortSf ? 25 : 17);
+  const double chips = static_cast<double>(1UL << sf);
+  const double us = static_cast<double>(quarterSymbols) * chips * 1000.0 /
+                    (4.0 * static_cast<double>(params.bandwidthKhz));
+  return static_cast<uint32_t>(us + 0.5);
+}
+
+uint32_t frameTimeOnAirUs(const ModemParams& params, size_t frameLen,
+                          size_t implicitLength, size_t maxPacket, size_t packetOverhead) {
+  if (frameLen == 0 || maxPacket == 0) return 0;
+  const size_t capacity = params.implicitHeader ? implicitLength : maxPacket;
+  if (capacity <= packetOverhead || capacity > maxPacket) return 0;
+  const size_t payload = capacity - packetOverhead;        // данные одного пакета
+  const size_t fullPackets = frameLen / payload;
+  const size_t tail = frameLen % payload;
+  uint32_t total = static_cast<uint32_t>(fullPackets) * timeOnAirUs(params, capacity);
+  if (tail) {
+    total += timeOnAirUs(params, params.implicitHeader ? capacity : tail + packetOverhead);
+  }
+  return total;
+}
+
+HeaderChoice chooseHeaderMode(ModemParams params,
+                              const uint16_t* frameLengths, size_t frameCount,
+                              const uint16_t* implicitLengths, size_t implicitCount,
+                              size_t maxPacket, size_t packetOverhead) {
+  // Суммарное время эталонных кадров для заданного режима
+  auto cost = [&](bool implicit, size_t implicitLength) -> uint64_t {
+    params.implicitHeader = implicit;
+    uint64_t total = 0;
+    for (size_t i = 0; i < frameCount; ++i) {
+      total += frameTimeOnAirUs(params, frameLengths[i], implicitLength, maxPacket, packetOverhead);
+    }
+    return total;
+  };
+
+  HeaderChoice best;
+  best.airtimeUs = cost(false, 0);
+  for (size_t i = 0; implicitLengths && i < implicitCount; ++i) {
+    const size_t len = implicitLengths[i];
+    if (len <= packetOverhead || len > maxPacket) continue; // длина вне возможностей радио
+    const uint64_t us = cost(true, len);
+    if (us < best.airtimeUs ||
+        (us == best.airtimeUs && best.implicitHeader && len < best.implicitLength)) {
+      best.implicitHeader = true;
+      best.implicitLength = static_cast<uint16_t>(len);
+      best.airtimeUs = us;
+    }
+  }
+  return best;
+}
+
+} // namespace lora_airtime
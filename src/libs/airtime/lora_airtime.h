@@ -0,0 +1,53 @@
+#ifndef LIBS_AIRTIME_LORA_AIRTIME_H
+#define LIBS_AIRTIME_LORA_AIRTIME_H
+#include <cstddef>
+#include <cstdint>
+
+namespace lora_airtime {
+
+// Параметры модема SX1262, влияющие на длительность кадра в эфире
+struct ModemParams {
+  float bandwidthKhz = 125.0f;       // ширина полосы (кГц)
+  uint8_t spreadingFactor = 7;       // фактор расширения SF (5..12)
+  uint8_t codingRateDenom = 5;       // делитель CR (5..8 для 4/5..4/8)
+  uint16_t preambleLength = 8;       // длина преамбулы (символы)
+  bool implicitHeader = false;       // режим фиксированной длины без заголовка PHY
+  bool crc = true;                   // аппаратный CRC в конце пакета
+  bool lowDataRateOptimize = false;  // LDRO для длинных символов
+};
+
+// Включает ли RadioLib LDRO автоматически (длительность символа не меньше 16 мс)
+bool autoLowDataRateOptimize(float bandwidthKhz, uint8_t spreadingFactor);
+
+// Длительность одного символа LoRa в микросекундах
+uint32_t symbolTimeUs(float bandwidthKhz, uint8_t spreadingFactor);
+
+// Время в эфире одного пакета длиной payloadLen байт по формуле из datasheet SX1261/2 (раздел 6.1.4).
+// Возвращает 0 при некорректных параметрах модема.
+uint32_t timeOnAirUs(const ModemParams& params, size_t payloadLen);
+
+// Время в эфире кадра frameLen байт, нарезанного на пакеты: в explicit-режиме пакеты не длиннее
+// maxPacket, в implicit-режиме каждый пакет имеет длину implicitLength (последний дополняется нулями).
+// packetOverhead — служебные байты в каждом пакете. Режим заголовка берётся из params.implicitHeader.
+uint32_t frameTimeOnAirUs(const ModemParams& params, size_t frameLen,
+                          size_t implicitLength, size_t maxPacket, size_t packetOverhead = 0);
+
+// Результат выбора режима заголовка PHY
+struct HeaderChoice {
+  bool implicitHeader = false;       // true — фиксированная длина без заголовка
+  uint16_t implicitLength = 0;       // длина пакета в implicit-режиме
+  uint64_t airtimeUs = 0;            // суммарное время эталонных кадров в эфире
+};
+
+// Выбирает explicit-заголовок или длину implicit-режима из таблицы implicitLengths так, чтобы
+// суммарное время в эфире эталонных кадров frameLengths было минимальным. Выбор детерминирован
+// (при равенстве предпочитается explicit, затем меньшая длина), поэтому обе стороны с одинаковыми
+// SF/BW/CR и преамбулой приходят к одному режиму.
+HeaderChoice chooseHeaderMode(ModemParams params,
+                              const uint16_t* frameLengths, size_t frameCount,
+                              const uint16_t* implicitLengths, size_t implicitCount,
+                              size_t maxPacket, size_t packetOverhead = 0);
+
+} // namespace lora_airtime
+
+#endif // LIBS_AIRTIME_LORA_AIRTIME_H
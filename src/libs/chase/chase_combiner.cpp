@@ -0,0 +1,123 @@
+#include "chase_combiner.h"
+#include <algorithm>
+
+namespace chase {
+
+namespace {
+// Сложение с насыщением: накопитель не переполняется при длинной серии повторов
+inline int8_t saturatingAdd(int8_t a, int v) {
+  return static_cast<int8_t>(std::max(-127, std::min(127, static_cast<int>(a) + v)));
+}
+} // namespace
+
+Cache::Cache(size_t slots, size_t max_len)
+    : slots_(slots), max_bits_(max_len * 8) {}
+
+const Cache::Slot* Cache::find(uint64_t key) const {
+  for (const auto& slot : slots_) {
+    if (slot.used && slot.key == key) return &slot;
+  }
+  return nullptr;
+}
+
+Cache::Slot* Cache::acquire(uint64_t key, size_t bits) {
+  if (bits == 0 || bits > max_bits_ || slots_.empty()) return nullptr;
+  Slot* target = nullptr;
+  for (auto& slot : slots_) {
+    if (slot.used && slot.key == key) {
+      target = &slot;
+      break;
+    }
+  }
+  if (!target) {
+    // Свободный слот, иначе самый давний
+    target = &slots_.front();
+    for (auto& slot : slots_) {
+      if (!slot.used) {
+        target = &slot;
+        break;
+      }
+      if (slot.stamp < target->stamp) target = &slot;
+    }
+    target->used = true;
+    target->key = key;
+    target->copies = 0;
+  }
+  if (target->copies == 0 || target->bits != bits) {
+    target->bits = bits;                       // другая длина — прежние копии к кадру не относятся
+    target->acc.assign(bits, 0);
+    target->copies = 0;
+  }
+  target->stamp = ++clock_;
+  return target;
+}
+
+uint8_t Cache::add(uint64_t key, const uint8_t* data, size_t len) {
+  if (!data) return 0;
+  Slot* slot = acquire(key, len * 8);
+  if (!slot) return 0;
+  for (size_t i = 0; i < slot->bits; ++i) {
+    const bool one = (data[i >> 3] >> (7 - (i & 7))) & 1;
+    slot->acc[i] = saturatingAdd(slot->acc[i], one ? HARD_WEIGHT : -HARD_WEIGHT);
+  }
+  if (slot->copies < UINT8_MAX) ++slot->copies;
+  return slot->copies;
+}
+
+uint8_t Cache::addSoft(uint64_t key, const int8_t* llr, size_t bits) {
+  if (!llr) return 0;
+  Slot* slot = acquire(key, bits);
+  if (!slot) return 0;
+  for (size_t i = 0; i < bits; ++i) {
+    slot->acc[i] = saturatingAdd(slot->acc[i], llr[i]);
+  }
+  if (slot->copies < UINT8_MAX) ++slot->copies;
+  return slot->copies;
+}
+
+bool Cache::combine(uint64_t key, std::vector<uint8_t>& out, std::vector<uint8_t>& erased) const {
+  const Slot* slot = find(key);
+  if (!slot || slot->copies == 0) return false;
+  const size_t len = (slot->bits + 7) / 8;
+  out.assign(len, 0);
+  erased.assign(len, 0);
+  for (size_t i = 0; i < slot->bits; ++i) {
+    const uint8_t mask = static_cast<uint8_t>(1U << (7 - (i & 7)));
+    if (slot->acc[i] > 0) {
+      out[i >> 3] |= mask;
+    } else if (slot->acc[i] == 0) {
+      erased[i >> 3] |= mask;                  // копии разошлись поровну
+    }
+  }
+  return true;
+}
+
+uint8_t Cache::copies(uint64_t key) const {
+  const Slot* slot = find(key);
+  return slot ? slot->copies : 0;
+}
+
+void Cache::release(uint64_t key) {
+  for (auto& slot : slots_) {
+    if (slot.used && slot.key == key) {
+      slot.used = false;
+      slot.copies = 0;
+      slot.acc.clear();
+    }
+  }
+}
+
+void Cache::clear() {
+  for (auto& slot : slots_) {
+    slot.used = false;
+    slot.copies = 0;
+    slot.acc.clear();
+  }
+}
+
+size_t Cache::size() const {
+  return static_cast<size_t>(std::count_if(slots_.begin(), slots_.end(),
+                                           [](const Slot& slot) { return slot.used; }));
+}
+
+} // namespace chase
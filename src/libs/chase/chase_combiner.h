@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "default_settings.h"
+
+// Chase-комбинирование повторных копий кадра. Копии одного фрагмента, пришедшие повторами
+// по ACK, складываются побитно: жёсткое решение даёт ±HARD_WEIGHT, мягкое — собственный LLR.
+// Знак суммы — мажоритарное решение, нулевая сумма (копии разошлись поровну) — стирание,
+// которое декодер Витерби не учитывает в метрике. Кэш ограничен числом слотов и длиной кадра,
+// при нехватке места вытесняется давно не обновлявшийся слот.
+namespace chase {
+
+constexpr int8_t HARD_WEIGHT = 16;  // вес одной жёсткой копии в накопителе
+
+class Cache {
+public:
+  explicit Cache(size_t slots = DefaultSettings::CHASE_CACHE_SLOTS,
+                 size_t max_len = DefaultSettings::CHASE_MAX_FRAME_LEN);
+
+  // Добавить копию с жёсткими решениями; возвращает число копий в накопителе (0 — не принята)
+  uint8_t add(uint64_t key, const uint8_t* data, size_t len);
+  // Добавить копию с мягкими решениями: по LLR на бит, > 0 — единица
+  uint8_t addSoft(uint64_t key, const int8_t* llr, size_t bits);
+  // Совмещённый кадр и маска стёртых бит той же длины; false — копий нет
+  bool combine(uint64_t key, std::vector<uint8_t>& out, std::vector<uint8_t>& erased) const;
+  // Число накопленных копий фрагмента
+  uint8_t copies(uint64_t key) const;
+  // Фрагмент декодирован — накопитель больше не нужен
+  void release(uint64_t key);
+  void clear();
+  size_t size() const;
+  size_t capacity() const { return slots_.size(); }
+
+private:
+  struct Slot {
+    bool used = false;
+    uint64_t key = 0;
+    size_t bits = 0;              // длина кадра в битах
+    std::vector<int8_t> acc;      // сумма решений по каждому биту
+    uint8_t copies = 0;
+    uint32_t stamp = 0;           // порядковый номер последнего обновления (LRU)
+  };
+
+  const Slot* find(uint64_t key) const;
+  Slot* acquire(uint64_t key, size_t bits);
+
+  std::vector<Slot> slots_;
+  size_t max_bits_ = 0;
+  uint32_t clock_ = 0;
+};
+
+} // namespace chase
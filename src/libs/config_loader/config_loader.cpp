@@ -10,6 +10,7 @@
 #endif
 
 #include "default_settings.h"        // значения по умолчанию и макросы логирования
+#include "libs/conv_codec/conv_codec.h" // разбор скорости свёртки
 
 namespace ConfigLoader {
 namespace {
@@ -151,6 +152,8 @@ Config makeDefaults() {
   config.radio.useRs = DefaultSettings::USE_RS;
   config.radio.useConv = DefaultSettings::USE_CONV;
   config.radio.useBitInterleaver = DefaultSettings::USE_BIT_INTERLEAVER;
+  config.radio.convRate = DefaultSettings::CONV_RATE;
+  config.radio.frameInterleave = DefaultSettings::FRAME_INTERLEAVE;
 
   config.keys.defaultKey = DefaultSettings::DEFAULT_KEY;
   return config;
@@ -287,6 +290,20 @@ void applySetting(Config& config, const std::string& section, const std::string&
       } else {
         LOG_WARN("Config: некорректный useBitInterleaver=%s", value.c_str());
       }
+    } else if (key == "convRate") {
+      conv_codec::Rate parsed = conv_codec::Rate::R1_2;
+      if (conv_codec::parseRate(value.c_str(), parsed)) {
+        config.radio.convRate = static_cast<uint8_t>(parsed);
+      } else {
+        LOG_WARN("Config: некорректный convRate=%s", value.c_str());
+      }
+    } else if (key == "frameInterleave") {
+      unsigned long parsed = 0;
+      if (parseUint(value, 8UL, parsed) && parsed >= 1) {
+        config.radio.frameInterleave = static_cast<uint8_t>(parsed);
+      } else {
+        LOG_WARN("Config: некорректный frameInterleave=%s", value.c_str());
+      }
     } else {
       LOG_WARN("Config: неизвестный параметр %s в секции [radio]", key.c_str());
     }
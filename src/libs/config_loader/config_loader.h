@@ -36,6 +36,8 @@ struct RadioConfig {
   bool useRs;              // включить код Рида-Соломона
   bool useConv;            // включить свёрточное кодирование
   bool useBitInterleaver;  // включить битовый интерливинг
+  uint8_t convRate;        // индекс скорости свёртки conv_codec::Rate
+  uint8_t frameInterleave; // глубина межкадрового интерливинга (1 — выкл.)
 };
 
 // Ключи шифрования по умолчанию
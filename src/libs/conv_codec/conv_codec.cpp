@@ -1,16 +1,105 @@
 #include "conv_codec.h"
 #include "../viterbi/viterbi.h"
+#include <cstring>
 
 namespace conv_codec {
+namespace {
+// Шаблоны прокалывания X1 Y1 X2 Y2 ... (1 — бит передаётся)
+constexpr uint8_t PUNCT_2_3[] = {1, 1, 0, 1};                    // X: 10,    Y: 11
+constexpr uint8_t PUNCT_3_4[] = {1, 1, 0, 1, 1, 0};              // X: 101,   Y: 110
+constexpr uint8_t PUNCT_5_6[] = {1, 1, 0, 1, 1, 0, 0, 1, 1, 0};  // X: 10101, Y: 11010
+
+struct Pattern {
+  const uint8_t* mask;
+  size_t period;
+};
+
+Pattern pattern(Rate rate) {
+  switch (rate) {
+    case Rate::R2_3: return {PUNCT_2_3, sizeof(PUNCT_2_3) / 2};
+    case Rate::R3_4: return {PUNCT_3_4, sizeof(PUNCT_3_4) / 2};
+    case Rate::R5_6: return {PUNCT_5_6, sizeof(PUNCT_5_6) / 2};
+    case Rate::R1_2:
+    default: return {nullptr, 0};
+  }
+}
+} // namespace
+
 // Простейшая обёртка над существующей реализацией
-void encodeBits(const uint8_t* data, size_t len, std::vector<uint8_t>& out) {
+void encodeBits(const uint8_t* data, size_t len, std::vector<uint8_t>& out, Rate rate) {
   if (!data || len == 0) return; // проверка входа
-  vit::encode(data, len, out);
+  const Pattern p = pattern(rate);
+  if (!p.mask) {
+    vit::encode(data, len, out);
+    return;
+  }
+  vit::encodePunctured(data, len, p.mask, p.period, out);
 }
 
 // Декодер Витерби для жёстких решений
-bool viterbiDecode(const uint8_t* data, size_t len, std::vector<uint8_t>& out) {
+bool viterbiDecode(const uint8_t* data, size_t len, std::vector<uint8_t>& out, Rate rate) {
   if (!data || len == 0) return false; // проверка входа
-  return vit::decode(data, len, out);
+  const Pattern p = pattern(rate);
+  if (!p.mask) {
+    return vit::decode(data, len, out);
+  }
+  const size_t out_len = maxInputSize(len, rate);
+  if (out_len == 0 || encodedSize(out_len, rate) != len) return false; // длина не соответствует скорости
+  return vit::decodePunctured(data, len, out_len, p.mask, p.period, out);
+}
+
+bool viterbiDecodeErasures(const uint8_t* data, const uint8_t* erased, size_t len, std::vector<uint8_t>& out,
+                           Rate rate) {
+  if (!erased) return viterbiDecode(data, len, out, rate);
+  if (!data || len == 0) return false;
+  const Pattern p = pattern(rate);
+  const size_t out_len = maxInputSize(len, rate);
+  if (out_len == 0 || encodedSize(out_len, rate) != len) return false;
+  // Раскладываем принятые биты по позициям X/Y материнского кода; выколотые и стёртые не учитываются
+  const size_t steps = out_len * 8;
+  std::vector<uint8_t> bits(steps * 2, 0);
+  std::vector<uint8_t> valid(steps * 2, 0);
+  size_t pos = 0;
+  for (size_t i = 0; i < steps * 2; ++i) {
+    if (p.mask && !p.mask[i % (p.period * 2)]) continue;
+    const uint8_t shift = static_cast<uint8_t>(7 - (pos & 7));
+    bits[i] = (data[pos >> 3] >> shift) & 1;
+    valid[i] = ((erased[pos >> 3] >> shift) & 1) ? 0 : 1;
+    ++pos;
+  }
+  return vit::decodeErasures(bits.data(), valid.data(), steps, out);
+}
+
+size_t encodedSize(size_t len, Rate rate) {
+  const Pattern p = pattern(rate);
+  return (vit::puncturedBits(len * 8, p.mask, p.period) + 7) / 8;
+}
+
+size_t maxInputSize(size_t capacity, Rate rate) {
+  size_t len = capacity;                   // код не сжимает данные, поэтому вход не длиннее выхода
+  while (len > 0 && encodedSize(len, rate) > capacity) --len;
+  return len;
+}
+
+const char* rateName(Rate rate) {
+  switch (rate) {
+    case Rate::R2_3: return "2/3";
+    case Rate::R3_4: return "3/4";
+    case Rate::R5_6: return "5/6";
+    case Rate::R1_2:
+    default: return "1/2";
+  }
+}
+
+bool parseRate(const char* text, Rate& rate) {
+  if (!text) return false;
+  for (uint8_t i = 0; i < RATE_COUNT; ++i) {
+    const Rate candidate = static_cast<Rate>(i);
+    if (std::strcmp(text, rateName(candidate)) == 0) {
+      rate = candidate;
+      return true;
+    }
+  }
+  return false;
 }
 } // namespace conv_codec
@@ -5,8 +5,28 @@
 
 // Обёртки для свёрточного кодера и декодера Витерби
 namespace conv_codec {
+// Скорость кода: базовая 1/2 и стандартные проколотые варианты для K=7 171/133
+enum class Rate : uint8_t {
+  R1_2 = 0,
+  R2_3 = 1,
+  R3_4 = 2,
+  R5_6 = 3,
+};
+constexpr uint8_t RATE_COUNT = 4;
+
 // Кодирование бит (байты трактуются как последовательность бит)
-void encodeBits(const uint8_t* data, size_t len, std::vector<uint8_t>& out);
-// Декодирование алгоритмом Витерби (жёсткие решения)
-bool viterbiDecode(const uint8_t* data, size_t len, std::vector<uint8_t>& out);
+void encodeBits(const uint8_t* data, size_t len, std::vector<uint8_t>& out, Rate rate = Rate::R1_2);
+// Декодирование алгоритмом Витерби (жёсткие решения); для проколотых скоростей
+// длина исходных данных выводится из размера входа
+bool viterbiDecode(const uint8_t* data, size_t len, std::vector<uint8_t>& out, Rate rate = Rate::R1_2);
+// То же с маской ненадёжных бит той же длины (1 — бит стёрт и не влияет на метрику)
+bool viterbiDecodeErasures(const uint8_t* data, const uint8_t* erased, size_t len, std::vector<uint8_t>& out,
+                           Rate rate = Rate::R1_2);
+// Размер закодированного блока для len байт входа
+size_t encodedSize(size_t len, Rate rate);
+// Наибольший вход, закодированный размер которого не превышает capacity
+size_t maxInputSize(size_t capacity, Rate rate);
+// Обозначение скорости вида "3/4" и обратный разбор
+const char* rateName(Rate rate);
+bool parseRate(const char* text, Rate& rate);
 }
@@ -0,0 +1,212 @@
+#include "erasure_code.h"
+#include <algorithm>
+
+namespace erasure {
+
+namespace {
+// Таблицы GF(256) с порождающим многочленом x^8 + x^4 + x^3 + x^2 + 1
+struct GfTables {
+  uint8_t exp[512];
+  uint8_t log[256];
+  GfTables() {
+    uint16_t x = 1;
+    for (int i = 0; i < 255; ++i) {
+      exp[i] = static_cast<uint8_t>(x);
+      log[x] = static_cast<uint8_t>(i);
+      x <<= 1;
+      if (x & 0x100) x ^= 0x11D;
+    }
+    for (int i = 255; i < 512; ++i) exp[i] = exp[i - 255];
+    log[0] = 0;
+  }
+};
+
+const GfTables& gf() {
+  static const GfTables tables;
+  return tables;
+}
+
+inline uint8_t gfMul(uint8_t a, uint8_t b) {
+  if (a == 0 || b == 0) return 0;
+  return gf().exp[gf().log[a] + gf().log[b]];
+}
+
+inline uint8_t gfInv(uint8_t a) {
+  return gf().exp[255 - gf().log[a]];
+}
+
+// Элемент матрицы Коши: строка восстановительного фрагмента j, столбец исходной части i
+inline uint8_t cauchy(size_t k, size_t j, size_t i) {
+  return gfInv(static_cast<uint8_t>((k + j) ^ i));
+}
+
+// dst ^= c * src
+void mulAdd(uint8_t* dst, const uint8_t* src, size_t len, uint8_t c) {
+  if (c == 0) return;
+  if (c == 1) {
+    for (size_t n = 0; n < len; ++n) dst[n] ^= src[n];
+    return;
+  }
+  const uint8_t lc = gf().log[c];
+  for (size_t n = 0; n < len; ++n) {
+    if (src[n]) dst[n] ^= gf().exp[gf().log[src[n]] + lc];
+  }
+}
+
+// Общее кодирование: part(i, len) отдаёт i-ю исходную часть без копирования
+template <typename PartFn>
+bool encodeRepair(size_t k, size_t symbol_len, size_t total, size_t repair,
+                  std::vector<std::vector<uint8_t>>& out, PartFn&& part) {
+  if (k == 0 || repair == 0 || k + repair > MAX_FRAGMENTS) return false;
+  if (symbol_len == 0 || total > 0xFFFF) return false;
+  out.assign(repair, std::vector<uint8_t>(LEN_PREFIX + symbol_len, 0));
+  for (size_t j = 0; j < repair; ++j) {
+    auto& sym = out[j];
+    sym[0] = static_cast<uint8_t>(total & 0xFF);
+    sym[1] = static_cast<uint8_t>(total >> 8);
+    for (size_t i = 0; i < k; ++i) {
+      size_t len = 0;
+      const uint8_t* src = part(i, len);
+      mulAdd(sym.data() + LEN_PREFIX, src, len, cauchy(k, j, i));
+    }
+  }
+  return true;
+}
+} // namespace
+
+size_t repairCount(size_t k, uint8_t percent) {
+  if (k == 0 || percent == 0) return 0;
+  size_t r = (k * percent + 99) / 100;
+  if (k + r > MAX_FRAGMENTS) r = k < MAX_FRAGMENTS ? MAX_FRAGMENTS - k : 0;
+  return r;
+}
+
+bool buildRepair(const std::vector<std::vector<uint8_t>>& parts, size_t repair,
+                 std::vector<std::vector<uint8_t>>& out) {
+  out.clear();
+  const size_t k = parts.size();
+  if (k == 0) return false;
+  const size_t symbol_len = parts.front().size();
+  size_t total = 0;
+  for (const auto& part : parts) {
+    if (part.size() > symbol_len) return false;    // частью короче символа может быть только последняя
+    total += part.size();
+  }
+  return encodeRepair(k, symbol_len, total, repair, out,
+                      [&](size_t i, size_t& len) { len = parts[i].size(); return parts[i].data(); });
+}
+
+bool buildRepair(const uint8_t* data, size_t len, size_t chunk, size_t repair,
+                 std::vector<std::vector<uint8_t>>& out) {
+  out.clear();
+  if (!data || len == 0 || chunk == 0) return false;
+  const size_t k = (len + chunk - 1) / chunk;
+  return encodeRepair(k, std::min(chunk, len), len, repair, out, [&](size_t i, size_t& part_len) {
+    part_len = std::min(chunk, len - i * chunk);
+    return data + i * chunk;
+  });
+}
+
+void Decoder::reset(uint16_t k) {
+  k_ = k <= MAX_FRAGMENTS ? k : 0;
+  received_ = 0;
+  symbol_len_ = 0;
+  total_len_ = 0;
+  total_known_ = false;
+  sources_.assign(k_, {});
+  has_source_.assign(k_, 0);
+  repairs_.clear();
+  repair_idx_.clear();
+}
+
+bool Decoder::add(uint16_t idx, const uint8_t* data, size_t len) {
+  if (k_ == 0 || !data || len == 0 || idx >= MAX_FRAGMENTS) return false;
+  if (idx < k_) {
+    if (has_source_[idx]) return false;            // повтор уже принятой части
+    if (idx + 1 < k_) {
+      if (symbol_len_ && len != symbol_len_) return false;
+      symbol_len_ = len;                           // все части, кроме последней, равны символу
+    } else if (symbol_len_ && len > symbol_len_) {
+      return false;
+    }
+    sources_[idx].assign(data, data + len);
+    has_source_[idx] = 1;
+  } else {
+    if (len <= LEN_PREFIX) return false;
+    const uint16_t j = static_cast<uint16_t>(idx - k_);
+    if (std::find(repair_idx_.begin(), repair_idx_.end(), j) != repair_idx_.end()) return false;
+    const size_t sym_len = len - LEN_PREFIX;
+    if (symbol_len_ && sym_len != symbol_len_) return false;
+    const size_t total = static_cast<size_t>(data[0]) | (static_cast<size_t>(data[1]) << 8);
+    if (total_known_ && total != total_len_) return false;
+    symbol_len_ = sym_len;
+    total_len_ = total;
+    total_known_ = true;
+    repairs_.emplace_back(data + LEN_PREFIX, data + len);
+    repair_idx_.push_back(j);
+  }
+  ++received_;
+  return true;
+}
+
+bool Decoder::decode(std::vector<uint8_t>& message) const {
+  if (!complete()) return false;
+  std::vector<size_t> missing;
+  for (size_t i = 0; i < k_; ++i) {
+    if (!has_source_[i]) missing.push_back(i);
+  }
+  message.clear();
+  if (missing.empty()) {
+    for (const auto& part : sources_) message.insert(message.end(), part.begin(), part.end());
+    return true;
+  }
+  if (!total_known_ || repairs_.size() < missing.size() || symbol_len_ == 0) return false;
+  const size_t m = missing.size();
+  const size_t s = symbol_len_;
+
+  // Правая часть: восстановительный символ за вычетом вклада принятых исходных частей
+  std::vector<std::vector<uint8_t>> rhs(m);
+  std::vector<std::vector<uint8_t>> mat(m, std::vector<uint8_t>(m, 0));
+  for (size_t r = 0; r < m; ++r) {
+    const size_t j = repair_idx_[r];
+    rhs[r] = repairs_[r];
+    for (size_t i = 0; i < k_; ++i) {
+      if (has_source_[i]) mulAdd(rhs[r].data(), sources_[i].data(), sources_[i].size(), cauchy(k_, j, i));
+    }
+    for (size_t c = 0; c < m; ++c) mat[r][c] = cauchy(k_, j, missing[c]);
+  }
+
+  // Метод Гаусса — Жордана; любая квадратная подматрица Коши невырождена
+  for (size_t col = 0; col < m; ++col) {
+    size_t pivot = col;
+    while (pivot < m && mat[pivot][col] == 0) ++pivot;
+    if (pivot == m) return false;
+    std::swap(mat[pivot], mat[col]);
+    std::swap(rhs[pivot], rhs[col]);
+    const uint8_t inv = gfInv(mat[col][col]);
+    for (size_t c = 0; c < m; ++c) mat[col][c] = gfMul(mat[col][c], inv);
+    for (size_t n = 0; n < s; ++n) rhs[col][n] = gfMul(rhs[col][n], inv);
+    for (size_t r = 0; r < m; ++r) {
+      if (r == col || mat[r][col] == 0) continue;
+      const uint8_t f = mat[r][col];
+      for (size_t c = 0; c < m; ++c) mat[r][c] ^= gfMul(f, mat[col][c]);
+      mulAdd(rhs[r].data(), rhs[col].data(), s, f);
+    }
+  }
+
+  // Склейка: восстановленные части берутся из решения, последняя обрезается по длине сообщения
+  size_t next_missing = 0;
+  for (size_t i = 0; i < k_; ++i) {
+    if (has_source_[i]) {
+      message.insert(message.end(), sources_[i].begin(), sources_[i].end());
+    } else {
+      message.insert(message.end(), rhs[next_missing].begin(), rhs[next_missing].end());
+      ++next_missing;
+    }
+  }
+  if (message.size() < total_len_) return false;
+  message.resize(total_len_);
+  return true;
+}
+
+} // namespace erasure
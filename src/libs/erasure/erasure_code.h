@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Внешний код стираний поверх фрагментов сообщения: систематический код Рида — Соломона
+// над GF(256) с матрицей Коши. K исходных частей уходят как есть, к ним добавляются
+// R восстановительных; приёмник восстанавливает сообщение из любых K различных фрагментов.
+// Восстановительный фрагмент начинается с длины сообщения (LEN_PREFIX байт, little-endian),
+// за ней — символ длиной в первую исходную часть (последняя часть дополняется нулями).
+namespace erasure {
+
+constexpr size_t LEN_PREFIX = 2;          // префикс длины сообщения в восстановительном фрагменте
+constexpr size_t MAX_FRAGMENTS = 255;     // K + R: номера фрагментов — различные элементы GF(256)
+
+// Число восстановительных фрагментов для k исходных при избыточности percent %
+size_t repairCount(size_t k, uint8_t percent);
+// Восстановительные фрагменты для исходных частей сообщения
+bool buildRepair(const std::vector<std::vector<uint8_t>>& parts, size_t repair,
+                 std::vector<std::vector<uint8_t>>& out);
+// То же для сообщения, нарезанного подряд по chunk байт: части читаются прямо из data
+bool buildRepair(const uint8_t* data, size_t len, size_t chunk, size_t repair,
+                 std::vector<std::vector<uint8_t>>& out);
+
+// Сборка сообщения из любых k фрагментов
+class Decoder {
+public:
+  // Новое сообщение из k исходных частей
+  void reset(uint16_t k);
+  // Фрагмент idx: меньше k — исходная часть, иначе восстановительный. false — фрагмент отвергнут
+  bool add(uint16_t idx, const uint8_t* data, size_t len);
+  uint16_t sourceCount() const { return k_; }
+  size_t received() const { return received_; }
+  // Набрано достаточно фрагментов для восстановления
+  bool complete() const { return k_ != 0 && received_ >= k_; }
+  // Восстановленное сообщение; false — фрагментов пока мало
+  bool decode(std::vector<uint8_t>& message) const;
+
+private:
+  uint16_t k_ = 0;
+  size_t received_ = 0;
+  size_t symbol_len_ = 0;                 // длина символа (0 — ещё неизвестна)
+  size_t total_len_ = 0;                  // длина сообщения из восстановительного фрагмента
+  bool total_known_ = false;
+  std::vector<std::vector<uint8_t>> sources_;  // принятые исходные части по индексу
+  std::vector<uint8_t> has_source_;
+  std::vector<std::vector<uint8_t>> repairs_;  // принятые восстановительные символы
+  std::vector<uint16_t> repair_idx_;           // их номера (idx - k)
+};
+
+} // namespace erasure
@@ -2,6 +2,7 @@
 #include <cstddef>
 #include "default_settings.h"              // доступ к значениям по умолчанию
 #include "libs/config_loader/config_loader.h" // доступ к текущей конфигурации
+#include "libs/conv_codec/conv_codec.h"       // скорости свёрточного кода
 
 namespace fec {
 
@@ -10,6 +11,8 @@ struct Profile {
   bool use_rs = false;             // требуется ли код Рида — Соломона
   bool use_conv = false;           // активна ли свёртка
   bool use_bit_interleaver = false; // задействован ли битовый интерливинг
+  conv_codec::Rate conv_rate = conv_codec::Rate::R1_2; // скорость свёртки после прокалывания
+  uint8_t frame_interleave = 1;    // сколько соседних фрагментов перемежаются между кадрами
 };
 
 // Возвращает профиль кодирования на основании конфигурации
@@ -19,6 +22,9 @@ inline Profile currentProfile() {
   profile.use_rs = radio.useRs;
   profile.use_conv = radio.useConv;
   profile.use_bit_interleaver = radio.useBitInterleaver;
+  profile.conv_rate = radio.convRate < conv_codec::RATE_COUNT ? static_cast<conv_codec::Rate>(radio.convRate)
+                                                              : conv_codec::Rate::R1_2;
+  profile.frame_interleave = radio.frameInterleave;
   return profile;
 }
 
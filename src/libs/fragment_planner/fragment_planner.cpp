@@ -0,0 +1,37 @@
+#include "fragment_planner.h"
+#include <vector>
+
+namespace fragment_planner {
+
+bool plan(size_t total, size_t min_chunk, size_t max_chunk, uint32_t frame_overhead_us,
+          const CostFn& cost, Plan& out) {
+  out = Plan{};
+  if (total == 0 || max_chunk == 0 || !cost) return false;
+  if (min_chunk == 0) min_chunk = 1;
+  if (max_chunk > total) max_chunk = total;           // больше одной части не понадобится
+  if (min_chunk > max_chunk) min_chunk = max_chunk;
+  // Время кадра зависит только от длины части — считаем его один раз на длину
+  std::vector<uint32_t> frame_us(max_chunk + 1, 0);
+  for (size_t len = 1; len <= max_chunk; ++len) frame_us[len] = cost(len);
+
+  bool found = false;
+  for (size_t chunk = max_chunk; chunk >= min_chunk; --chunk) {
+    const size_t count = (total + chunk - 1) / chunk;
+    const size_t last = total - (count - 1) * chunk;
+    const uint64_t airtime = static_cast<uint64_t>(count - 1) * (frame_us[chunk] + frame_overhead_us) +
+                             frame_us[last] + frame_overhead_us;
+    // Перебор от больших частей: при равенстве остаётся меньшее число фрагментов
+    if (!found || airtime < out.airtime_us ||
+        (airtime == out.airtime_us && count < out.count)) {
+      out.chunk = chunk;
+      out.count = count;
+      out.last = last;
+      out.airtime_us = airtime;
+      found = true;
+    }
+    if (chunk == min_chunk) break;
+  }
+  return found;
+}
+
+} // namespace fragment_planner
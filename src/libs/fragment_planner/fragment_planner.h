@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Выбор размера фрагментов по времени в эфире. Время кадра растёт ступенями (символы LoRa,
+// пакеты implicit-режима, пилоты, удвоение свёрткой), поэтому «самый большой фрагмент»
+// не всегда выгоднее: перебираются все размеры части, последняя часть — остаток.
+namespace fragment_planner {
+
+// Время в эфире кадра с открытой частью len байт (мкс); 0 — время неизвестно
+using CostFn = std::function<uint32_t(size_t len)>;
+
+struct Plan {
+  size_t chunk = 0;          // размер всех частей, кроме последней
+  size_t count = 0;          // число фрагментов
+  size_t last = 0;           // размер последней части (не больше chunk)
+  uint64_t airtime_us = 0;   // суммарное время в эфире вместе с frame_overhead_us на кадр
+};
+
+// План для total байт частями от min_chunk до max_chunk. frame_overhead_us добавляется к
+// каждому кадру (разворот TX→RX, паузы). При равном времени выбирается меньше фрагментов,
+// затем больший размер части; без данных о времени — max_chunk, как при обычной нарезке
+bool plan(size_t total, size_t min_chunk, size_t max_chunk, uint32_t frame_overhead_us,
+          const CostFn& cost, Plan& out);
+
+} // namespace fragment_planner
@@ -0,0 +1,113 @@
+#include "delta_header.h"
+
+namespace delta_header {
+
+namespace {
+
+uint8_t crcByte(uint8_t crc, uint8_t b) {
+  crc ^= b;
+  for (int bit = 0; bit < 8; ++bit) {
+    crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+  }
+  return crc;
+}
+
+} // namespace
+
+bool isDelta(const uint8_t* data, size_t len) {
+  if (!data || len < DELTA_SHORT_SIZE) return false;
+  const uint8_t tag = data[0] & TAG_MASK;
+  return tag == DELTA_TAG || tag == DELTA_SAME_LEN_TAG;
+}
+
+bool canDelta(const FrameHeader& context, const FrameHeader& hdr) {
+  return context.ver == hdr.ver && context.msg_id == hdr.msg_id &&
+         context.frag_cnt == hdr.frag_cnt && context.getFlags() == hdr.getFlags() &&
+         context.interleave == hdr.interleave && hdr.getPayloadLen() <= 0xFF;
+}
+
+uint8_t crc8(const FrameHeader& hdr) {
+  const uint8_t bytes[] = {
+      hdr.ver,
+      static_cast<uint8_t>(hdr.msg_id >> 8), static_cast<uint8_t>(hdr.msg_id),
+      static_cast<uint8_t>(hdr.frag_cnt >> 8), static_cast<uint8_t>(hdr.frag_cnt),
+      static_cast<uint8_t>(hdr.packed >> 24), static_cast<uint8_t>(hdr.packed >> 16),
+      static_cast<uint8_t>(hdr.packed >> 8), static_cast<uint8_t>(hdr.packed),
+      hdr.interleave};
+  uint8_t crc = 0;
+  for (uint8_t b : bytes) crc = crcByte(crc, b);
+  return crc;
+}
+
+size_t encodeDelta(const FrameHeader& context, const FrameHeader& hdr, uint8_t* out, size_t out_len) {
+  if (!out || !canDelta(context, hdr)) return 0;
+  const bool same_len = hdr.getPayloadLen() == context.getPayloadLen();
+  const size_t size = same_len ? DELTA_SHORT_SIZE : DELTA_SIZE;
+  if (out_len < size) return 0;
+  /*
+   * Формат дельты:
+   * [0]   - тег (0xA0 — с длиной, 0xB0 — длина контекста) | номер контекста (msg_id & 0x0F)
+   * [1]   - младший байт индекса фрагмента, старшие биты берутся ближе к предыдущему индексу
+   * [2]   - длина полезной нагрузки (только для тега 0xA0)
+   * [n-1] - CRC-8 полного восстановленного заголовка
+   */
+  size_t pos = 0;
+  out[pos++] = static_cast<uint8_t>((same_len ? DELTA_SAME_LEN_TAG : DELTA_TAG) | (hdr.msg_id & CONTEXT_MASK));
+  out[pos++] = static_cast<uint8_t>(hdr.getFragIdx());
+  if (!same_len) out[pos++] = static_cast<uint8_t>(hdr.getPayloadLen());
+  out[pos++] = crc8(hdr);
+  return pos;
+}
+
+bool Decoder::parse(const uint8_t* data, size_t len, FrameHeader& out, size_t& header_len) {
+  if (!isDelta(data, len)) {
+    if (!FrameHeader::decode(data, len, out)) return false;
+    auto& ctx = contexts_[out.msg_id & CONTEXT_MASK];
+    ctx.valid = true;
+    ctx.hdr = out;
+    ctx.last_idx = out.getFragIdx();
+    header_len = len < FrameHeader::SIZE ? FrameHeader::MIN_SIZE : FrameHeader::SIZE;
+    return true;
+  }
+  const bool same_len = (data[0] & TAG_MASK) == DELTA_SAME_LEN_TAG;
+  const size_t size = same_len ? DELTA_SHORT_SIZE : DELTA_SIZE;
+  auto& ctx = contexts_[data[0] & CONTEXT_MASK];
+  if (len < size) return false;
+  if (!ctx.valid) {
+    ++lost_context_count_;
+    return false;
+  }
+  // Индекс: из кандидатов с данным младшим байтом выбираем ближайший к последнему
+  const uint16_t low = data[1];
+  const uint16_t limit = ctx.hdr.frag_cnt ? ctx.hdr.frag_cnt : 1;
+  uint16_t best = low;
+  uint16_t best_dist = 0xFFFF;
+  for (uint32_t cand = low; cand <= (FrameHeader::FRAG_MASK >> FrameHeader::FRAG_SHIFT); cand += 0x100) {
+    const uint16_t dist = static_cast<uint16_t>(cand > ctx.last_idx ? cand - ctx.last_idx : ctx.last_idx - cand);
+    if (dist < best_dist) {
+      best = static_cast<uint16_t>(cand);
+      best_dist = dist;
+    }
+    if (cand >= limit) break;                      // дальше индексов у сообщения нет (избыточность — сразу за ними)
+  }
+  FrameHeader hdr = ctx.hdr;
+  hdr.setFragIdx(best);
+  hdr.setPayloadLen(same_len ? ctx.hdr.getPayloadLen() : data[2]);
+  if (crc8(hdr) != data[size - 1]) {
+    ++lost_context_count_;                         // дельта от другого полного заголовка
+    return false;
+  }
+  ctx.last_idx = best;
+  out = hdr;
+  header_len = size;
+  ++delta_count_;
+  return true;
+}
+
+void Decoder::reset() {
+  contexts_ = {};
+  delta_count_ = 0;
+  lost_context_count_ = 0;
+}
+
+} // namespace delta_header
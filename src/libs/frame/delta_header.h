@@ -0,0 +1,60 @@
+#ifndef LIBS_FRAME_DELTA_HEADER_H
+#define LIBS_FRAME_DELTA_HEADER_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "frame_header.h"
+
+// Сжатые заголовки фрагментов. Полный заголовок (FrameHeader, 12 байт) задаёт контекст
+// сообщения: версию, msg_id, число фрагментов, флаги, глубину интерливинга и длину.
+// Следующие фрагменты того же сообщения несут только дельту: номер контекста, младший
+// байт индекса, длину (если она отличается от контекстной) и CRC-8 восстановленного
+// заголовка. Потеря кадра с контекстом обнаруживается по CRC, и фрагменты до следующего
+// полного заголовка отбрасываются, как потерянные.
+namespace delta_header {
+
+constexpr uint8_t TAG_MASK = 0xF0;
+constexpr uint8_t DELTA_TAG = 0xA0;            // дельта с явной длиной
+constexpr uint8_t DELTA_SAME_LEN_TAG = 0xB0;   // длина совпадает с контекстной
+constexpr uint8_t CONTEXT_MASK = 0x0F;         // номер контекста — младшие биты msg_id
+constexpr size_t DELTA_SIZE = 4;
+constexpr size_t DELTA_SHORT_SIZE = 3;
+constexpr size_t CONTEXT_COUNT = CONTEXT_MASK + 1;
+
+// Первый байт кадра — тег дельта-заголовка (версии полного заголовка не пересекаются с ним)
+bool isDelta(const uint8_t* data, size_t len);
+
+// Можно ли передать hdr дельтой относительно полного заголовка context
+bool canDelta(const FrameHeader& context, const FrameHeader& hdr);
+
+// Дельта-заголовок hdr относительно context; возвращает длину (3 или 4 байта), 0 — дельта невозможна
+size_t encodeDelta(const FrameHeader& context, const FrameHeader& hdr, uint8_t* out, size_t out_len);
+
+// CRC-8 (полином 0x07) восстановленного заголовка
+uint8_t crc8(const FrameHeader& hdr);
+
+// Приёмная сторона: хранит последний полный заголовок каждого контекста
+class Decoder {
+public:
+  // Разбор начала кадра. Полный заголовок обновляет контекст, дельта восстанавливает
+  // заголовок из него. false — кадр короче заголовка, контекста нет или CRC не совпала
+  bool parse(const uint8_t* data, size_t len, FrameHeader& out, size_t& header_len);
+  void reset();
+  uint32_t deltaCount() const { return delta_count_; }
+  uint32_t lostContextCount() const { return lost_context_count_; }
+
+private:
+  struct Context {
+    bool valid = false;
+    FrameHeader hdr;          // последний полный заголовок
+    uint16_t last_idx = 0;    // индекс последнего восстановленного фрагмента
+  };
+  std::array<Context, CONTEXT_COUNT> contexts_{};
+  uint32_t delta_count_ = 0;
+  uint32_t lost_context_count_ = 0;
+};
+
+} // namespace delta_header
+
+#endif // LIBS_FRAME_DELTA_HEADER_H
@@ -53,7 +53,8 @@ bool FrameHeader::encode(uint8_t* out, size_t out_len, const uint8_t* payload, s
    * [3-4] - количество фрагментов (uint16_t)
    * [5-8] - упакованное поле: биты [31:24] флаги, [23:12] индекс фрагмента,
    *         [11:0] длина полезной нагрузки
-   * [9-11] - зарезервировано (нули для выравнивания под AEAD-тег)
+   * [9]   - глубина межкадрового интерливинга (0 — кадр не перемежён)
+   * [10-11] - зарезервировано (нули для выравнивания под AEAD-тег)
    */
   out[0] = ver;
   out[1] = static_cast<uint8_t>(msg_id >> 8);
@@ -64,7 +65,7 @@ bool FrameHeader::encode(uint8_t* out, size_t out_len, const uint8_t* payload, s
   out[6] = static_cast<uint8_t>(packed_local >> 16);
   out[7] = static_cast<uint8_t>(packed_local >> 8);
   out[8] = static_cast<uint8_t>(packed_local);
-  out[9] = 0;
+  out[9] = interleave;
   out[10] = 0;
   out[11] = 0;
   return true;
@@ -85,5 +86,6 @@ bool FrameHeader::decode(const uint8_t* data, size_t len, FrameHeader& out) {
                (static_cast<uint32_t>(local_buf[6]) << 16) |
                (static_cast<uint32_t>(local_buf[7]) << 8) |
                static_cast<uint32_t>(local_buf[8]);
+  out.interleave = local_buf[9];              // в укороченном заголовке байта нет — 0
   return true;
 }
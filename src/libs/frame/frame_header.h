@@ -11,6 +11,7 @@ struct FrameHeader {
   uint16_t msg_id = 0;      // идентификатор сообщения
   uint16_t frag_cnt = 1;    // общее число фрагментов
   uint32_t packed = 0;      // упакованные флаги, номер фрагмента и длина
+  uint8_t interleave = 0;   // глубина межкадрового интерливинга группы (0 — нет), байт 9
 
   static constexpr size_t SIZE = 12;     // размер стандартного заголовка в байтах
   static constexpr size_t MIN_SIZE = 9;  // минимальный размер укороченного заголовка (без выравнивания)
@@ -24,6 +25,10 @@ struct FrameHeader {
   static constexpr uint8_t FLAG_CONV_ENCODED = 0x04;     // полезная нагрузка прошла свёрточное кодирование
   static constexpr uint8_t FLAG_RS_ENCODED = 0x08;       // к кадру применён код Рида — Соломона
   static constexpr uint8_t FLAG_BIT_INTERLEAVED = 0x10;  // к битам применён интерливинг
+  static constexpr uint8_t CONV_RATE_SHIFT = 5;          // биты 5–6 флагов: индекс проколотой скорости свёртки
+  static constexpr uint8_t CONV_RATE_MASK = 0x60;        // 0 — 1/2, совместимо с кадрами без прокалывания
+  static constexpr uint8_t FLAG_HARQ_REDUNDANCY = 0x80;  // кадр несёт дополнительную избыточность HARQ,
+                                                         // в битах 5–6 вместо скорости — номер версии (RV)
 
   // Доступ к упакованным полям
   uint8_t getFlags() const;        // извлечение флагов
@@ -0,0 +1,65 @@
+#include "frame_interleaver.h"
+#include <cstring>
+
+namespace frame_interleaver {
+
+bool interleave(uint8_t* const* frames, size_t depth, size_t len) {
+  if (!frames || depth < 2 || depth > MAX_DEPTH || len == 0) return false;
+  std::vector<uint8_t> column(depth);
+  for (size_t c = 0; c < len; ++c) {
+    for (size_t j = 0; j < depth; ++j) column[j] = frames[(j + c) % depth][c];
+    for (size_t j = 0; j < depth; ++j) frames[j][c] = column[j];
+  }
+  return true;
+}
+
+bool deinterleave(uint8_t* const* frames, size_t depth, size_t len) {
+  if (!frames || depth < 2 || depth > MAX_DEPTH || len == 0) return false;
+  std::vector<uint8_t> column(depth);
+  for (size_t c = 0; c < len; ++c) {
+    for (size_t j = 0; j < depth; ++j) column[(j + c) % depth] = frames[j][c];
+    for (size_t i = 0; i < depth; ++i) frames[i][c] = column[i];
+  }
+  return true;
+}
+
+bool Group::reset(uint8_t depth, size_t len) {
+  depth_ = 0;
+  received_ = 0;
+  mask_ = 0;
+  len_ = 0;
+  frames_.clear();
+  if (depth < 2 || depth > MAX_DEPTH || len == 0) return false;
+  depth_ = depth;
+  len_ = len;
+  frames_.assign(static_cast<size_t>(depth) * len, 0);
+  return true;
+}
+
+bool Group::add(uint8_t pos, const uint8_t* data, size_t len) {
+  if (!data || pos >= depth_ || len != len_) return false;
+  const uint8_t bit = static_cast<uint8_t>(1U << pos);
+  if (mask_ & bit) return false;
+  std::memcpy(frames_.data() + static_cast<size_t>(pos) * len_, data, len_);
+  mask_ |= bit;
+  ++received_;
+  return true;
+}
+
+bool Group::block(uint8_t i, std::vector<uint8_t>& out, std::vector<uint8_t>& erased) const {
+  if (i >= depth_ || received_ == 0) return false;
+  out.assign(len_, 0);
+  erased.assign(len_, 0);
+  for (size_t c = 0; c < len_; ++c) {
+    // Байт c блока i лежит в кадре j, для которого (j + c) mod depth == i
+    const size_t j = (i + depth_ - (c % depth_)) % depth_;
+    if (mask_ & (1U << j)) {
+      out[c] = frames_[j * len_ + c];
+    } else {
+      erased[c] = 0xFF;
+    }
+  }
+  return true;
+}
+
+} // namespace frame_interleaver
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Межкадровый интерливинг: закодированные блоки N соседних фрагментов сообщения
+// раскладываются по N кадрам диагональю. Кадр j несёт байты c блока (j + c) mod N,
+// то есть по 1/N от каждого блока. Потерянный кадр превращается в равномерно
+// разнесённые стирания в каждом блоке вместо потери одного блока целиком.
+namespace frame_interleaver {
+
+constexpr uint8_t MAX_DEPTH = 8;   // наибольшее число кадров в группе
+
+// Перемежение depth блоков одинаковой длины len на месте
+bool interleave(uint8_t* const* frames, size_t depth, size_t len);
+// Обратное преобразование для полностью принятой группы
+bool deinterleave(uint8_t* const* frames, size_t depth, size_t len);
+
+// Накопитель группы на приёме: кадры приходят по одному, потерянные дают стирания
+class Group {
+public:
+  // Новая группа из depth кадров полезной нагрузкой по len байт
+  bool reset(uint8_t depth, size_t len);
+  // Кадр с позицией pos внутри группы; false — неверная позиция, длина или повтор
+  bool add(uint8_t pos, const uint8_t* data, size_t len);
+  bool complete() const { return depth_ != 0 && received_ == depth_; }
+  uint8_t depth() const { return depth_; }
+  uint8_t receivedCount() const { return received_; }
+  // Восстановленный блок i и маска стёртых байтов (0xFF — байт из потерянного кадра)
+  bool block(uint8_t i, std::vector<uint8_t>& out, std::vector<uint8_t>& erased) const;
+
+private:
+  uint8_t depth_ = 0;
+  uint8_t received_ = 0;
+  uint8_t mask_ = 0;                 // принятые позиции
+  size_t len_ = 0;
+  std::vector<uint8_t> frames_;      // depth_ кадров подряд
+};
+
+} // namespace frame_interleaver
@@ -0,0 +1,92 @@
+#include "harq.h"
+#include "../viterbi/viterbi.h"
+
+namespace harq {
+namespace {
+// Период 10 шагов кодера (20 бит X0 Y0 X1 Y1 ...), кратный периоду шаблона 5/6.
+// RV0 — X 10101, Y 11010; выколотые биты поровну и вперемешку делятся между RV1 и RV2
+constexpr size_t PERIOD_BITS = 20;
+constexpr uint8_t RV_OF_BIT[PERIOD_BITS] = {
+  0, 0, 1, 0, 0, 2, 2, 0, 0, 1,
+  0, 0, 1, 0, 0, 2, 2, 0, 0, 1,
+};
+
+inline uint8_t getBit(const uint8_t* data, size_t bit) {
+  return (data[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+inline void putBit(uint8_t* data, size_t bit, uint8_t value) {
+  data[bit >> 3] |= static_cast<uint8_t>(value << (7 - (bit & 7)));
+}
+} // namespace
+
+size_t redundancyBits(size_t input_len, uint8_t rv) {
+  if (rv >= RV_COUNT) return 0;
+  const size_t total = input_len * 16;
+  size_t bits = 0;
+  for (size_t i = 0; i < PERIOD_BITS; ++i) {
+    if (RV_OF_BIT[i] != rv) continue;
+    if (i < total) bits += (total - i + PERIOD_BITS - 1) / PERIOD_BITS; // позиции i, i+20, ...
+  }
+  return bits;
+}
+
+size_t redundancySize(size_t input_len, uint8_t rv) {
+  return (redundancyBits(input_len, rv) + 7) / 8;
+}
+
+bool buildRedundancy(const uint8_t* input, size_t len, uint8_t rv, std::vector<uint8_t>& out) {
+  if (!input || len == 0 || rv >= RV_COUNT) return false;
+  std::vector<uint8_t> mother;
+  vit::encode(input, len, mother);
+  out.assign(redundancySize(len, rv), 0);
+  size_t pos = 0;
+  for (size_t i = 0; i < len * 16; ++i) {
+    if (RV_OF_BIT[i % PERIOD_BITS] != rv) continue;
+    putBit(out.data(), pos++, getBit(mother.data(), i));
+  }
+  return true;
+}
+
+size_t inputLenFromFirst(size_t rv0_len) {
+  // RV0 несёт 6 бит на 5 входных, поэтому вход не длиннее первой передачи
+  for (size_t len = rv0_len; len > 0; --len) {
+    const size_t size = redundancySize(len, 0);
+    if (size == rv0_len) return len;
+    if (size < rv0_len) break;
+  }
+  return 0;
+}
+
+void Combiner::reset(size_t input_len) {
+  input_len_ = input_len;
+  received_ = 0;
+  bits_.assign(input_len * 16, 0);
+  valid_.assign(input_len * 16, 0);
+}
+
+bool Combiner::add(uint8_t rv, const uint8_t* data, size_t len) {
+  if (!data || rv >= RV_COUNT || input_len_ == 0 || len != redundancySize(input_len_, rv)) return false;
+  size_t pos = 0;
+  for (size_t i = 0; i < bits_.size(); ++i) {
+    if (RV_OF_BIT[i % PERIOD_BITS] != rv) continue;
+    bits_[i] = getBit(data, pos++);            // повтор той же версии заменяет прежние жёсткие решения
+    valid_[i] = 1;
+  }
+  received_ |= static_cast<uint8_t>(1U << rv);
+  return true;
+}
+
+uint8_t Combiner::nextRv() const {
+  for (uint8_t rv = 0; rv < RV_COUNT; ++rv) {
+    if (!has(rv)) return rv;
+  }
+  return RV_COUNT;
+}
+
+bool Combiner::decode(std::vector<uint8_t>& out) const {
+  if (received_ == 0) return false;
+  return vit::decodeErasures(bits_.data(), valid_.data(), input_len_ * 8, out);
+}
+
+} // namespace harq
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Гибридный ARQ с нарастающей избыточностью (тип II) поверх свёрточного кода K=7 1/2.
+// Материнский поток делится на вложенные версии избыточности (RV):
+//   RV0 — биты проколотой скорости 5/6 (первая передача, совпадает с conv_codec::Rate::R5_6);
+//   RV1 — половина выколотых бит, вместе с RV0 дающая скорость 5/8;
+//   RV2 — оставшиеся биты, вместе с RV0 и RV1 дающие полную скорость 1/2.
+// При ошибке декодирования приёмник запрашивает следующую RV, а передатчик отправляет только её.
+namespace harq {
+
+constexpr uint8_t RV_COUNT = 3;
+
+// Число бит и байт версии rv для входа кодера длиной input_len байт
+size_t redundancyBits(size_t input_len, uint8_t rv);
+size_t redundancySize(size_t input_len, uint8_t rv);
+// Биты версии rv для входа кодера (данные вместе с хвостом)
+bool buildRedundancy(const uint8_t* input, size_t len, uint8_t rv, std::vector<uint8_t>& out);
+// Длина входа кодера по размеру первой передачи (RV0); 0 — размер не соответствует ни одному входу
+size_t inputLenFromFirst(size_t rv0_len);
+
+// Накопитель принятых версий одного фрагмента: принятые биты раскладываются по позициям
+// материнского кода, недостающие считаются стираниями
+class Combiner {
+public:
+  // Новый фрагмент с входом кодера input_len байт
+  void reset(size_t input_len);
+  size_t inputLen() const { return input_len_; }
+  // Добавить принятую версию; false — неверный номер или длина
+  bool add(uint8_t rv, const uint8_t* data, size_t len);
+  bool has(uint8_t rv) const { return rv < RV_COUNT && (received_ & (1U << rv)) != 0; }
+  // Следующая недостающая версия; RV_COUNT — избыточность исчерпана
+  uint8_t nextRv() const;
+  // Декодирование по всем принятым версиям
+  bool decode(std::vector<uint8_t>& out) const;
+
+private:
+  size_t input_len_ = 0;
+  uint8_t received_ = 0;          // маска принятых версий
+  std::vector<uint8_t> bits_;     // распакованные биты материнского кода
+  std::vector<uint8_t> valid_;    // 1 — бит принят
+};
+
+} // namespace harq
@@ -0,0 +1,122 @@
+#include "jpeg_uep.h"
+#include <algorithm>
+
+namespace jpeg_uep {
+
+namespace {
+
+constexpr uint8_t MARKER_PREFIX = 0xFF;
+constexpr uint8_t MARKER_SOI = 0xD8;
+constexpr uint8_t MARKER_EOI = 0xD9;
+constexpr uint8_t MARKER_SOS = 0xDA;
+constexpr uint8_t MARKER_TEM = 0x01;
+
+bool isRestart(uint8_t marker) { return marker >= 0xD0 && marker <= 0xD7; }
+
+} // namespace
+
+bool isJpeg(const uint8_t* data, size_t len) {
+  return data && len >= 3 && data[0] == MARKER_PREFIX && data[1] == MARKER_SOI && data[2] == MARKER_PREFIX;
+}
+
+bool parse(const uint8_t* data, size_t len, std::vector<Segment>& out) {
+  out.clear();
+  if (!data || len < 4 || data[0] != MARKER_PREFIX || data[1] != MARKER_SOI) return false;
+  // Соседние маркерные сегменты сливаются, интервалы скана остаются отдельными
+  auto push = [&](size_t offset, size_t n, bool critical) {
+    if (n == 0) return;
+    if (critical && !out.empty() && out.back().critical) {
+      out.back().len += n;
+      return;
+    }
+    out.push_back(Segment{offset, n, critical});
+  };
+  push(0, 2, true);                                    // SOI
+  size_t pos = 2;
+  while (pos < len) {
+    if (data[pos] != MARKER_PREFIX) return false;      // посторонние байты между сегментами
+    size_t m = pos;
+    while (m < len && data[m] == MARKER_PREFIX) ++m;  // байты заполнения перед маркером
+    if (m >= len) return false;
+    const uint8_t marker = data[m];
+    if (marker == MARKER_EOI) {
+      if (!out.empty() && !out.back().critical) {
+        out.back().len = len - out.back().offset;      // EOI и хвост — к последнему интервалу
+      } else {
+        push(pos, len - pos, true);
+      }
+      return true;
+    }
+    if (isRestart(marker) || marker == MARKER_TEM) {   // маркеры без длины
+      push(pos, m + 1 - pos, true);
+      pos = m + 1;
+      continue;
+    }
+    if (m + 2 >= len) return false;
+    const size_t seg_len = (static_cast<size_t>(data[m + 1]) << 8) | data[m + 2];
+    if (seg_len < 2 || m + 1 + seg_len > len) return false;
+    const size_t end = m + 1 + seg_len;
+    push(pos, end - pos, true);
+    pos = end;
+    if (marker != MARKER_SOS) continue;
+
+    // Энтропийные данные скана: FF 00 — экранированный байт, RSTn открывает новый интервал
+    size_t start = pos;
+    size_t i = pos;
+    while (i + 1 < len) {
+      if (data[i] != MARKER_PREFIX) {
+        ++i;
+        continue;
+      }
+      const uint8_t next = data[i + 1];
+      if (next == 0x00) {
+        i += 2;
+        continue;
+      }
+      if (next == MARKER_PREFIX) {
+        ++i;
+        continue;
+      }
+      if (isRestart(next)) {
+        push(start, i - start, false);
+        start = i;
+        i += 2;
+        continue;
+      }
+      break;                                           // маркер вне скана завершает его
+    }
+    if (i + 1 >= len) {                                // файл оборван внутри скана
+      push(start, len - start, false);
+      return true;
+    }
+    push(start, i - start, false);
+    pos = i;
+  }
+  return true;
+}
+
+bool plan(const uint8_t* data, size_t len, size_t header_chunk, size_t scan_chunk,
+          std::vector<Segment>& parts) {
+  parts.clear();
+  if (header_chunk == 0 || scan_chunk == 0) return false;
+  std::vector<Segment> segments;
+  if (!parse(data, len, segments)) return false;
+  for (const auto& seg : segments) {
+    if (seg.critical) {
+      for (size_t off = 0; off < seg.len; off += header_chunk) {
+        parts.push_back(Segment{seg.offset + off, std::min(header_chunk, seg.len - off), true});
+      }
+      continue;
+    }
+    if (!parts.empty() && !parts.back().critical && parts.back().len + seg.len <= scan_chunk) {
+      parts.back().len += seg.len;                     // интервал целиком помещается в текущую часть
+      continue;
+    }
+    for (size_t off = 0; off < seg.len; off += scan_chunk) {
+      parts.push_back(Segment{seg.offset + off, std::min(scan_chunk, seg.len - off), false});
+    }
+  }
+  return !parts.empty();
+}
+
+} // namespace jpeg_uep
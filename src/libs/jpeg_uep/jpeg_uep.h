@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Неравная защита JPEG: разбор маркеров и план фрагментов. Сегменты заголовка
+// (DQT, DHT, SOF, SOS и т. п.) без потерь нужны всему кадру, а потеря части
+// данных скана портит лишь несколько блоков до ближайшего маркера рестарта.
+namespace jpeg_uep {
+
+// Непрерывный участок файла
+struct Segment {
+  size_t offset = 0;
+  size_t len = 0;
+  bool critical = false;   // маркерный сегмент (true) или данные скана (false)
+};
+
+// Быстрая проверка сигнатуры FF D8 FF
+bool isJpeg(const uint8_t* data, size_t len);
+
+// Разбор файла на маркерные сегменты и интервалы рестарта. Каждый интервал скана
+// начинается со своего маркера RSTn, EOI и хвост после него входят в последний интервал.
+// false — файл обрывается внутри маркерного сегмента или не начинается с SOI
+bool parse(const uint8_t* data, size_t len, std::vector<Segment>& out);
+
+// План частей сообщения: маркерные сегменты режутся по header_chunk, интервалы рестарта
+// укладываются целиком в части до scan_chunk (длинный интервал делится по размеру).
+// Части идут подряд и покрывают весь файл
+bool plan(const uint8_t* data, size_t len, size_t header_chunk, size_t scan_chunk,
+          std::vector<Segment>& parts);
+
+} // namespace jpeg_uep
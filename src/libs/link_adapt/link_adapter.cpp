@@ -0,0 +1,158 @@
+#include "link_adapter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace link_adapt {
+
+namespace {
+// Пороги SNR демодуляции SX1262 по SF: от -2,5 дБ для SF5 до -20 дБ для SF12. CR 4/8
+// добавляет около 1 дБ, свёртка 1/2 с интерливингом — около 3 дБ. На нижних ступенях кадр
+// идёт секунды, и замирание чаще накрывает его целиком — там блоки перемежаются по 4 кадрам
+constexpr Profile kProfiles[] = {
+  {12, 8, true, true, true, 4, -24.0f},
+  {11, 8, true, true, true, 4, -21.5f},
+  {10, 6, true, true, true, 4, -18.5f},
+  {9, 5, true, false, true, 1, -15.5f},
+  {8, 5, true, false, true, 1, -13.0f},
+  {7, 5, true, false, true, 1, -10.5f},
+  {7, 5, false, false, false, 1, -7.5f},
+  {6, 5, false, false, false, 1, -5.0f},
+  {5, 5, false, false, false, 1, -2.5f},
+};
+constexpr size_t kProfileCount = sizeof(kProfiles) / sizeof(kProfiles[0]);
+
+constexpr float SNR_ALPHA = 0.25f;   // вес нового кадра в сглаженном SNR/RSSI
+constexpr float PER_ALPHA = 0.1f;    // вес нового исхода в сглаженной доле потерь
+}
+
+size_t rungCount() { return kProfileCount; }
+
+const Profile& profile(uint8_t rung) {
+  return kProfiles[std::min<size_t>(rung, kProfileCount - 1)];
+}
+
+float relativeRate(uint8_t spreadingFactor, uint8_t codingRateDenom, bool conv) {
+  if (spreadingFactor == 0 || codingRateDenom == 0) return 0.0f;
+  const float bitsPerSymbol = static_cast<float>(spreadingFactor) * 4.0f / static_cast<float>(codingRateDenom);
+  const float rate = bitsPerSymbol / static_cast<float>(1UL << spreadingFactor);
+  return conv ? rate * 0.5f : rate;
+}
+
+uint8_t matchRung(uint8_t spreadingFactor, uint8_t codingRateDenom, bool conv) {
+  const float target = relativeRate(spreadingFactor, codingRateDenom, conv);
+  uint8_t best = 0;
+  for (size_t i = 0; i < kProfileCount; ++i) {
+    const Profile& p = kProfiles[i];
+    if (relativeRate(p.spreadingFactor, p.codingRateDenom, p.conv) <= target * 1.001f) {
+      best = static_cast<uint8_t>(i);
+    }
+  }
+  return best;
+}
+
+LinkAdapter::LinkAdapter(uint8_t baseRung, const Settings& settings)
+    : settings_(settings) {
+  reset(baseRung);
+}
+
+void LinkAdapter::reset(uint8_t baseRung) {
+  base_ = static_cast<uint8_t>(std::min<size_t>(baseRung, kProfileCount - 1));
+  local_ = base_;
+  peer_ = base_;
+  applied_ = base_;
+  peerSeen_ = false;
+  snr_ = 0.0f;
+  rssi_ = 0.0f;
+  per_ = 0.0f;
+  samples_ = 0;
+  advertised_ = false;
+}
+
+void LinkAdapter::onRxFrame(float snrDb, float rssiDbm, bool complete, uint32_t nowMs) {
+  if (samples_ == 0) {
+    snr_ = snrDb;
+    rssi_ = rssiDbm;
+  } else {
+    snr_ += SNR_ALPHA * (snrDb - snr_);
+    rssi_ += SNR_ALPHA * (rssiDbm - rssi_);
+  }
+  ++samples_;
+  lastHeardMs_ = nowMs;
+  recordOutcome(complete);
+}
+
+void LinkAdapter::onAckResult(bool acked) {
+  recordOutcome(acked);
+}
+
+void LinkAdapter::onPeerAdvert(uint8_t rung, uint32_t nowMs) {
+  peer_ = static_cast<uint8_t>(std::min<size_t>(rung, kProfileCount - 1));
+  peerSeen_ = true;
+  lastHeardMs_ = nowMs;
+}
+
+void LinkAdapter::recordOutcome(bool ok) {
+  per_ += PER_ALPHA * ((ok ? 0.0f : 1.0f) - per_);
+}
+
+// Самая быстрая ступень, порог которой с запасом ниже текущего SNR
+uint8_t LinkAdapter::snrCeiling() const {
+  uint8_t rung = 0;
+  for (size_t i = 0; i < kProfileCount; ++i) {
+    if (kProfiles[i].requiredSnrDb + settings_.marginDb <= snr_) {
+      rung = static_cast<uint8_t>(i);
+    }
+  }
+  return rung;
+}
+
+bool LinkAdapter::update(uint32_t nowMs) {
+  bool advertise = false;
+  if (applied_ != base_ && (nowMs - lastHeardMs_) >= settings_.fallbackMs) {
+    // Пир не слышен на новом профиле — вероятно, анонс потерян. Обе стороны возвращаются к базе
+    LOG_WARN("LinkAdapter: пир молчит %lu мс, возврат к базовой ступени %u",
+             static_cast<unsigned long>(nowMs - lastHeardMs_), static_cast<unsigned>(base_));
+    local_ = base_;
+    peer_ = base_;
+    peerSeen_ = false;
+    lastRaiseMs_ = nowMs;
+    advertise = true;
+  } else if (samples_ >= settings_.minSamples) {
+    uint8_t target = snrCeiling();
+    if (per_ > settings_.targetPer && target >= applied_) {
+      target = applied_ > 0 ? static_cast<uint8_t>(applied_ - 1) : 0; // потери при достаточном SNR — шаг вниз
+    }
+    if (target < local_) {
+      local_ = target;                     // понижение сразу
+      lastRaiseMs_ = nowMs;
+      advertise = true;
+    } else if (target > local_ && per_ <= settings_.targetPer &&
+               (nowMs - lastRaiseMs_) >= settings_.holdMs) {
+      const uint8_t next = static_cast<uint8_t>(local_ + 1);
+      if (snr_ >= profile(next).requiredSnrDb + settings_.marginDb + settings_.hysteresisDb) {
+        local_ = next;                     // повышение по одной ступени с гистерезисом
+        lastRaiseMs_ = nowMs;
+        advertise = true;
+      }
+    }
+  }
+  const uint8_t next = peerSeen_ ? std::min(local_, peer_) : base_;
+  if (next != applied_) {
+    LOG_INFO("LinkAdapter: ступень %u -> %u (SNR %.1f дБ, PER %.2f)", static_cast<unsigned>(applied_),
+             static_cast<unsigned>(next), static_cast<double>(snr_), static_cast<double>(per_));
+    applied_ = next;
+    samples_ = 0;                          // статистика прежнего профиля не описывает новый
+    per_ = 0.0f;
+    lastHeardMs_ = nowMs;
+  }
+  if (!advertised_ || (nowMs - lastAdvertMs_) >= settings_.advertMs) {
+    advertise = true;
+  }
+  if (advertise) {
+    advertised_ = true;
+    lastAdvertMs_ = nowMs;
+  }
+  return advertise;
+}
+
+} // namespace link_adapt
@@ -0,0 +1,89 @@
+#ifndef LIBS_LINK_ADAPT_LINK_ADAPTER_H
+#define LIBS_LINK_ADAPT_LINK_ADAPTER_H
+#include <cstddef>
+#include <cstdint>
+#include "default_settings.h"
+
+namespace link_adapt {
+
+// Профиль модема и FEC на одной ступени лестницы адаптации. Полоса не меняется:
+// она задаёт шаг сетки каналов и допуск по доплеровскому сдвигу
+struct Profile {
+  uint8_t spreadingFactor;     // SF 5..12
+  uint8_t codingRateDenom;     // делитель CR 5..8
+  bool conv;                   // свёрточное кодирование
+  bool rs;                     // код Рида — Соломона поверх свёртки
+  bool bitInterleaver;         // битовый интерливинг после свёртки
+  uint8_t frameInterleave;     // межкадровый интерливинг (1 — выкл.)
+  float requiredSnrDb;         // порог демодуляции SX1262 с учётом выигрыша FEC (дБ)
+};
+
+// Число ступеней; 0 — самая устойчивая, последняя — самая быстрая
+size_t rungCount();
+const Profile& profile(uint8_t rung);
+// Относительная скорость полезных данных ступени (бит на символ с учётом CR и FEC)
+float relativeRate(uint8_t spreadingFactor, uint8_t codingRateDenom, bool conv);
+// Самая быстрая ступень, не превышающая по скорости заданную конфигурацию
+uint8_t matchRung(uint8_t spreadingFactor, uint8_t codingRateDenom, bool conv);
+
+struct Settings {
+  float targetPer = DefaultSettings::LINK_TARGET_PER;        // допустимая доля потерянных кадров
+  float marginDb = DefaultSettings::LINK_SNR_MARGIN_DB;      // запас над порогом демодуляции
+  float hysteresisDb = DefaultSettings::LINK_HYSTERESIS_DB;  // дополнительный запас для повышения
+  uint32_t holdMs = DefaultSettings::LINK_HOLD_MS;           // минимум между повышениями ступени
+  uint32_t advertMs = DefaultSettings::LINK_ADVERT_MS;       // период повторного анонса ступени
+  uint32_t fallbackMs = DefaultSettings::LINK_FALLBACK_MS;   // тишина, после которой профиль сбрасывается
+  uint8_t minSamples = DefaultSettings::LINK_MIN_SAMPLES;    // кадров до первого решения
+};
+
+// Статистика канала и выбор профиля. Каждая сторона оценивает свой приём и анонсирует
+// пиру рекомендуемую ступень; обе применяют минимум из своей и чужой рекомендации,
+// поэтому сходятся к одному профилю. Пока пир не прислал анонс, действует базовый профиль
+class LinkAdapter {
+public:
+  explicit LinkAdapter(uint8_t baseRung = 0, const Settings& settings = Settings());
+
+  // Сброс статистики и возврат к базовой ступени (смена конфигурации вручную)
+  void reset(uint8_t baseRung);
+  // Принятый кадр: SNR/RSSI последнего пакета и признак потерь при сборке
+  void onRxFrame(float snrDb, float rssiDbm, bool complete, uint32_t nowMs);
+  // Итог ожидания ACK для отправленного сообщения
+  void onAckResult(bool acked);
+  // Анонс ступени от пира
+  void onPeerAdvert(uint8_t rung, uint32_t nowMs);
+  // Пересчёт рекомендации. true — пиру нужно отправить анонс localRung()
+  bool update(uint32_t nowMs);
+
+  uint8_t baseRung() const { return base_; }
+  uint8_t localRung() const { return local_; }
+  uint8_t peerRung() const { return peer_; }
+  uint8_t appliedRung() const { return applied_; }
+  bool peerSeen() const { return peerSeen_; }
+  float snr() const { return snr_; }
+  float rssi() const { return rssi_; }
+  float per() const { return per_; }
+  uint32_t samples() const { return samples_; }
+
+private:
+  void recordOutcome(bool ok);
+  uint8_t snrCeiling() const;
+
+  Settings settings_;
+  uint8_t base_ = 0;
+  uint8_t local_ = 0;          // рекомендация по собственному приёму
+  uint8_t peer_ = 0;           // последняя рекомендация пира
+  uint8_t applied_ = 0;        // действующая ступень
+  bool peerSeen_ = false;
+  float snr_ = 0.0f;           // сглаженный SNR (дБ)
+  float rssi_ = 0.0f;          // сглаженный RSSI (дБм)
+  float per_ = 0.0f;           // сглаженная доля потерь
+  uint32_t samples_ = 0;       // кадров с момента смены профиля
+  uint32_t lastHeardMs_ = 0;   // последний кадр от пира
+  uint32_t lastRaiseMs_ = 0;   // последнее изменение рекомендации
+  uint32_t lastAdvertMs_ = 0;  // последний анонс
+  bool advertised_ = false;
+};
+
+} // namespace link_adapt
+
+#endif // LIBS_LINK_ADAPT_LINK_ADAPTER_H
@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace lockfree {
+
+// Ограниченная очередь без блокировок для нескольких производителей и одного потребителя.
+// Каждая ячейка хранит номер поколения: производитель занимает позицию через CAS по хвосту
+// и публикует элемент записью номера, потребитель забирает ячейку и освобождает её на
+// следующий круг. Память выделена заранее, операции не ждут друг друга и годятся для
+// задач FreeRTOS на разных ядрах.
+template <typename T, size_t Capacity>
+class MpscQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "ёмкость очереди должна быть степенью двойки");
+
+public:
+  MpscQueue() {
+    for (size_t i = 0; i < Capacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  // Добавить элемент; false — очередь заполнена
+  bool tryPush(const T& value) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & (Capacity - 1)];
+      const size_t seq = cell.sequence.load(std::memory_order_acquire);
+      const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.value = value;
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;                        // ячейка ещё не освобождена потребителем
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Забрать элемент; вызывается только из потока-потребителя
+  bool tryPop(T& out) {
+    Cell& cell = cells_[head_ & (Capacity - 1)];
+    const size_t seq = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(head_ + 1) < 0) {
+      return false;                          // пусто или производитель ещё пишет элемент
+    }
+    out = cell.value;
+    cell.sequence.store(head_ + Capacity, std::memory_order_release);
+    ++head_;
+    return true;
+  }
+
+  // Оценка наличия элементов без изъятия (для потребителя)
+  bool empty() const {
+    const Cell& cell = cells_[head_ & (Capacity - 1)];
+    return cell.sequence.load(std::memory_order_acquire) != head_ + 1;
+  }
+
+  static constexpr size_t capacity() { return Capacity; }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence{0};
+    T value{};
+  };
+
+  std::array<Cell, Capacity> cells_;
+  std::atomic<size_t> tail_{0};              // следующая позиция для производителей
+  size_t head_ = 0;                          // позиция потребителя
+};
+
+} // namespace lockfree
@@ -0,0 +1,134 @@
+#include "lzss.h"
+#include "../text_converter/text_converter.h"
+#include <algorithm>
+
+namespace lzss {
+
+namespace {
+
+// Частые слова и обороты чата, служебных строк и команд. Строки, встречающиеся чаще,
+// стоят ближе к концу: так они остаются в окне и для длинных сообщений
+const char* const DICTIONARY_UTF8 =
+    "status battery voltage temperature humidity pressure position latitude longitude altitude "
+    "speed heading signal RSSI SNR frequency bandwidth spreading factor coding rate power channel "
+    "bank error timeout retry received sent message image ready done failed unknown enabled disabled "
+    "ACK NACK INFO BEACON PING SF BW CR TX RX OK "
+    "hello hi thanks thank you please yes no what where when how are you good morning evening night "
+    "copy roger over out see you later wait for the and with this that from here there now "
+    "температура давление влажность напряжение батарея заряд координаты широта долгота высота "
+    "скорость курс сигнал частота мощность канал ошибка ответ повтор статус состояние норма "
+    "сообщение сообщения получено получил отправлено отправил приём передача изображение "
+    "доброе утро добрый день добрый вечер спокойной ночи как дела как слышно слышу хорошо плохо "
+    "понял принял подтверждаю на связи связь есть нет связи всё в порядке до связи спасибо пожалуйста "
+    "привет здравствуйте пока сейчас потом сегодня завтра вчера где когда что как почему "
+    "это что-то не знаю можно нужно будет было есть да нет ок ";
+
+} // namespace
+
+const std::vector<uint8_t>& dictionary() {
+  static const std::vector<uint8_t> dict = utf8ToCp1251(DICTIONARY_UTF8);
+  return dict;
+}
+
+bool pack(const uint8_t* data, size_t len, std::vector<uint8_t>& out, bool use_dictionary) {
+  out.clear();
+  if (!data || len == 0 || len > MAX_LENGTH) return false;
+  // Окно: словарь и уже пройденные байты сообщения подряд
+  const auto& dict = dictionary();
+  const size_t base = use_dictionary ? dict.size() : 0;
+  std::vector<uint8_t> window;
+  window.reserve(base + len);
+  if (use_dictionary) window.insert(window.end(), dict.begin(), dict.end());
+  window.insert(window.end(), data, data + len);
+
+  out.reserve(len);
+  out.push_back(MARKER);
+  out.push_back(static_cast<uint8_t>((use_dictionary ? 0x80 : 0x00) | (len >> 8)));
+  out.push_back(static_cast<uint8_t>(len));
+  size_t control_pos = 0;
+  uint8_t bit = 8;
+  size_t pos = base;
+  const size_t end = base + len;
+  while (pos < end) {
+    if (out.size() >= len) {                         // выигрыша уже не будет
+      out.clear();
+      return false;
+    }
+    if (bit == 8) {
+      control_pos = out.size();
+      out.push_back(0);
+      bit = 0;
+    }
+    // Жадный поиск самого длинного повтора в окне (сообщения короткие, окно 4 КиБ)
+    const size_t limit = std::min(MAX_MATCH, end - pos);
+    size_t best_len = 0;
+    size_t best_off = 0;
+    if (limit >= MIN_MATCH) {
+      const size_t from = pos > WINDOW ? pos - WINDOW : 0;
+      for (size_t cand = pos; cand-- > from;) {
+        if (window[cand] != window[pos]) continue;
+        size_t n = 1;
+        while (n < limit && window[cand + n] == window[pos + n]) ++n;  // допускается перекрытие с pos
+        if (n > best_len) {
+          best_len = n;
+          best_off = pos - cand;
+          if (n == limit) break;
+        }
+      }
+    }
+    if (best_len >= MIN_MATCH) {
+      out[control_pos] |= static_cast<uint8_t>(1u << bit);
+      out.push_back(static_cast<uint8_t>(best_off >> 4));
+      out.push_back(static_cast<uint8_t>(((best_off & 0x0F) << 4) | (best_len - MIN_MATCH)));
+      pos += best_len;
+    } else {
+      out.push_back(window[pos]);
+      ++pos;
+    }
+    ++bit;
+  }
+  if (out.size() >= len) {
+    out.clear();
+    return false;
+  }
+  return true;
+}
+
+bool unpack(const uint8_t* data, size_t len, std::vector<uint8_t>& out, size_t max_len) {
+  out.clear();
+  if (!data || len < HEADER_SIZE + 1 || data[0] != MARKER) return false;
+  const bool use_dictionary = (data[1] & 0x80) != 0;
+  const size_t total = (static_cast<size_t>(data[1] & 0x7F) << 8) | data[2];
+  if (total == 0 || total > max_len) return false;
+  const auto& dict = dictionary();
+  const size_t base = use_dictionary ? dict.size() : 0;
+  out.reserve(total);
+  // Байт окна: словарь перед началом выхода
+  auto at = [&](size_t i) -> uint8_t { return i < base ? dict[i] : out[i - base]; };
+  size_t pos = HEADER_SIZE;
+  while (out.size() < total) {
+    if (pos >= len) return false;
+    const uint8_t control = data[pos++];
+    for (uint8_t bit = 0; bit < 8 && out.size() < total; ++bit) {
+      if (!(control & (1u << bit))) {
+        if (pos >= len) return false;
+        out.push_back(data[pos++]);
+        continue;
+      }
+      if (pos + 1 >= len) return false;
+      const size_t off = (static_cast<size_t>(data[pos]) << 4) | (data[pos + 1] >> 4);
+      const size_t n = (data[pos + 1] & 0x0F) + MIN_MATCH;
+      pos += 2;
+      const size_t cur = base + out.size();
+      if (off == 0 || off > cur || out.size() + n > total) return false;
+      for (size_t k = 0; k < n; ++k) out.push_back(at(cur - off + k));
+    }
+  }
+  if (pos != len) {
+    out.clear();
+    return false;
+  }
+  return true;
+}
+
+} // namespace lzss
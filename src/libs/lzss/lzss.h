@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Сжатие коротких текстов (чат, телеметрия, статусы) вариантом LZSS. Окно — 4 КиБ,
+// в его начало можно подставить статический словарь типичных русских и английских
+// фраз и команд (в CP1251), тогда повторы находятся даже в первом сообщении.
+//
+// Кадр: {MARKER, D|len_hi, len_lo, поток}. D (старший бит) — поток сжат со словарём,
+// len — исходная длина (15 бит). Поток — группы из управляющего байта и до восьми
+// токенов: бит 0 — литерал (1 байт), бит 1 — повтор (2 байта: смещение назад 12 бит
+// и длина - MIN_MATCH в 4 битах).
+namespace lzss {
+
+constexpr uint8_t MARKER = 0x1C;
+constexpr size_t HEADER_SIZE = 3;
+constexpr size_t MIN_MATCH = 3;
+constexpr size_t MAX_MATCH = MIN_MATCH + 15;
+constexpr size_t WINDOW = 4095;               // наибольшее смещение повтора
+constexpr size_t MAX_LENGTH = 0x7FFF;         // наибольшая исходная длина
+
+// Словарь в CP1251; одинаков на передатчике и приёмнике
+const std::vector<uint8_t>& dictionary();
+
+// Сжать data в кадр out. false — кадр получился бы не короче исходных данных,
+// тогда данные отправляются как есть
+bool pack(const uint8_t* data, size_t len, std::vector<uint8_t>& out, bool use_dictionary = true);
+
+// Распаковать кадр. Память ограничена: исходная длина больше max_len отвергается до
+// распаковки, выход не растёт сверх заявленной длины. false — не кадр LZSS или поток
+// повреждён (смещение за окно, лишние или недостающие байты)
+bool unpack(const uint8_t* data, size_t len, std::vector<uint8_t>& out, size_t max_len);
+
+} // namespace lzss
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace packetizer {
+
+// Участок исходного сообщения: указатель в буфер сообщения без копирования
+struct Span {
+  const uint8_t* data = nullptr;
+  size_t len = 0;
+  size_t offset = 0;       // смещение от начала сообщения
+  uint16_t index = 0;      // номер фрагмента
+};
+
+// Однопроходная нарезка сообщения на фрагменты по chunk байт (последний — остаток).
+// В отличие от PacketSplitter ничего не копирует и не добавляет текстовых префиксов:
+// номер и число фрагментов несёт двоичный FrameHeader, а кодер читает данные прямо из
+// буфера сообщения. Буфер должен жить, пока используются выданные участки
+class FragmentCursor {
+public:
+  FragmentCursor(const uint8_t* data, size_t len, size_t chunk)
+      : data_(data), len_(data ? len : 0), chunk_(chunk) {}
+
+  // Число фрагментов (0 — пустое сообщение или нулевой размер части)
+  size_t count() const { return chunk_ ? (len_ + chunk_ - 1) / chunk_ : 0; }
+  size_t chunk() const { return chunk_; }
+
+  // Фрагмент с номером idx; false — номер вне сообщения
+  bool at(size_t idx, Span& out) const {
+    if (idx >= count()) return false;
+    out.offset = idx * chunk_;
+    out.data = data_ + out.offset;
+    out.len = len_ - out.offset < chunk_ ? len_ - out.offset : chunk_;
+    out.index = static_cast<uint16_t>(idx);
+    return true;
+  }
+
+  // Следующий фрагмент по порядку; false — сообщение исчерпано
+  bool next(Span& out) { return at(pos_, out) ? (++pos_, true) : false; }
+  void rewind() { pos_ = 0; }
+
+private:
+  const uint8_t* data_ = nullptr;
+  size_t len_ = 0;
+  size_t chunk_ = 0;
+  size_t pos_ = 0;
+};
+
+}  // namespace packetizer
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+namespace aggregate {
+
+// Агрегированный кадр: {MARKER, count, len_1, data_1, ..., len_n, data_n}. Несколько коротких
+// «сырых» сообщений уходят одним кадром под общей преамбулой, приёмник обрабатывает каждую
+// запись как отдельно принятый кадр
+constexpr uint8_t MARKER = 0x17;
+constexpr size_t HEADER_SIZE = 2;
+constexpr size_t MAX_RECORD = 255;    // длина записи хранится в одном байте
+constexpr size_t MAX_RECORDS = 255;
+
+// Начать кадр без записей
+inline void begin(std::vector<uint8_t>& frame) {
+  frame.assign({MARKER, 0});
+}
+
+// Добавить запись; false — запись пустая, слишком длинная или кадр заполнен
+inline bool append(std::vector<uint8_t>& frame, const uint8_t* data, size_t len) {
+  if (!data || len == 0 || len > MAX_RECORD) return false;
+  if (frame.size() < HEADER_SIZE || frame[0] != MARKER || frame[1] >= MAX_RECORDS) return false;
+  frame.push_back(static_cast<uint8_t>(len));
+  frame.insert(frame.end(), data, data + len);
+  ++frame[1];
+  return true;
+}
+
+// Размер кадра после добавления записи длиной len
+inline size_t grownSize(size_t frame_len, size_t len) {
+  return frame_len + 1 + len;
+}
+
+// Обход записей: fn(data, len) для каждой. Кадр принимается, только если записей не меньше
+// двух и они ровно покрывают его, поэтому обычный текст с байтом 0x17 в начале не разбирается
+template <typename Fn>
+inline bool forEach(const uint8_t* data, size_t len, Fn&& fn) {
+  if (!data || len < HEADER_SIZE || data[0] != MARKER || data[1] < 2) return false;
+  size_t pos = HEADER_SIZE;
+  for (uint8_t i = 0; i < data[1]; ++i) {
+    if (pos >= len) return false;
+    const size_t rec_len = data[pos];
+    if (rec_len == 0 || pos + 1 + rec_len > len) return false;
+    pos += 1 + rec_len;
+  }
+  if (pos != len) return false;
+  pos = HEADER_SIZE;
+  for (uint8_t i = 0; i < data[1]; ++i) {
+    const size_t rec_len = data[pos];
+    fn(data + pos + 1, rec_len);
+    pos += 1 + rec_len;
+  }
+  return true;
+}
+
+// Проверка структуры без обхода
+inline bool isAggregate(const uint8_t* data, size_t len) {
+  return forEach(data, len, [](const uint8_t*, size_t) {});
+}
+
+}  // namespace aggregate
+}  // namespace protocol
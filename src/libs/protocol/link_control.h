@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace protocol {
+namespace link {
+
+// Служебный кадр адаптации канала: {MARKER, VERSION, ступень}. Передаётся «сырым»
+// пакетом без заголовка и подтверждения, поэтому совпадает по форме с компактным ACK
+constexpr uint8_t MARKER = 0x05;
+constexpr uint8_t VERSION = 1;
+constexpr size_t SIZE = 3;
+
+// Проверяем полезную нагрузку на соответствие управляющему кадру и извлекаем ступень
+inline bool decodeControl(const uint8_t* data, size_t len, uint8_t& rung) {
+  if (!data || len != SIZE || data[0] != MARKER || data[1] != VERSION) return false;
+  rung = data[2];
+  return true;
+}
+
+// Формируем управляющий кадр с рекомендуемой ступенью профиля
+inline void encodeControl(uint8_t rung, uint8_t (&out)[SIZE]) {
+  out[0] = MARKER;
+  out[1] = VERSION;
+  out[2] = rung;
+}
+
+}  // namespace link
+}  // namespace protocol
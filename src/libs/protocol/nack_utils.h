@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace protocol {
+namespace nack {
+
+// Запрос дополнительной избыточности HARQ: {MARKER, msg_id (2), frag_idx (2), rv}.
+// Передаётся «сырым» пакетом без заголовка, как и компактный ACK
+constexpr uint8_t MARKER = 0x15;
+constexpr size_t SIZE = 6;
+
+struct Request {
+  uint16_t msg_id = 0;     // сообщение, фрагмент которого не декодировался
+  uint16_t frag_idx = 0;   // индекс фрагмента
+  uint8_t rv = 0;          // запрашиваемая версия избыточности
+};
+
+// Проверяем полезную нагрузку на соответствие NACK и извлекаем запрос
+inline bool decode(const uint8_t* data, size_t len, Request& out) {
+  if (!data || len != SIZE || data[0] != MARKER) return false;
+  out.msg_id = static_cast<uint16_t>((data[1] << 8) | data[2]);
+  out.frag_idx = static_cast<uint16_t>((data[3] << 8) | data[4]);
+  out.rv = data[5];
+  return true;
+}
+
+// Формируем NACK для фрагмента
+inline void encode(const Request& req, uint8_t (&out)[SIZE]) {
+  out[0] = MARKER;
+  out[1] = static_cast<uint8_t>(req.msg_id >> 8);
+  out[2] = static_cast<uint8_t>(req.msg_id & 0xFF);
+  out[3] = static_cast<uint8_t>(req.frag_idx >> 8);
+  out[4] = static_cast<uint8_t>(req.frag_idx & 0xFF);
+  out[5] = req.rv;
+}
+
+}  // namespace nack
+}  // namespace protocol
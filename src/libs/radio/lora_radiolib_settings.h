@@ -23,6 +23,8 @@ struct SX1262DriverOptions {
   bool autoLdro = true;               // Автоматический выбор оптимизации для низких скоростей передачи (LDRO).
   bool implicitHeader = true;         // Использовать фиксированный размер пакета (implicit header) вместо стандартного заголовка.
   uint8_t implicitPayloadLength = 32; // Размер полезной нагрузки при implicit header (байты).
+  bool autoHeaderMode = true;         // Выбирать explicit/implicit и длину по минимуму времени в эфире
+                                      // для текущих SF/BW/CR (перекрывает implicitHeader/implicitPayloadLength).
   bool enableCrc = false;             // Добавлять ли аппаратный CRC в конец LoRa-пакета.
   bool invertIq = false;              // Инверсия фаз (I/Q) для совместимости с определёнными сетями.
   bool publicNetwork = true;          // Использовать стандартное публичное синхрослово LoRa (true) либо приватное (false).
@@ -35,6 +37,12 @@ struct SX1262DriverOptions {
 // Имя константы содержит суффикс OPTIONS, чтобы избежать конфликта с макросами Arduino (DEFAULT).
 constexpr SX1262DriverOptions DEFAULT_OPTIONS{};
 
+// Длины пакетов, из которых выбирается implicit-режим при autoHeaderMode (байты, не больше 245).
+constexpr uint16_t IMPLICIT_LENGTH_TABLE[] = {16, 32, 64, 128, 245};
+// Эталонный набор длин кадров канала, по которому сравнивается время в эфире режимов заголовка.
+// Обе стороны используют одинаковые таблицы, поэтому при общих SF/BW/CR выбирают один режим.
+constexpr uint16_t HEADER_MODE_REFERENCE_LENGTHS[] = {16, 48, 96, 160, 245};
+
 // Удобные псевдонимы для часто используемых параметров.
 constexpr bool DEFAULT_RX_BOOSTED_GAIN = DEFAULT_OPTIONS.rxBoostedGain;         // Режим усиленного приёма
 constexpr uint16_t DEFAULT_PREAMBLE_LENGTH = DEFAULT_OPTIONS.preambleLength;    // Длина преамбулы по умолчанию
@@ -0,0 +1,127 @@
+#include "subpacket.h"
+#include <algorithm>
+#include <cstring>
+
+namespace subpacket {
+
+size_t chunkCount(size_t frameLen, size_t packetSize) {
+  const size_t payload = chunkPayload(packetSize);
+  if (payload == 0 || frameLen == 0) return 0;
+  const size_t count = (frameLen + payload - 1) / payload;
+  return count <= MAX_CHUNKS ? count : 0;
+}
+
+size_t buildChunk(const uint8_t* frame, size_t frameLen, size_t seq, size_t packetSize,
+                  bool fixedLength, bool tag, uint8_t* out) {
+  const size_t count = chunkCount(frameLen, packetSize);
+  if (!frame || !out || seq >= count) return 0;
+  const size_t payload = chunkPayload(packetSize);
+  const size_t offset = seq * payload;
+  const size_t len = std::min(payload, frameLen - offset);
+  uint8_t marker = static_cast<uint8_t>(seq & SEQ_MASK);
+  if (tag) marker |= TAG_BIT;
+  if (seq + 1 == count) marker |= LAST_BIT;
+  if (!fixedLength || len == payload) {
+    out[0] = marker;
+    std::memcpy(out + OVERHEAD, frame + offset, len);
+    return fixedLength ? packetSize : OVERHEAD + len;
+  }
+  // Короткий хвост в пакете фиксированной длины: явная длина данных и нулевой заполнитель
+  out[0] = static_cast<uint8_t>(marker | PAD_BIT);
+  out[OVERHEAD] = static_cast<uint8_t>(len);
+  std::memcpy(out + OVERHEAD + 1, frame + offset, len);
+  std::memset(out + OVERHEAD + 1 + len, 0, packetSize - OVERHEAD - 1 - len);
+  return packetSize;
+}
+
+bool Assembler::push(const uint8_t* packet, size_t len, size_t packetSize, uint32_t nowMs) {
+  const size_t payload = chunkPayload(packetSize);
+  if (!packet || len <= OVERHEAD || payload == 0) {
+    ++droppedChunks_;
+    return false;
+  }
+  const uint8_t marker = packet[0];
+  const uint8_t seq = marker & SEQ_MASK;
+  const bool tag = (marker & TAG_BIT) != 0;
+  const bool last = (marker & LAST_BIT) != 0;
+  const bool pad = (marker & PAD_BIT) != 0;
+  const uint8_t* data = packet + OVERHEAD;
+  size_t dataLen = len - OVERHEAD;
+  if (pad) {
+    const size_t declared = data[0];
+    if (declared + 1 > dataLen) {              // длина вне пакета — маркер повреждён
+      ++droppedChunks_;
+      return false;
+    }
+    data += 1;
+    dataLen = declared;
+  }
+  if (dataLen > payload || (!last && dataLen != payload)) {
+    ++droppedChunks_;                           // пакет не соответствует текущей нарезке
+    return false;
+  }
+
+  // Новый кадр: сменилась метка или номер не растёт — незавершённый кадр отдаём с потерями
+  if (active_ && (tag != tag_ || seq <= lastSeq_ || payload != chunkPayload_)) {
+    flush();
+  }
+  if (!active_) {
+    active_ = true;
+    tag_ = tag;
+    lastReceived_ = false;
+    received_ = 0;
+    padded_ = 0;
+    chunkPayload_ = payload;
+    data_.clear();
+  }
+
+  const size_t offset = static_cast<size_t>(seq) * payload;
+  if (data_.size() < offset + dataLen) {
+    data_.resize(offset + dataLen, 0);          // пропуски заполняются нулями
+  }
+  std::memcpy(data_.data() + offset, data, dataLen);
+  received_ |= 1UL << seq;
+  if (pad) padded_ |= 1UL << seq;
+  lastSeq_ = seq;
+  lastChunkMs_ = nowMs;
+  if (last) {
+    lastReceived_ = true;
+    flush();
+  }
+  return true;
+}
+
+void Assembler::poll(uint32_t nowMs) {
+  if (active_ && static_cast<uint32_t>(nowMs - lastChunkMs_) > timeoutMs_) {
+    flush();
+  }
+}
+
+void Assembler::reset() {
+  active_ = false;
+  data_.clear();
+}
+
+void Assembler::flush() {
+  if (!active_) return;
+  active_ = false;
+  FrameInfo info;
+  info.chunks = static_cast<uint8_t>(lastSeq_ + 1);
+  const uint32_t expected = info.chunks >= 32 ? 0xFFFFFFFFUL : ((1UL << info.chunks) - 1UL);
+  info.missingMask = expected & ~received_;
+  info.paddedMask = padded_;
+  info.chunkPayload = chunkPayload_;
+  info.lastReceived = lastReceived_;
+  info.complete = lastReceived_ && info.missingMask == 0;
+  if (info.complete) {
+    ++completeFrames_;
+  } else {
+    ++partialFrames_;
+  }
+  if (handler_) {
+    handler_(data_.data(), data_.size(), info);
+  }
+  data_.clear();
+}
+
+} // namespace subpacket
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Разметка LoRa-пакетов внутри логического кадра радиоуровня.
+// Каждый пакет начинается с байта-маркера:
+//   бит 7 — метка кадра (чередуется от кадра к кадру),
+//   бит 6 — последний пакет кадра,
+//   бит 5 — за маркером следует байт длины данных, остаток пакета — заполнитель,
+//   биты 4..0 — номер пакета в кадре.
+// Все пакеты, кроме последнего, несут ровно chunkPayload() байт данных, поэтому позиция
+// потерянного пакета в кадре известна и может служить подсказкой стирания для декодера.
+namespace subpacket {
+
+constexpr uint8_t TAG_BIT = 0x80;              // метка кадра
+constexpr uint8_t LAST_BIT = 0x40;             // последний пакет кадра
+constexpr uint8_t PAD_BIT = 0x20;              // пакет дополнен, длина данных в следующем байте
+constexpr uint8_t SEQ_MASK = 0x1F;             // номер пакета
+constexpr size_t MAX_CHUNKS = SEQ_MASK + 1;    // предельное число пакетов в кадре
+constexpr size_t OVERHEAD = 1;                 // служебные байты каждого пакета
+
+// Объём данных в пакете размером packetSize байт
+inline size_t chunkPayload(size_t packetSize) {
+  return packetSize > OVERHEAD + 1 ? packetSize - OVERHEAD : 0;
+}
+
+// Число пакетов для кадра frameLen байт (0 — кадр не помещается в MAX_CHUNKS пакетов)
+size_t chunkCount(size_t frameLen, size_t packetSize);
+
+// Формирует пакет seq кадра frame в out (не меньше packetSize байт). При fixedLength пакет всегда
+// имеет длину packetSize (implicit-режим): короткий хвост помечается PAD_BIT и дополняется нулями.
+// Возвращает длину пакета либо 0 при некорректных параметрах.
+size_t buildChunk(const uint8_t* frame, size_t frameLen, size_t seq, size_t packetSize,
+                  bool fixedLength, bool tag, uint8_t* out);
+
+// Карта собранного кадра: какие пакеты потеряны или дополнены
+struct FrameInfo {
+  uint8_t chunks = 0;          // число пакетов кадра (при потере последнего — по старшему принятому)
+  uint32_t missingMask = 0;    // биты потерянных пакетов; их данные заполнены нулями
+  uint32_t paddedMask = 0;     // биты пакетов с заполнителем
+  size_t chunkPayload = 0;     // данные одного пакета: пакет i занимает [i·chunkPayload, (i+1)·chunkPayload)
+  bool lastReceived = false;   // получен последний пакет — длина кадра точная
+  bool complete = false;       // кадр собран без потерь
+};
+
+// Сборка кадров из пакетов с тайм-аутом ожидания следующего пакета
+class Assembler {
+public:
+  using FrameHandler = std::function<void(const uint8_t*, size_t, const FrameInfo&)>;
+
+  // Обработчик готовых (в том числе неполных) кадров
+  void setHandler(FrameHandler handler) { handler_ = std::move(handler); }
+  // Максимальная пауза между пакетами одного кадра
+  void setTimeout(uint32_t timeoutMs) { timeoutMs_ = timeoutMs; }
+  // Принять пакет; packetSize — ёмкость пакета при текущих настройках радио.
+  // Возвращает false, если пакет отброшен как некорректный.
+  bool push(const uint8_t* packet, size_t len, size_t packetSize, uint32_t nowMs);
+  // Отдать неполный кадр, если следующий пакет не пришёл за тайм-аут
+  void poll(uint32_t nowMs);
+  // Сброс незавершённого кадра без доставки
+  void reset();
+  // Идёт ли сборка кадра
+  bool pending() const { return active_; }
+
+  uint32_t getCompleteFrames() const { return completeFrames_; }
+  uint32_t getPartialFrames() const { return partialFrames_; }
+  uint32_t getDroppedChunks() const { return droppedChunks_; }
+
+private:
+  void flush();
+
+  FrameHandler handler_;
+  uint32_t timeoutMs_ = 1000;
+  std::vector<uint8_t> data_;  // буфер кадра; ёмкость сохраняется между кадрами
+  bool active_ = false;
+  bool tag_ = false;
+  bool lastReceived_ = false;
+  uint8_t lastSeq_ = 0;
+  uint32_t received_ = 0;
+  uint32_t padded_ = 0;
+  size_t chunkPayload_ = 0;
+  uint32_t lastChunkMs_ = 0;
+  uint32_t completeFrames_ = 0;
+  uint32_t partialFrames_ = 0;
+  uint32_t droppedChunks_ = 0;
+};
+
+} // namespace subpacket
@@ -55,17 +55,16 @@ void encode(const uint8_t* data, size_t len, std::vector<uint8_t>& out) {
   }
 }
 
-bool decode(const uint8_t* in, size_t len, std::vector<uint8_t>& out) {
-  init();
-  size_t total_bits = len*8;
-  if (total_bits %2 !=0) return false;
-  size_t steps = total_bits/2;
+// Общая часть декодера: symbol(t, r0, r1, v0, v1) возвращает принятые биты X/Y шага t
+// и признаки их наличия; стёртые (выколотые) биты не влияют на метрику ветви
+template <typename SymbolFn>
+static void decodeSteps(size_t steps, SymbolFn symbol, std::vector<uint8_t>& out) {
   std::array<uint16_t,STATES> metric, new_metric;
   metric.fill(std::numeric_limits<uint16_t>::max()/2); metric[0]=0;
   std::vector<uint8_t> decisions(steps*STATES);
   for (size_t t=0;t<steps;t++) {
-    uint8_t r0 = get_bit(in,2*t);
-    uint8_t r1 = get_bit(in,2*t+1);
+    uint8_t r0 = 0, r1 = 0, v0 = 1, v1 = 1;
+    symbol(t, r0, r1, v0, v1);
     new_metric.fill(std::numeric_limits<uint16_t>::max()/2);
     for (int s=0;s<STATES;s++) {
       uint16_t pm = metric[s];
@@ -73,7 +72,7 @@ bool decode(const uint8_t* in, size_t len, std::vector<uint8_t>& out) {
       for (int b=0;b<2;b++) {
         Trans tr = trans[s*2 + b];
         uint8_t eo0 = tr.out>>1; uint8_t eo1 = tr.out&1;
-        uint16_t br = (r0!=eo0) + (r1!=eo1);
+        uint16_t br = (v0 && r0!=eo0) + (v1 && r1!=eo1);
         uint16_t m = pm + br;
         int ns = tr.next;
         if (m < new_metric[ns]) {
@@ -96,6 +95,71 @@ bool decode(const uint8_t* in, size_t len, std::vector<uint8_t>& out) {
   out.resize((steps+7)/8);
   std::memset(out.data(),0,out.size());
   for (size_t i=0;i<steps;i++) out[i>>3]|=bits[i]<<(7-(i&7));
+}
+
+bool decode(const uint8_t* in, size_t len, std::vector<uint8_t>& out) {
+  init();
+  size_t total_bits = len*8;
+  if (total_bits %2 !=0) return false;
+  size_t steps = total_bits/2;
+  decodeSteps(steps, [in](size_t t, uint8_t& r0, uint8_t& r1, uint8_t&, uint8_t&) {
+    r0 = get_bit(in,2*t);
+    r1 = get_bit(in,2*t+1);
+  }, out);
+  return true;
+}
+
+size_t puncturedBits(size_t steps, const uint8_t* mask, size_t period) {
+  if (!mask || period == 0) return steps*2;
+  size_t kept_per_period = 0;
+  for (size_t i=0;i<period*2;i++) kept_per_period += mask[i] ? 1 : 0;
+  size_t bits = (steps/period)*kept_per_period;
+  for (size_t i=0;i<(steps%period)*2;i++) bits += mask[i] ? 1 : 0;
+  return bits;
+}
+
+void encodePunctured(const uint8_t* data, size_t len, const uint8_t* mask, size_t period,
+                     std::vector<uint8_t>& out) {
+  if (!mask || period == 0) {
+    encode(data, len, out);
+    return;
+  }
+  std::vector<uint8_t> full;
+  encode(data, len, full);
+  const size_t steps = len*8;
+  out.assign((puncturedBits(steps, mask, period)+7)/8, 0);
+  size_t pos = 0;
+  for (size_t i=0;i<steps*2;i++) {
+    if (!mask[i % (period*2)]) continue;           // бит выколот и в эфир не уходит
+    out[pos>>3] |= get_bit(full.data(), i) << (7-(pos&7));
+    ++pos;
+  }
+}
+
+bool decodePunctured(const uint8_t* in, size_t len, size_t out_len, const uint8_t* mask, size_t period,
+                     std::vector<uint8_t>& out) {
+  init();
+  const size_t steps = out_len*8;
+  if (!mask || period == 0 || (puncturedBits(steps, mask, period)+7)/8 != len) return false;
+  // Восстанавливаем пары X/Y, выколотые позиции помечаем стиранием
+  std::vector<uint8_t> rx(steps*2, 0);
+  std::vector<uint8_t> valid(steps*2, 0);
+  size_t pos = 0;
+  for (size_t i=0;i<steps*2;i++) {
+    if (!mask[i % (period*2)]) continue;
+    rx[i] = get_bit(in, pos++);
+    valid[i] = 1;
+  }
+  return decodeErasures(rx.data(), valid.data(), steps, out);
+}
+
+bool decodeErasures(const uint8_t* bits, const uint8_t* valid, size_t steps, std::vector<uint8_t>& out) {
+  init();
+  if (!bits || !valid || steps == 0) return false;
+  decodeSteps(steps, [&](size_t t, uint8_t& r0, uint8_t& r1, uint8_t& v0, uint8_t& v1) {
+    r0 = bits[2*t]; r1 = bits[2*t+1];
+    v0 = valid[2*t]; v1 = valid[2*t+1];
+  }, out);
   return true;
 }
 
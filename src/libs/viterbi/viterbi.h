@@ -11,5 +11,17 @@ void encode(const uint8_t* data, size_t len, std::vector<uint8_t>& out);
 // Декодирование с мягкими решениями (0..255), len должен быть чётным
 bool decode(const uint8_t* in, size_t len, std::vector<uint8_t>& out);
 
+// Прокалывание: mask — 2*period признаков передачи бит X/Y (171/133) на шаге периода.
+// Неполный период в конце потока использует начало шаблона
+size_t puncturedBits(size_t steps, const uint8_t* mask, size_t period);
+void encodePunctured(const uint8_t* data, size_t len, const uint8_t* mask, size_t period,
+                     std::vector<uint8_t>& out);
+// Декодирование с подстановкой стираний на выколотые позиции; out_len — длина исходных данных
+bool decodePunctured(const uint8_t* in, size_t len, size_t out_len, const uint8_t* mask, size_t period,
+                     std::vector<uint8_t>& out);
+// Декодирование по распакованным битам материнского кода (X0 Y0 X1 Y1 ...); valid[i] == 0 —
+// бит не принят и считается стиранием. steps — число входных бит
+bool decodeErasures(const uint8_t* bits, const uint8_t* valid, size_t steps, std::vector<uint8_t>& out);
+
 }
 
@@ -1,13 +1,25 @@
 // Этот файл подключает реализации библиотек, чтобы Arduino-сборка видела их определения
 #include "libs/packetizer/packet_splitter.cpp"
 #include "libs/packetizer/packet_gatherer.cpp"     // собиратель пакетов
+#include "libs/airtime/lora_airtime.cpp"         // расчёт времени LoRa-кадра в эфире
+#include "libs/airtime/airtime_pacer.cpp"        // планирование пауз по времени в эфире
+#include "libs/fragment_planner/fragment_planner.cpp" // размер фрагментов по времени в эфире
+#include "libs/link_adapt/link_adapter.cpp"      // адаптация SF/CR/FEC по качеству канала
+#include "libs/subpacket/subpacket.cpp"          // разметка и сборка LoRa-пакетов кадра
 #include "libs/frame/frame_header.cpp"
+#include "libs/frame/delta_header.cpp"            // сжатые дельта-заголовки фрагментов
 #include "libs/text_converter/text_converter.cpp"
 #include "libs/rs/rs.cpp"            // базовая реализация RS(255,223)
 #include "libs/rs255223/rs255223.cpp" // обёртки encode/decode
 #include "libs/byte_interleaver/byte_interleaver.cpp" // байтовый интерливинг
 #include "libs/viterbi/viterbi.cpp"                  // сверточный кодер
 #include "libs/conv_codec/conv_codec.cpp"           // обёртки encodeBits/viterbiDecode
+#include "libs/harq/harq.cpp"                       // версии избыточности HARQ и их объединение
+#include "libs/chase/chase_combiner.cpp"            // Chase-комбинирование повторов кадра
+#include "libs/erasure/erasure_code.cpp"            // внешний код стираний по фрагментам
+#include "libs/frame_interleaver/frame_interleaver.cpp" // межкадровый интерливинг
+#include "libs/jpeg_uep/jpeg_uep.cpp"               // неравная защита частей JPEG
+#include "libs/lzss/lzss.cpp"                       // сжатие коротких текстов
 #include "libs/bit_interleaver/bit_interleaver.cpp" // битовый интерливинг
 #include "libs/scrambler/scrambler.cpp"             // скремблер
 #include "libs/simple_logger/simple_logger.cpp"     // журнал статусов
@@ -15,6 +15,7 @@
 #include "radio_sx1262.h"
 #include "tx_module.h"
 #include "rx_module.h" //  
+#include "channel_scanner.h" // фоновый обход каналов для SEAR
 #include "default_settings.h"
 #include "libs/config_loader/config_loader.h" //    
 
@@ -30,6 +31,9 @@
 #include "libs/key_transfer/key_transfer.h"       //     LoRa
 #include "libs/key_transfer_waiter/key_transfer_waiter.h" //    KEYTRANSFER
 #include "libs/protocol/ack_utils.h"              //  ACK-
+#include "libs/protocol/link_control.h"           // анонс ступени адаптации канала
+#include "libs/protocol/nack_utils.h"             // запрос избыточности HARQ
+#include "libs/link_adapt/link_adapter.h"         // выбор SF/CR/FEC по SNR и PER
 #include "key_safe_mode.h"                        //     
 #include "sse_buffered_writer.h"                  //   SSE-
 #include "rx_serial_dump.h"                       //   RX-  Serial
@@ -117,6 +121,10 @@ struct TestRxmSpec;
 
 //     Serial c   
 RadioSX1262 radio;
+// SX1262 даунлинка для дуплексного режима; без USE_DUAL_RADIO приём идёт на основном радио
+RadioSX1262 downlinkRadio(DefaultSettings::DOWNLINK_RADIO_CS_PIN, DefaultSettings::DOWNLINK_RADIO_IRQ_PIN,
+                          DefaultSettings::DOWNLINK_RADIO_RST_PIN, DefaultSettings::DOWNLINK_RADIO_BUSY_PIN);
+RadioSX1262& rxRadio = DefaultSettings::USE_DUAL_RADIO ? downlinkRadio : radio;
 //     160 ,      5000 
 TxModule tx(radio, std::array<size_t,4>{
   DefaultSettings::TX_QUEUE_CAPACITY,
@@ -124,6 +132,22 @@ TxModule tx(radio, std::array<size_t,4>{
   DefaultSettings::TX_QUEUE_CAPACITY,
   DefaultSettings::TX_QUEUE_CAPACITY});
 RxModule rx;                //  
+ChannelScanner channelScanner(radio, tx); // таблица SEAR, обновляемая без блокировки loop()
+link_adapt::LinkAdapter linkAdapter;       // адаптация профиля канала по качеству приёма
+bool linkAdaptEnabled = DefaultSettings::USE_LINK_ADAPTATION; // включена ли адаптация
+bool jpegUepEnabled = DefaultSettings::USE_JPEG_UEP;          // неравная защита изображений JPEG
+// Профиль, заданный вручную или конфигурацией, и последний применённый адаптацией
+struct LinkAdaptState {
+  bool initialized = false;
+  int baseSf = 0;
+  int baseCr = 0;
+  int appliedSf = 0;
+  int appliedCr = 0;
+  uint8_t appliedRung = 0;
+  uint32_t ackSuccessSeen = 0;
+  uint32_t ackTimeoutSeen = 0;
+};
+LinkAdaptState linkState;
 ReceivedBuffer recvBuf;     //   
 static const ConfigLoader::Config& gConfig = ConfigLoader::getConfig(); //  
 bool ackEnabled = gConfig.radio.useAck; //    ACK
@@ -1819,11 +1843,19 @@ String cmdKeyTransferReceiveLora(KeyTransferCommandOrigin origin) {
   return makeKeyTransferWaitingJson();
 }
 
+// Разбор принятых пакетов: в дуплексном режиме кадры приходят с радио даунлинка
+static void serviceRadios() {
+  radio.loop();
+  if (&rxRadio != &radio) {
+    rxRadio.loop();
+  }
+}
+
 //     KEYTRANSFER  loop()
 void processKeyTransferReceiveState() {
   if (keyTransferRuntime.waiting) {
     //     , TX  push-,    .
-    radio.loop();
+    serviceRadios();
     rx.tickCleanup();
     tx.loop();
     maintainPushSessions();
@@ -2201,6 +2233,9 @@ String cmdTestRxm() {
 
 //      
 String cmdPing() {
+  if (channelScanner.isProbing()) {
+    return String("Ping: radio busy");             // радио сейчас на канале, который проверяет SEAR
+  }
   std::array<uint8_t, DefaultSettings::PING_PACKET_SIZE> ping{};
   ping[1] = radio.randomByte();
   ping[2] = radio.randomByte();
@@ -2245,47 +2280,48 @@ String cmdPing() {
   }
 }
 
-//     
+// Таблица SEAR из кэша сканера. Устаревшая таблица обновляется в фоне, ответ не ждёт эфира
 String cmdSear() {
-  uint8_t prevCh = radio.getChannel();
-  String out;
-  for (int ch = 0; ch < radio.getBankSize(); ++ch) {
-    if (!radio.setChannel(ch)) {
-      out += "CH "; out += String(ch); out += ": \n";
-      continue;
-    }
-    ReceivedBuffer::Item d;
-    while (recvBuf.popReady(d)) {}
-    std::array<uint8_t, DefaultSettings::PING_PACKET_SIZE> pkt{};
-    pkt[1] = radio.randomByte();
-    pkt[2] = radio.randomByte();
-    pkt[0] = pkt[1] ^ pkt[2];
-    pkt[3] = 0; pkt[4] = 0;
-    std::array<uint8_t, DefaultSettings::PING_PACKET_SIZE> resp{};
-    size_t respLen = 0;
-    uint32_t elapsed = 0;
-    tx.prepareExternalSend();
-    int16_t pingState = radio.ping(pkt.data(), pkt.size(),
-                                   resp.data(), resp.size(),
-                                   respLen, DefaultSettings::PING_WAIT_MS * 1000UL,
-                                   elapsed);
-    tx.completeExternalSend();
-    (void)respLen; //      
-    (void)elapsed; //     
-    if (pingState == IRadio::ERR_NONE) {
-      out += "CH "; out += String(ch); out += ": RSSI ";
-      out += String(radio.getLastRssi()); out += " SNR ";
-      out += String(radio.getLastSnr()); out += "\n";
-    } else if (pingState == RadioSX1262::ERR_TIMEOUT) {
-      out += "CH "; out += String(ch); out += ":  \n";
-    } else if (pingState == RadioSX1262::ERR_PING_TIMEOUT) {
-      out += "CH "; out += String(ch); out += ": -\n";
-    } else {
-      out += "CH "; out += String(ch); out += ": err=";
-      out += String(pingState); out += "\n";
+  if (!channelScanner.hasResults() || channelScanner.bank() != radio.getBank() ||
+      channelScanner.resultAgeMs() >= DefaultSettings::SEAR_CACHE_MS) {
+    channelScanner.start();                          // во время обхода вызов игнорируется
+  }
+  String out = "SEAR: ";
+  if (channelScanner.isRunning()) {
+    out += "scanning ";
+    out += String(static_cast<unsigned>(channelScanner.progress()));
+    out += "/";
+    out += String(static_cast<unsigned>(channelScanner.size()));
+  } else {
+    out += "ready age ";
+    out += String(channelScanner.resultAgeMs() / 1000UL);
+    out += "s";
+  }
+  out += "\n";
+  const uint32_t now = millis();
+  for (size_t ch = 0; ch < channelScanner.size(); ++ch) {
+    const ChannelScanner::Entry& e = channelScanner.entry(ch);
+    out += "CH "; out += String(static_cast<unsigned>(ch)); out += ": ";
+    switch (e.status) {
+      case ChannelScanner::Status::ALIVE:
+        out += "RSSI "; out += String(e.rssi);
+        out += " SNR "; out += String(e.snr);
+        out += " RTT "; out += String(e.rttUs * 0.001f);
+        out += "ms seen "; out += String((now - e.lastSeenMs) / 1000UL); out += "s";
+        break;
+      case ChannelScanner::Status::NO_RESPONSE:
+        out += e.skipped ? "- cad idle" : "-";
+        break;
+      case ChannelScanner::Status::ERROR:
+        out += "err="; out += String(e.lastError);
+        break;
+      default:
+        out += "?";                                  // канал ещё не проверен
+        break;
     }
+    if (e.cadActivity) out += " cad busy";
+    out += "\n";
   }
-  radio.setChannel(prevCh);
   return out;
 }
 
@@ -2328,6 +2364,146 @@ String lightPackStateText() {
   return lightPackMode ? String("LIGHT:1") : String("LIGHT:0");
 }
 
+// Состояние пейсинга по времени в эфире для ответов команд PACE
+String airtimePacingText() {
+  return tx.isAirtimePacingEnabled() ? String("PACE:AIR") : String("PACE:FIX");
+}
+
+// Состояние проверки канала перед передачей для ответов команд LBT
+String listenBeforeTalkText() {
+  return tx.isListenBeforeTalkEnabled() ? String("LBT:1") : String("LBT:0");
+}
+
+// Состояние адаптации канала для ответов команд ADAPT
+String adaptText() {
+  return linkAdaptEnabled ? String("ADAPT:1") : String("ADAPT:0");
+}
+
+// Состояние HARQ для ответов команд HARQ
+String harqText() {
+  return tx.isHarqEnabled() ? String("HARQ:1") : String("HARQ:0");
+}
+
+// Состояние агрегации коротких сообщений для ответов команд AGG
+String aggText() {
+  return tx.isAggregationEnabled() ? String("AGG:1") : String("AGG:0");
+}
+
+// Состояние сжатия «сырых» кадров для ответов команд CMPR
+String cmprText() {
+  return tx.isCompressionEnabled() ? String("CMPR:1") : String("CMPR:0");
+}
+
+// Состояние планировщика фрагментов по времени в эфире для ответов команд AIRT
+String airtText() {
+  return tx.isAirtimePlanningEnabled() ? String("AIRT:1") : String("AIRT:0");
+}
+
+// Оценка времени передачи сообщения длиной len для ответов команд ETA:
+// raw — одним «сырым» кадром, framed — фрагментами по плану планировщика
+String etaText(size_t len) {
+  const fragment_planner::Plan plan = tx.planFragments(len);
+  String s = "ETA:bytes="; s += String(static_cast<uint32_t>(len));
+  s += " raw_ms="; s += String(static_cast<uint32_t>((tx.predictAirtimeUs(len, false) + 999) / 1000));
+  s += " framed_ms="; s += String(static_cast<uint32_t>((tx.predictAirtimeUs(len, true) + 999) / 1000));
+  s += " frags="; s += String(static_cast<uint32_t>(plan.count));
+  s += " chunk="; s += String(static_cast<uint32_t>(plan.chunk));
+  return s;
+}
+
+// Состояние дельта-заголовков фрагментов для ответов команд DHDR
+String dhdrText() {
+  return tx.isDeltaHeadersEnabled() ? String("DHDR:1") : String("DHDR:0");
+}
+
+// Состояние неравной защиты JPEG для ответов команд UEP
+String uepText() {
+  return jpegUepEnabled ? String("UEP:1") : String("UEP:0");
+}
+
+// Базовая ступень — текущий профиль радио; статистика адаптера сбрасывается
+static void rebaseLinkAdaptation() {
+  linkState.baseSf = radio.getSpreadingFactor();
+  linkState.baseCr = radio.getCodingRate();
+  linkState.appliedSf = linkState.baseSf;
+  linkState.appliedCr = linkState.baseCr;
+  const uint8_t base = link_adapt::matchRung(static_cast<uint8_t>(linkState.baseSf),
+                                             static_cast<uint8_t>(linkState.baseCr),
+                                             fec::currentProfile().use_conv);
+  linkAdapter.reset(base);
+  linkState.appliedRung = base;
+  linkState.ackSuccessSeen = tx.getAckSuccessCount();
+  linkState.ackTimeoutSeen = tx.getAckTimeoutCount();
+  linkState.initialized = true;
+  tx.clearFecOverride();
+}
+
+// Перевод радио и TxModule на ступень; базовая возвращает профиль конфигурации
+static void applyLinkRung(uint8_t rung) {
+  int sf = linkState.baseSf;
+  int cr = linkState.baseCr;
+  if (rung == linkAdapter.baseRung()) {
+    tx.clearFecOverride();
+  } else {
+    const link_adapt::Profile& p = link_adapt::profile(rung);
+    sf = p.spreadingFactor;
+    cr = p.codingRateDenom;
+    fec::Profile fecProfile;
+    fecProfile.use_conv = p.conv;
+    fecProfile.use_rs = p.rs;
+    fecProfile.use_bit_interleaver = p.bitInterleaver;
+    fecProfile.frame_interleave = p.frameInterleave;
+    tx.setFecOverride(fecProfile);
+  }
+  if (radio.getSpreadingFactor() != sf && !radio.setSpreadingFactor(sf)) {
+    LOG_WARN("LinkAdapter: SF %d не применён", sf);
+  }
+  if (radio.getCodingRate() != cr && !radio.setCodingRate(cr)) {
+    LOG_WARN("LinkAdapter: CR %d не применён", cr);
+  }
+  linkState.appliedSf = radio.getSpreadingFactor();
+  linkState.appliedCr = radio.getCodingRate();
+  linkState.appliedRung = rung;
+}
+
+// Шаг адаптации канала: итоги ACK, пересчёт ступени, анонс пиру и смена профиля
+static void serviceLinkAdaptation() {
+  if (!linkAdaptEnabled || channelScanner.isProbing()) return;
+  if (!linkState.initialized ||
+      radio.getSpreadingFactor() != linkState.appliedSf ||
+      radio.getCodingRate() != linkState.appliedCr) {
+    rebaseLinkAdaptation();                 // SF/CR сменили вручную — это новая база
+  }
+  const uint32_t ackOk = tx.getAckSuccessCount();
+  const uint32_t ackLost = tx.getAckTimeoutCount();
+  for (; linkState.ackSuccessSeen != ackOk; ++linkState.ackSuccessSeen) linkAdapter.onAckResult(true);
+  for (; linkState.ackTimeoutSeen != ackLost; ++linkState.ackTimeoutSeen) linkAdapter.onAckResult(false);
+  if (linkAdapter.update(millis())) {
+    // Анонс уходит на прежнем профиле, чтобы пир его услышал
+    uint8_t ctrl[protocol::link::SIZE];
+    protocol::link::encodeControl(linkAdapter.localRung(), ctrl);
+    tx.prepareExternalSend();
+    const int16_t state = radio.send(ctrl, sizeof(ctrl));
+    tx.completeExternalSend();
+    if (state != IRadio::ERR_NONE) {
+      LOG_WARN("LinkAdapter: анонс не отправлен, код=%d", static_cast<int>(state));
+    }
+  }
+  if (linkAdapter.appliedRung() != linkState.appliedRung) {
+    applyLinkRung(linkAdapter.appliedRung());
+  }
+}
+
+// Включение и выключение адаптации; при выключении восстанавливается базовый профиль
+static void setLinkAdaptation(bool enabled) {
+  if (linkAdaptEnabled == enabled) return;
+  if (!enabled && linkState.initialized) {
+    applyLinkRung(linkAdapter.baseRung());
+  }
+  linkAdaptEnabled = enabled;
+  linkState.initialized = false;
+}
+
 //       
 bool enqueueTextMessage(const String& payload, uint32_t& outId, String& err) {
   String trimmed = payload;
@@ -2366,7 +2542,8 @@ bool enqueueBinaryMessage(const uint8_t* data, size_t len, uint32_t& outId, Stri
     return false;
   }
   tx.setPayloadMode(PayloadMode::LARGE);                    //     
-  uint32_t id = tx.queue(data, len);
+  uint32_t id = jpegUepEnabled ? tx.queueImage(data, len, DefaultSettings::TX_BULK_QOS)
+                               : tx.queue(data, len, DefaultSettings::TX_BULK_QOS);
   tx.setPayloadMode(PayloadMode::SMALL);                    //   
   if (id == 0) {
     err = " ";
@@ -2425,7 +2602,7 @@ String cmdTxl(size_t sz) {
     data[i] = static_cast<uint8_t>(i & 0xFF);
   }
   tx.setPayloadMode(PayloadMode::LARGE);
-  uint32_t id = tx.queue(data.data(), data.size());
+  uint32_t id = tx.queue(data.data(), data.size(), DefaultSettings::TX_BULK_QOS);
   tx.setPayloadMode(PayloadMode::SMALL);
   if (id == 0) {
     return String("TXL:  ");
@@ -2547,7 +2724,62 @@ String cmdInfo() {
   s += "\nSF: "; s += String(radio.getSpreadingFactor());
   s += "\nCR: "; s += String(radio.getCodingRate());
   s += "\nPower: "; s += String(radio.getPower()); s += " dBm";
+  if (&rxRadio != &radio) {                // дуплекс: состояние каждой половины пары
+    s += "\nDuplex: full";
+    s += "\nUplink: TX "; s += String(radio.getTxFrequency(), 3); s += " MHz, ";
+    s += radio.isTransmitting() ? "transmitting" : "standby";
+    s += radio.isTaskRunning() ? ", task" : ", loop";
+    s += "\nDownlink: RX "; s += String(rxRadio.getRxFrequency(), 3); s += " MHz, BW ";
+    s += String(rxRadio.getBandwidth(), 2); s += " kHz, SF "; s += String(rxRadio.getSpreadingFactor());
+    s += ", CR "; s += String(rxRadio.getCodingRate());
+    s += ", RSSI "; s += String(rxRadio.getLastRssi()); s += " dBm, SNR "; s += String(rxRadio.getLastSnr()); s += " dB";
+    s += rxRadio.isTaskRunning() ? ", task" : ", loop";
+  } else {
+    s += "\nDuplex: half";
+  }
   s += "\nPause: "; s += String(tx.getSendPause()); s += " ms";
+  s += "\nPacing: "; s += tx.isAirtimePacingEnabled() ? "airtime" : "fixed";
+  s += "\nFrame airtime: "; s += String(tx.getLastAirtimeUs() / 1000.0f, 1); s += " ms";
+  s += "\nNext gap: "; s += String(tx.getEffectivePause()); s += " ms";
+  s += "\nLBT: "; s += tx.isListenBeforeTalkEnabled() ? "on" : "off";
+  s += " (clear "; s += String(tx.getLbtClearCount());
+  s += ", busy "; s += String(tx.getLbtBusyCount());
+  s += ", forced "; s += String(tx.getLbtForcedCount()); s += ")";
+  s += "\nLink adapt: ";
+  if (linkAdaptEnabled) {
+    s += "on, rung "; s += String(linkAdapter.appliedRung());
+    s += "/"; s += String(static_cast<unsigned>(link_adapt::rungCount() - 1));
+    s += " (local "; s += String(linkAdapter.localRung());
+    s += ", peer "; s += linkAdapter.peerSeen() ? String(linkAdapter.peerRung()) : String("-");
+    s += ", base "; s += String(linkAdapter.baseRung());
+    s += "), SNR "; s += String(linkAdapter.snr(), 1);
+    s += " dB, PER "; s += String(linkAdapter.per(), 2);
+  } else {
+    s += "off";
+  }
+  s += "\nHARQ: "; s += tx.isHarqEnabled() ? "on" : "off";
+  s += " (redundancy "; s += String(tx.getHarqRedundancyCount()); s += ")";
+  s += "\nOuter FEC: "; s += String(tx.getOuterFec());
+  s += "% (repair "; s += String(tx.getRepairFragmentCount()); s += ")";
+  s += "\nAggregation: "; s += tx.isAggregationEnabled() ? "on" : "off";
+  s += " (tx "; s += String(tx.getAggregatedCount());
+  s += " msgs, rx "; s += String(rx.aggregateRecordCount());
+  s += " in "; s += String(rx.aggregateFrameCount()); s += " frames)";
+  s += "\nCompression: "; s += tx.isCompressionEnabled() ? "on" : "off";
+  s += " (tx "; s += String(tx.getCompressedCount());
+  s += " frames, saved "; s += String(tx.getCompressionSavedBytes());
+  s += " B, rx "; s += String(rx.decompressedCount()); s += ")";
+  s += "\nAirtime planner: "; s += tx.isAirtimePlanningEnabled() ? "on" : "off";
+  s += "\nDelta headers: "; s += tx.isDeltaHeadersEnabled() ? "on" : "off";
+  s += " (saved "; s += String(tx.getHeaderBytesSaved()); s += " B)";
+  s += "\nJPEG UEP: "; s += jpegUepEnabled ? "on" : "off";
+  s += " (header copies "; s += String(tx.getUepCopyCount()); s += ")";
+  s += "\nTX queues: "; s += String(static_cast<uint32_t>(tx.getQueueUsedBytes()));
+  s += "/"; s += String(static_cast<uint32_t>(tx.getQueueBudgetBytes())); s += " B";
+  s += " (submit rejected "; s += String(tx.getSubmitRejectedCount());
+  s += ", lost "; s += String(tx.getSubmitLostCount()); s += ")";
+  s += "\nDuty budget: "; s += String(tx.getAirtimeBudgetLeftMs());
+  s += "/"; s += String(tx.getAirtimeBudgetMs()); s += " ms ("; s += String(tx.getDutyCycle()); s += "%)";
   s += "\nACK timeout: "; s += String(tx.getAckTimeout()); s += " ms";
   s += "\nACK delay: "; s += String(ackResponseDelayMs); s += " ms";
   s += "\nACK: "; s += ackEnabled ? "" : "";
@@ -2716,6 +2948,31 @@ String cmdRxstat() {
       out += "\n";
     }
   }
+  out += "TX airtime: ";
+  out += String(static_cast<unsigned long>(tx.getLastAirtimeUs()));
+  out += " us, budget left ";
+  out += String(static_cast<unsigned long>(tx.getAirtimeBudgetLeftMs()));
+  out += "/";
+  out += String(static_cast<unsigned long>(tx.getAirtimeBudgetMs()));
+  out += " ms\n";
+  out += "TX LBT: ";
+  out += tx.isListenBeforeTalkEnabled() ? "on" : "off";
+  out += ", clear=";
+  out += String(static_cast<unsigned long>(tx.getLbtClearCount()));
+  out += " busy=";
+  out += String(static_cast<unsigned long>(tx.getLbtBusyCount()));
+  out += " forced=";
+  out += String(static_cast<unsigned long>(tx.getLbtForcedCount()));
+  out += "\n";
+  out += "RX frames: complete=";
+  out += String(static_cast<unsigned long>(rxRadio.getCompleteFrames()));
+  out += " partial=";
+  out += String(static_cast<unsigned long>(rxRadio.getPartialFrames()));
+  out += " bad chunks=";
+  out += String(static_cast<unsigned long>(rxRadio.getDroppedChunks()));
+  out += " ring overflows=";
+  out += String(static_cast<unsigned long>(rxRadio.getRxRingOverflows()));
+  out += "\n";
   return out;
 }
 
@@ -2781,7 +3038,35 @@ String cmdRxstatJson() {
     out += String(static_cast<unsigned long>(item.age_ms));
     out += '}';
   }
-  out += "]}";
+  out += "],\"txAirtime\":{\"lastUs\":";
+  out += String(static_cast<unsigned long>(tx.getLastAirtimeUs()));
+  out += ",\"gapMs\":";
+  out += String(static_cast<unsigned long>(tx.getEffectivePause()));
+  out += ",\"budgetLeftMs\":";
+  out += String(static_cast<unsigned long>(tx.getAirtimeBudgetLeftMs()));
+  out += ",\"budgetMs\":";
+  out += String(static_cast<unsigned long>(tx.getAirtimeBudgetMs()));
+  out += ",\"dutyCycle\":";
+  out += String(static_cast<unsigned long>(tx.getDutyCycle()));
+  out += ",\"pacing\":\"";
+  out += tx.isAirtimePacingEnabled() ? "airtime" : "fixed";
+  out += "\"},\"txLbt\":{\"enabled\":";
+  out += tx.isListenBeforeTalkEnabled() ? "true" : "false";
+  out += ",\"clear\":";
+  out += String(static_cast<unsigned long>(tx.getLbtClearCount()));
+  out += ",\"busy\":";
+  out += String(static_cast<unsigned long>(tx.getLbtBusyCount()));
+  out += ",\"forced\":";
+  out += String(static_cast<unsigned long>(tx.getLbtForcedCount()));
+  out += "},\"rxFrames\":{\"complete\":";
+  out += String(static_cast<unsigned long>(rxRadio.getCompleteFrames()));
+  out += ",\"partial\":";
+  out += String(static_cast<unsigned long>(rxRadio.getPartialFrames()));
+  out += ",\"badChunks\":";
+  out += String(static_cast<unsigned long>(rxRadio.getDroppedChunks()));
+  out += ",\"ringOverflows\":";
+  out += String(static_cast<unsigned long>(rxRadio.getRxRingOverflows()));
+  out += "}}";
   return out;
 }
 
@@ -3245,6 +3530,108 @@ void handleCmdHttp() {
       tx.setAckRetryLimit(ackRetryLimit);
     }
     resp = String(ackRetryLimit);
+  } else if (cmd == "PACE") {
+    bool pacing = tx.isAirtimePacingEnabled();
+    if (server.hasArg("toggle")) {
+      pacing = !pacing;
+    } else if (server.hasArg("v")) {
+      pacing = server.arg("v").toInt() != 0;
+    }
+    tx.setAirtimePacing(pacing);
+    resp = airtimePacingText();
+  } else if (cmd == "LBT") {
+    bool lbt = tx.isListenBeforeTalkEnabled();
+    if (server.hasArg("toggle")) {
+      lbt = !lbt;
+    } else if (server.hasArg("v")) {
+      lbt = server.arg("v").toInt() != 0;
+    }
+    tx.setListenBeforeTalk(lbt);
+    resp = listenBeforeTalkText();
+  } else if (cmd == "ADAPT") {
+    bool adapt = linkAdaptEnabled;
+    if (server.hasArg("toggle")) {
+      adapt = !adapt;
+    } else if (server.hasArg("v")) {
+      adapt = server.arg("v").toInt() != 0;
+    }
+    setLinkAdaptation(adapt);
+    resp = adaptText();
+  } else if (cmd == "HARQ") {
+    bool harq = tx.isHarqEnabled();
+    if (server.hasArg("toggle")) {
+      harq = !harq;
+    } else if (server.hasArg("v")) {
+      harq = server.arg("v").toInt() != 0;
+    }
+    tx.setHarqEnabled(harq);
+    resp = harqText();
+  } else if (cmd == "AGG") {
+    bool agg = tx.isAggregationEnabled();
+    if (server.hasArg("toggle")) {
+      agg = !agg;
+    } else if (server.hasArg("v")) {
+      agg = server.arg("v").toInt() != 0;
+    }
+    tx.setAggregationEnabled(agg);
+    resp = aggText();
+  } else if (cmd == "CMPR") {
+    bool cmpr = tx.isCompressionEnabled();
+    if (server.hasArg("toggle")) {
+      cmpr = !cmpr;
+    } else if (server.hasArg("v")) {
+      cmpr = server.arg("v").toInt() != 0;
+    }
+    tx.setCompressionEnabled(cmpr);
+    resp = cmprText();
+  } else if (cmd == "DHDR") {
+    bool dhdr = tx.isDeltaHeadersEnabled();
+    if (server.hasArg("toggle")) {
+      dhdr = !dhdr;
+    } else if (server.hasArg("v")) {
+      dhdr = server.arg("v").toInt() != 0;
+    }
+    tx.setDeltaHeaders(dhdr);
+    resp = dhdrText();
+  } else if (cmd == "AIRT") {
+    bool airt = tx.isAirtimePlanningEnabled();
+    if (server.hasArg("toggle")) {
+      airt = !airt;
+    } else if (server.hasArg("v")) {
+      airt = server.arg("v").toInt() != 0;
+    }
+    tx.setAirtimePlanning(airt);
+    resp = airtText();
+  } else if (cmd == "ETA") {
+    long len = server.hasArg("v") ? server.arg("v").toInt() : 0;
+    if (len <= 0) {
+      resp = "ETA:ERR";
+    } else {
+      resp = etaText(static_cast<size_t>(len));
+    }
+  } else if (cmd == "UEP") {
+    if (server.hasArg("toggle")) {
+      jpegUepEnabled = !jpegUepEnabled;
+    } else if (server.hasArg("v")) {
+      jpegUepEnabled = server.arg("v").toInt() != 0;
+    }
+    resp = uepText();
+  } else if (cmd == "OFEC") {
+    if (server.hasArg("v")) {
+      long raw = server.arg("v").toInt();
+      if (raw < 0) raw = 0;
+      if (raw > 100) raw = 100;
+      tx.setOuterFec(static_cast<uint8_t>(raw));
+    }
+    resp = String(tx.getOuterFec());
+  } else if (cmd == "DUTY") {
+    if (server.hasArg("v")) {
+      long raw = server.arg("v").toInt();
+      if (raw < 1) raw = 1;
+      if (raw > 100) raw = 100;
+      tx.setDutyCycle(static_cast<uint8_t>(raw));
+    }
+    resp = String(tx.getDutyCycle());
   } else if (cmd == "PAUSE") {
     if (server.hasArg("v")) {
       long raw = server.arg("v").toInt();
@@ -3592,6 +3979,17 @@ void setup() {
     LOG_ERROR("Wi-Fi: -    ");
   }
   //        ,     setup()
+  if (DefaultSettings::USE_DUAL_RADIO) {
+    // Дуплекс: основное радио только передаёт на TX-частоте, даунлинк постоянно слушает RX-частоту
+    radio.setRole(RadioSX1262::Role::UPLINK);
+    downlinkRadio.setRole(RadioSX1262::Role::DOWNLINK);
+    if (downlinkRadio.begin()) {
+      radio.setDuplexPeer(&downlinkRadio);           // смена канала и модема повторяется на даунлинке
+    } else {
+      LOG_ERROR_VAL("RadioSX1262: радио даунлинка не запущено, код=", downlinkRadio.getLastErrorCode());
+    }
+    tx.setFullDuplex(true);
+  }
   constexpr uint8_t kRadioInitAttempts = 3;
   bool radioReady = false;
   for (uint8_t attempt = 1; attempt <= kRadioInitAttempts; ++attempt) {
@@ -3609,6 +4007,11 @@ void setup() {
   if (!radioReady) {
     LOG_ERROR("RadioSX1262:   ,     ");
   }
+  // Дальше SX1262 обслуживает отдельная задача: HTTP, Serial и TxModule обращаются к ней командами
+  radio.startTask();
+  if (&rxRadio != &radio) {
+    rxRadio.startTask();
+  }
   tx.setAckEnabled(ackEnabled);
   tx.setAckRetryLimit(ackRetryLimit);
   tx.setSendPause(gConfig.radio.sendPauseMs);
@@ -3631,6 +4034,18 @@ void setup() {
     if (protocol::ack::isAckPayload(d, l)) {              // ACK    
       return;
     }
+    uint8_t peerRung = 0;
+    if (protocol::link::decodeControl(d, l, peerRung)) {  // анонс ступени адаптации: без ACK и вывода
+      linkAdapter.onPeerAdvert(peerRung, millis());
+      return;
+    }
+    protocol::nack::Request nack;
+    // Запрос следующей версии избыточности HARQ; сама прошивка NACK не шлёт — приём кадров с
+    // FrameHeader пока не декодирует фрагменты, запросы приходят от внешнего приёмника
+    if (protocol::nack::decode(d, l, nack)) {
+      tx.onNackReceived(nack.msg_id, nack.frag_idx, nack.rv);
+      return;
+    }
 #if defined(ARDUINO)
     if (rxSerialDumpEnabled && Serial) {                  //  ,  USB-  
       (void)dumpRxToSerialWithPrefix(Serial, d, l);       //     
@@ -3641,16 +4056,21 @@ void setup() {
     LOG_INFO("RX:   %u ", static_cast<unsigned>(l));
     if (ackEnabled) {                                     //  
       const uint8_t ack_msg[1] = {protocol::ack::MARKER};
-      tx.queue(ack_msg, sizeof(ack_msg));
-      tx.loop();
+      // Обработчик может работать в задаче радио: ACK уходит заявкой без блокировок,
+      // а в очередь класса и в эфир его переносит tx.loop() основного цикла
+      tx.submit(ack_msg, sizeof(ack_msg));
     }
   });
-  radio.setReceiveCallback([&](const uint8_t* d, size_t l){  //
+  rxRadio.setReceiveFrameCallback([&](const uint8_t* d, size_t l, const subpacket::FrameInfo& info){  // кадры, собранные из LoRa-пакетов
     // if (handleKeyTransferFrame(d, l)) return;             // KEYTRANSFER: обработка отключена
-    rx.onReceive(d, l);
+    linkAdapter.onRxFrame(rxRadio.getLastSnr(), rxRadio.getLastRssi(), info.complete, millis());
+    rx.onReceiveFrame(d, l, info);
   });
   radio.setIrqLogCallback(onRadioIrqLog);                    //  IRQ-  SSE    Serial
-  LOG_INFO(": BF <>, SF <>, CR <>, BANK <e|w|t|a|h|n>, CH <>, PW <0-9>, RXBG <0|1>, TX <>, TXL <>, BCN, INFO, STS <n>, RSTS <n>, RXS [n|JSON|RESET], RXSTAT, ACK [0|1], LIGHT [0|1], ACKR <>, PAUSE <>, ACKT <>, ACKD <>, ENC [0|1], PI, SEAR, TESTRXM, KEYTRANSFER SEND, KEYTRANSFER RECEIVE, KEYSTORE [auto|nvs]");
+  if (&rxRadio != &radio) {
+    rxRadio.setIrqLogCallback(onRadioIrqLog);
+  }
+  LOG_INFO(": BF <>, SF <>, CR <>, BANK <e|w|t|a|h|n>, CH <>, PW <0-9>, RXBG <0|1>, TX <>, TXL <>, BCN, INFO, STS <n>, RSTS <n>, RXS [n|JSON|RESET], RXSTAT, ACK [0|1], LIGHT [0|1], ACKR <>, PACE [0|1], LBT [0|1], ADAPT [0|1], HARQ [0|1], OFEC <0-100>, UEP [0|1], AGG [0|1], CMPR [0|1], DHDR [0|1], AIRT [0|1], ETA <bytes>, DUTY <1-100>, PAUSE <>, ACKT <>, ACKD <>, ENC [0|1], PI, SEAR, TESTRXM, KEYTRANSFER SEND, KEYTRANSFER RECEIVE, KEYSTORE [auto|nvs]");
 }
 
 void loop() {
@@ -3671,9 +4091,11 @@ void loop() {
     }
     serialWasReady = serialNowReady;
     if (!keyTransferRuntime.waiting) {
-      radio.loop();                         //   
+      serviceRadios();                      //   
       rx.tickCleanup();                     //    RX    
+      channelScanner.loop();                // шаг обхода каналов SEAR
       tx.loop();                            //   
+      serviceLinkAdaptation();              // выбор профиля канала и анонс пиру
     }
     processTestRxm();                       //    
     processKeyTransferReceiveState();       //    KEYTRANSFER
@@ -3972,7 +4394,7 @@ void loop() {
             data[i] = static_cast<uint8_t>(i);            //  
           }
           tx.setPayloadMode(PayloadMode::LARGE);          //    
-          uint32_t id = tx.queue(data.data(), data.size());
+          uint32_t id = tx.queue(data.data(), data.size(), DefaultSettings::TX_BULK_QOS);
           tx.setPayloadMode(PayloadMode::SMALL);          //    
           if (id != 0) {
             tx.loop();                                   //   
@@ -4057,6 +4479,110 @@ void loop() {
         tx.setAckRetryLimit(ackRetryLimit);
         Serial.print("ACKR: ");
         Serial.println(ackRetryLimit);
+      } else if (line.startsWith("PACE")) {
+        bool pacing = tx.isAirtimePacingEnabled();
+        if (line.length() > 4) {
+          pacing = line.substring(5).toInt() != 0;
+        } else {
+          pacing = !pacing;
+        }
+        tx.setAirtimePacing(pacing);
+        Serial.println(airtimePacingText());
+      } else if (line.startsWith("LBT")) {
+        bool lbt = tx.isListenBeforeTalkEnabled();
+        if (line.length() > 3) {
+          lbt = line.substring(4).toInt() != 0;
+        } else {
+          lbt = !lbt;
+        }
+        tx.setListenBeforeTalk(lbt);
+        Serial.println(listenBeforeTalkText());
+      } else if (line.startsWith("ADAPT")) {
+        bool adapt = linkAdaptEnabled;
+        if (line.length() > 5) {
+          adapt = line.substring(6).toInt() != 0;
+        } else {
+          adapt = !adapt;
+        }
+        setLinkAdaptation(adapt);
+        Serial.println(adaptText());
+      } else if (line.startsWith("HARQ")) {
+        bool harq = tx.isHarqEnabled();
+        if (line.length() > 4) {
+          harq = line.substring(5).toInt() != 0;
+        } else {
+          harq = !harq;
+        }
+        tx.setHarqEnabled(harq);
+        Serial.println(harqText());
+      } else if (line.startsWith("AGG")) {
+        bool agg = tx.isAggregationEnabled();
+        if (line.length() > 3) {
+          agg = line.substring(4).toInt() != 0;
+        } else {
+          agg = !agg;
+        }
+        tx.setAggregationEnabled(agg);
+        Serial.println(aggText());
+      } else if (line.startsWith("CMPR")) {
+        bool cmpr = tx.isCompressionEnabled();
+        if (line.length() > 4) {
+          cmpr = line.substring(5).toInt() != 0;
+        } else {
+          cmpr = !cmpr;
+        }
+        tx.setCompressionEnabled(cmpr);
+        Serial.println(cmprText());
+      } else if (line.startsWith("DHDR")) {
+        bool dhdr = tx.isDeltaHeadersEnabled();
+        if (line.length() > 4) {
+          dhdr = line.substring(5).toInt() != 0;
+        } else {
+          dhdr = !dhdr;
+        }
+        tx.setDeltaHeaders(dhdr);
+        Serial.println(dhdrText());
+      } else if (line.startsWith("AIRT")) {
+        bool airt = tx.isAirtimePlanningEnabled();
+        if (line.length() > 4) {
+          airt = line.substring(5).toInt() != 0;
+        } else {
+          airt = !airt;
+        }
+        tx.setAirtimePlanning(airt);
+        Serial.println(airtText());
+      } else if (line.startsWith("ETA")) {
+        long len = line.length() > 3 ? line.substring(4).toInt() : 0;
+        if (len <= 0) {
+          Serial.println("ETA:ERR");
+        } else {
+          Serial.println(etaText(static_cast<size_t>(len)));
+        }
+      } else if (line.startsWith("UEP")) {
+        if (line.length() > 3) {
+          jpegUepEnabled = line.substring(4).toInt() != 0;
+        } else {
+          jpegUepEnabled = !jpegUepEnabled;
+        }
+        Serial.println(uepText());
+      } else if (line.startsWith("OFEC")) {
+        long value = tx.getOuterFec();
+        if (line.length() > 4) value = line.substring(5).toInt();
+        if (value < 0) value = 0;
+        if (value > 100) value = 100;
+        tx.setOuterFec(static_cast<uint8_t>(value));
+        Serial.print("OFEC: ");
+        Serial.print(value);
+        Serial.println(" %");
+      } else if (line.startsWith("DUTY")) {
+        long value = tx.getDutyCycle();
+        if (line.length() > 4) value = line.substring(5).toInt();
+        if (value < 1) value = 1;
+        if (value > 100) value = 100;
+        tx.setDutyCycle(static_cast<uint8_t>(value));
+        Serial.print("DUTY: ");
+        Serial.print(value);
+        Serial.println(" %");
       } else if (line.startsWith("PAUSE")) {
         long value = tx.getSendPause();
         if (line.length() > 5) value = line.substring(6).toInt();
@@ -4107,6 +4633,8 @@ void loop() {
         }
         Serial.print("LIGHT: ");
         Serial.println(lightPackMode ? "" : "");
+      } else if (line.equalsIgnoreCase("PI") && channelScanner.isProbing()) {
+        Serial.println("Ping: radio busy");       // радио сейчас на канале, который проверяет SEAR
       } else if (line.equalsIgnoreCase("PI")) {
         //     
         ReceivedBuffer::Item dump;
@@ -4131,7 +4659,7 @@ void loop() {
 
         //  ,    
         while (micros() - t_start < DefaultSettings::PING_WAIT_MS * 1000UL) {
-          radio.loop();
+          serviceRadios();
           if (recvBuf.popReady(resp)) {
             if (resp.data.size() == ping.size() &&
                 memcmp(resp.data.data(), ping.data(), ping.size()) == 0) {
@@ -4159,57 +4687,7 @@ void loop() {
           Serial.println(": -");
         }
       } else if (line.equalsIgnoreCase("SEAR")) {
-        //        
-        uint8_t prevCh = radio.getChannel();         //   
-        for (int ch = 0; ch < radio.getBankSize(); ++ch) {
-          if (!radio.setChannel(ch)) {               // 
-            Serial.print("CH ");
-            Serial.print(ch);
-            Serial.println(": ");
-            continue;
-          }
-          //     
-          ReceivedBuffer::Item d;
-          while (recvBuf.popReady(d)) {}
-          //    
-          std::array<uint8_t, DefaultSettings::PING_PACKET_SIZE> pkt2{};
-          pkt2[1] = radio.randomByte();
-          pkt2[2] = radio.randomByte();         // ID 
-          pkt2[0] = pkt2[1] ^ pkt2[2];          // 
-          pkt2[3] = 0;
-          pkt2[4] = 0;
-          tx.queue(pkt2.data(), pkt2.size());
-          while (!tx.loop()) {                  //  
-            delay(1);
-          }
-          uint32_t t_start = micros();
-          bool ok_ch = false;
-          ReceivedBuffer::Item res;
-          while (micros() - t_start < DefaultSettings::PING_WAIT_MS * 1000UL) {
-            radio.loop();
-            if (recvBuf.popReady(res)) {
-              if (res.data.size() == pkt2.size() &&
-                  memcmp(res.data.data(), pkt2.data(), pkt2.size()) == 0) {
-                ok_ch = true;
-              }
-              break;
-            }
-            delay(1);
-          }
-          if (ok_ch) {
-            Serial.print("CH ");
-            Serial.print(ch);
-            Serial.print(": RSSI ");
-            Serial.print(radio.getLastRssi());
-            Serial.print(" SNR ");
-            Serial.println(radio.getLastSnr());
-          } else {
-            Serial.print("CH ");
-            Serial.print(ch);
-            Serial.println(": -");
-          }
-        }
-        radio.setChannel(prevCh);                    //   
+        Serial.print(cmdSear());                     // таблица из кэша, обход идёт в фоне
       }
     }
 }
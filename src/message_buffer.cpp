@@ -1,68 +1,168 @@
 #include "message_buffer.h"
 #include "default_settings.h"
+#include <algorithm>
 
 // Конструктор с заданной вместимостью и размером слота
 MessageBuffer::MessageBuffer(size_t capacity, size_t slot_size) {
   if (capacity == 0) {
     LOG_WARN("MessageBuffer: запрошена нулевая вместимость, используем минимум 1");
-    capacity = 1;                               // защищаемся от деления по модулю 0
+    capacity = 1;                               // очередь должна принимать хотя бы одно сообщение
   }
   if (slot_size == 0) {
     LOG_WARN("MessageBuffer: запрошен нулевой размер слота, используем минимум 1 байт");
     slot_size = 1;                              // исключаем невозможные размеры сообщений
   }
   capacity_ = capacity;
-  slot_size_ = slot_size;
-  slots_.resize(capacity_);
-  // Не пытаемся заранее выделить память под все слоты, чтобы не спровоцировать
-  // std::bad_alloc на устройствах с ограниченным ОЗУ (ESP32 и подобные).
+  budget_ = capacity * (slot_size + RECORD_HEADER);
+  // Арена не выделяется заранее, чтобы не спровоцировать std::bad_alloc на устройствах
+  // с ограниченным ОЗУ (ESP32 и подобные): она растёт при первых постановках.
 }
 
-// Добавление сообщения в буфер
-uint16_t MessageBuffer::enqueue(const uint8_t* data, size_t len) {
+bool MessageBuffer::fits(const uint8_t* data, size_t len) const {
   if (!data || len == 0) {                     // проверка входных данных
     DEBUG_LOG("MessageBuffer: пустой ввод");
-    return 0;
+    return false;
   }
-  if (len > slot_size_) {                      // защита от переполнения слота
-    DEBUG_LOG("MessageBuffer: размер сообщения превышает слот");
-    return 0;
+  if (len > slotSize()) {                      // сообщение длиннее всей арены
+    DEBUG_LOG("MessageBuffer: размер сообщения превышает бюджет очереди");
+    return false;
   }
-  if (size_ >= capacity_) {                    // проверка переполнения
+  if (count_ >= capacity_) {                   // проверка переполнения по числу сообщений
     DEBUG_LOG("MessageBuffer: переполнение");
+    return false;
+  }
+  if (RECORD_HEADER + len > freeBytes()) {
+    DEBUG_LOG("MessageBuffer: нет свободных байтов в арене");
+    return false;
+  }
+  return true;
+}
+
+uint16_t MessageBuffer::reserveId() {
+  uint16_t id = next_id_.load(std::memory_order_relaxed);
+  uint16_t next = 0;
+  do {
+    next = static_cast<uint16_t>(id + 1);
+    if (next == 0 || next >= 0x8000) {         // избегаем нулевого и ACK-диапазона
+      next = 1;
+    }
+  } while (!next_id_.compare_exchange_weak(id, next, std::memory_order_relaxed));
+  return id;
+}
+
+// Добавление сообщения в буфер
+uint16_t MessageBuffer::enqueue(const uint8_t* data, size_t len) {
+  if (!fits(data, len)) return 0;              // идентификатор не расходуется на отказ
+  return enqueue(data, len, reserveId());
+}
+
+uint16_t MessageBuffer::enqueue(const uint8_t* data, size_t len, uint16_t id) {
+  if (id == 0 || !fits(data, len)) return 0;
+  const size_t need = RECORD_HEADER + len;
+  size_t offset = 0;
+  if (!reserve(need, offset)) {
+    DEBUG_LOG("MessageBuffer: нет свободных байтов в арене");
     return 0;
   }
-  uint16_t id = next_id_;                      // текущий идентификатор
-  ++next_id_;
-  if (next_id_ == 0 || next_id_ >= 0x8000) {   // избегаем нулевого и ACK-диапазона
-    next_id_ = 1;
-  }
-  Slot& slot = slots_[tail_];
-  slot.id = id;
-  slot.data.assign(data, data + len);          // наполняем предварительно выделенный буфер
-  slot.used = true;
-  tail_ = (tail_ + 1) % capacity_;
-  ++size_;
+  uint8_t* rec = arena_.data() + offset;
+  rec[0] = static_cast<uint8_t>(id & 0xFF);
+  rec[1] = static_cast<uint8_t>(id >> 8);
+  rec[2] = static_cast<uint8_t>(len & 0xFF);
+  rec[3] = static_cast<uint8_t>(len >> 8);
+  std::copy(data, data + len, rec + RECORD_HEADER); // данные сразу за заголовком записи
+  used_ += need;
+  ++count_;
   DEBUG_LOG_VAL("MessageBuffer: добавлен id=", id);
   return id;
 }
 
-// Количество свободных слотов
+bool MessageBuffer::reserve(size_t need, size_t& offset) {
+  if (place(need, offset)) return true;
+  if (arena_.size() < budget_) {               // арена ещё не достигла бюджета — растём удвоением
+    size_t size = std::max(arena_.size() * 2, MIN_ARENA);
+    while (size < used_ + need) size *= 2;
+    compact();
+    arena_.resize(std::min(size, budget_));
+    if (place(need, offset)) return true;
+  }
+  compact();                                   // места хватает, но оно разбито краем арены
+  return place(need, offset);
+}
+
+bool MessageBuffer::place(size_t need, size_t& offset) {
+  if (count_ == 0) {                           // пустая очередь начинается с нулевого смещения
+    head_ = tail_ = 0;
+    wrap_ = NO_WRAP;
+  }
+  if (wrap_ == NO_WRAP) {
+    if (arena_.size() - tail_ >= need) {       // помещается до края арены
+      offset = tail_;
+      tail_ += need;
+      return true;
+    }
+    if (count_ > 0 && head_ >= need) {         // переносим запись в начало, хвост у края пропускается
+      wrap_ = tail_;
+      offset = 0;
+      tail_ = need;
+      return true;
+    }
+    return false;
+  }
+  if (head_ - tail_ >= need) {                 // промежуток между перенесёнными записями и головой
+    offset = tail_;
+    tail_ += need;
+    return true;
+  }
+  return false;
+}
+
+void MessageBuffer::compact() {
+  if (count_ == 0) {
+    head_ = tail_ = 0;
+    wrap_ = NO_WRAP;
+    return;
+  }
+  if (wrap_ == NO_WRAP) {
+    std::rotate(arena_.begin(), arena_.begin() + head_, arena_.begin() + tail_);
+  } else {
+    // [0, tail_) — перенесённые записи, [head_, wrap_) — старшие: меняем участки местами
+    std::rotate(arena_.begin(), arena_.begin() + head_, arena_.begin() + wrap_);
+  }
+  head_ = 0;
+  tail_ = used_;
+  wrap_ = NO_WRAP;
+}
+
+uint16_t MessageBuffer::recordLen(size_t offset) const {
+  return static_cast<uint16_t>(arena_[offset + 2] | (arena_[offset + 3] << 8));
+}
+
+size_t MessageBuffer::nextRecord(size_t offset) const {
+  size_t next = offset + RECORD_HEADER + recordLen(offset);
+  if (wrap_ != NO_WRAP && next == wrap_) next = 0;
+  return next;
+}
+
+// Количество свободных мест под сообщения
 size_t MessageBuffer::freeSlots() const {
-  return capacity_ - size_;
+  return capacity_ - count_;
 }
 
 // Удаление последнего сообщения (для отката)
 bool MessageBuffer::dropLast() {
-  if (size_ == 0) {
+  if (count_ == 0) {
     DEBUG_LOG("MessageBuffer: удаление из пустой очереди");
     return false;
   }
-  tail_ = (tail_ + capacity_ - 1) % capacity_;
-  Slot& slot = slots_[tail_];
-  slot.data.clear();
-  slot.used = false;
-  --size_;
+  size_t last = head_;                         // откат редок, поэтому последнюю запись ищем проходом
+  for (size_t i = 1; i < count_; ++i) last = nextRecord(last);
+  used_ -= RECORD_HEADER + recordLen(last);
+  --count_;
+  tail_ = last;
+  if (wrap_ != NO_WRAP && last == 0) {         // снята единственная перенесённая запись
+    tail_ = wrap_;
+    wrap_ = NO_WRAP;
+  }
   // Идентификаторы сообщений должны оставаться уникальными, даже если
   // откатили незавершённую операцию. Поэтому счётчик не уменьшаем, чтобы
   // исключить повторную выдачу уже использованных значений.
@@ -72,36 +172,50 @@ bool MessageBuffer::dropLast() {
 
 // Проверка наличия сообщений
 bool MessageBuffer::hasPending() const {
-  return size_ > 0;
+  return count_ > 0;
 }
 
 // Извлечение сообщения
 bool MessageBuffer::pop(uint16_t& id, std::vector<uint8_t>& out) {
-  if (size_ == 0) {                            // очередь пуста
+  View view;
+  if (!peek(view)) {                           // очередь пуста
     DEBUG_LOG("MessageBuffer: извлечение из пустой очереди");
     return false;
   }
-  Slot& slot = slots_[head_];
-  id = slot.id;                                // возвращаем идентификатор
-  out.assign(slot.data.begin(), slot.data.end()); // копируем данные в выходной буфер
-  slot.data.clear();
-  slot.used = false;
-  head_ = (head_ + 1) % capacity_;
-  --size_;
+  id = view.id;                                // возвращаем идентификатор
+  out.assign(view.data, view.data + view.len); // копируем данные в выходной буфер
+  discard();
   DEBUG_LOG_VAL("MessageBuffer: извлечён id=", id);
   return true;
 }
 
-const std::vector<uint8_t>* MessageBuffer::peek(uint16_t& id) const {
-  if (size_ == 0) {                              // очередь пуста
-    DEBUG_LOG("MessageBuffer: просмотр пустой очереди");
-    return nullptr;
+bool MessageBuffer::peek(View& out) const {
+  if (count_ == 0) {                           // очередь пуста
+    return false;
   }
-  const Slot& slot = slots_[head_];
-  id = slot.id;
-  return slot.used ? &slot.data : nullptr;      // возвращаем указатель на данные без копирования
+  const uint8_t* rec = arena_.data() + head_;
+  out.id = static_cast<uint16_t>(rec[0] | (rec[1] << 8));
+  out.len = recordLen(head_);
+  out.data = rec + RECORD_HEADER;              // указатель в арену без копирования
+  return true;
+}
+
+bool MessageBuffer::discard() {
+  if (count_ == 0) {
+    DEBUG_LOG("MessageBuffer: снятие из пустой очереди");
+    return false;
+  }
+  const size_t rec = RECORD_HEADER + recordLen(head_);
+  head_ = nextRecord(head_);
+  if (head_ == 0) wrap_ = NO_WRAP;             // голова перешла к перенесённым записям
+  used_ -= rec;
+  if (--count_ == 0) {
+    head_ = tail_ = 0;
+    wrap_ = NO_WRAP;
+  }
+  return true;
 }
 
 size_t MessageBuffer::slotSize() const {
-  return slot_size_;
+  return std::min(budget_ - RECORD_HEADER, MAX_MESSAGE);
 }
@@ -3,43 +3,86 @@
 #define MESSAGE_BUFFER_H
 
 #include <vector>
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
 
-// Буфер сообщений для хранения данных на отправку
+// Буфер сообщений для хранения данных на отправку.
+// Сообщения лежат подряд в одной кольцевой области байтов (арене) как записи
+// {id, len, данные} переменной длины: на каждое сообщение не выделяется отдельный
+// вектор, а длина одного сообщения ограничена только бюджетом очереди.
+// Арена растёт удвоением до бюджета по мере заполнения и больше не освобождается,
+// поэтому в установившемся режиме постановка и извлечение не трогают кучу.
 class MessageBuffer {
 public:
-  // Конструктор с ограничением на количество сообщений
-  static constexpr size_t DEFAULT_SLOT_SIZE = 256; // размер слота по умолчанию
+  static constexpr size_t DEFAULT_SLOT_SIZE = 256; // средний объём на сообщение в бюджете
+  static constexpr size_t RECORD_HEADER = 4;       // id (2 байта) и длина (2 байта) записи
+  static constexpr size_t MAX_MESSAGE = 0xFFFF;    // предел поля длины записи
+
+  // Участок сообщения в арене без копирования; действителен до изменения очереди
+  struct View {
+    uint16_t id = 0;
+    const uint8_t* data = nullptr;
+    size_t len = 0;
+  };
+
+  // capacity — наибольшее число сообщений, бюджет арены — capacity записей по slot_size байт
   explicit MessageBuffer(size_t capacity, size_t slot_size = DEFAULT_SLOT_SIZE);
   // Добавляет сообщение в буфер и возвращает его идентификатор
   uint16_t enqueue(const uint8_t* data, size_t len);
-  // Возвращает количество свободных слотов в очереди
+  // Добавляет сообщение под идентификатором, выданным reserveId(); 0 — нет места
+  uint16_t enqueue(const uint8_t* data, size_t len, uint16_t id);
+  // Выдать следующий идентификатор заранее; безопасно из любой задачи
+  uint16_t reserveId();
+  // Возвращает количество свободных мест под сообщения
   size_t freeSlots() const;
   // Удаляет последнее сообщение (для отката операций)
   bool dropLast();
   // Проверяет, есть ли сообщения в очереди
   bool hasPending() const;
-  // Извлекает первое сообщение из очереди, возвращает ID и данные
+  // Извлекает первое сообщение из очереди, возвращает ID и копию данных
   bool pop(uint16_t& id, std::vector<uint8_t>& out);
-  // Позволяет заглянуть в начало очереди без извлечения
-  const std::vector<uint8_t>* peek(uint16_t& id) const;
-  // Возвращает вместимость слота данных
+  // Заглянуть в начало очереди без извлечения и копирования
+  bool peek(View& out) const;
+  // Снять первое сообщение без копирования (после peek)
+  bool discard();
+  // Наибольшая длина одного сообщения
   size_t slotSize() const;
+  // Байты арены: бюджет, занятые записями вместе с заголовками и свободные. Сообщение
+  // длиной len встаёт в очередь, если RECORD_HEADER + len не больше freeBytes() и число сообщений
+  // меньше capacity
+  size_t byteBudget() const { return budget_; }
+  size_t usedBytes() const { return used_; }
+  size_t freeBytes() const { return budget_ - used_; }
+  // Число сообщений в очереди
+  size_t size() const { return count_; }
+
 private:
-  struct Slot {
-    uint16_t id = 0;                  // сохранённый идентификатор сообщения
-    std::vector<uint8_t> data;        // заранее выделенный буфер данных
-    bool used = false;                // флаг заполнения слота
-  };
+  static constexpr size_t NO_WRAP = static_cast<size_t>(-1);
+  static constexpr size_t MIN_ARENA = 512;        // первый размер арены
+
+  // Место под запись need байт; при необходимости арена растёт или запись переносится в начало
+  bool reserve(size_t need, size_t& offset);
+  // Размещение без роста и уплотнения
+  bool place(size_t need, size_t& offset);
+  // Сдвиг записей к нулевому смещению на месте (пропуски у края исчезают)
+  void compact();
+  uint16_t recordLen(size_t offset) const;
+  // Смещение следующей записи после записи по offset с учётом переноса
+  size_t nextRecord(size_t offset) const;
+
+  // Проверка длины и места без записи
+  bool fits(const uint8_t* data, size_t len) const;
 
-  uint16_t next_id_ = 1;             // следующий идентификатор
+  std::atomic<uint16_t> next_id_{1};  // следующий идентификатор
   size_t capacity_;                  // максимальное количество сообщений
-  size_t slot_size_;                 // максимальная длина данных одного сообщения
-  std::vector<Slot> slots_;          // предвыделенные слоты хранения
-  size_t head_ = 0;                  // индекс первого элемента
-  size_t tail_ = 0;                  // индекс следующей позиции для добавления
-  size_t size_ = 0;                  // текущее число элементов
+  size_t budget_;                    // предельный размер арены в байтах
+  std::vector<uint8_t> arena_;       // кольцевая область записей
+  size_t head_ = 0;                  // смещение первой записи
+  size_t tail_ = 0;                  // смещение для следующей записи
+  size_t wrap_ = NO_WRAP;            // конец записей у края арены, если хвост перенесён в начало
+  size_t count_ = 0;                 // текущее число сообщений
+  size_t used_ = 0;                  // занятые байты арены
 };
 
 #endif // MESSAGE_BUFFER_H
@@ -2,18 +2,64 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include "libs/subpacket/subpacket.h" // карта пакетов собранного кадра
+
+// Результат проверки занятости канала (CAD) перед передачей
+enum class ChannelState : uint8_t {
+  UNSUPPORTED = 0,   // радио не умеет CAD или проверка прервана — решения нет
+  PENDING,           // проверка запущена и ещё не завершена
+  CLEAR,             // активности LoRa не обнаружено, можно передавать
+  BUSY               // в канале обнаружена преамбула чужой передачи
+};
 
 // Простейший интерфейс радиоканала
 class IRadio {
 public:
   using RxCallback = std::function<void(const uint8_t*, size_t)>;
+  // Колбэк собранного кадра с картой потерянных и дополненных LoRa-пакетов
+  using RxFrameCallback = std::function<void(const uint8_t*, size_t, const subpacket::FrameInfo&)>;
   static constexpr int16_t ERR_NONE = 0;                  // успешное завершение операции
   static constexpr int16_t ERR_TIMEOUT = -32000;          // тайм-аут захвата ресурса
+  static constexpr int16_t ERR_PENDING = -32001;          // передача запущена и ещё не завершена
+  // Кадр для пакетной передачи
+  struct Frame {
+    const uint8_t* data;
+    size_t len;
+  };
   virtual ~IRadio() = default;
   // Отправка данных по радио
   virtual int16_t send(const uint8_t* data, size_t len) = 0;
+  // Отправка серии кадров без возврата в приём между ними; sent — число полностью переданных кадров.
+  // По умолчанию кадры уходят поочерёдными вызовами send()
+  virtual int16_t sendBurst(const Frame* frames, size_t count, size_t& sent) {
+    sent = 0;
+    for (size_t i = 0; i < count; ++i) {
+      const int16_t state = send(frames[i].data, frames[i].len);
+      if (state != ERR_NONE) return state;
+      ++sent;
+    }
+    return ERR_NONE;
+  }
+  // Неблокирующий запуск серии кадров. ERR_PENDING — кадры ещё в эфире, итог сообщит pollSend().
+  // По умолчанию серия передаётся синхронно через sendBurst()
+  virtual int16_t startSendBurst(const Frame* frames, size_t count, size_t& sent) {
+    return sendBurst(frames, count, sent);
+  }
+  // Опрос передачи, запущенной startSendBurst(): ERR_PENDING, пока она идёт, затем итоговый код
+  virtual int16_t pollSend(size_t& sent) { sent = 0; return ERR_NONE; }
   // Регистрация колбэка для приёма
   virtual void setReceiveCallback(RxCallback cb) = 0;
+  // Регистрация колбэка кадров, включая неполные (подсказки стираний). Если радио не собирает кадры
+  // из пакетов, вызов игнорируется и данные приходят через обычный колбэк
+  virtual void setReceiveFrameCallback(RxFrameCallback cb) { (void)cb; }
   // Гарантируем возврат в режим приёма (по умолчанию ничего не делаем)
   virtual int16_t ensureReceiveMode() { return ERR_NONE; }
+  // Оценка времени в эфире для передачи len байт (мкс); 0 — оценка недоступна
+  virtual uint32_t airtimeUs(size_t len) const { (void)len; return 0; }
+  // Поддерживает ли радио неблокирующую проверку занятости канала (CAD)
+  virtual bool supportsChannelScan() const { return false; }
+  // Запуск CAD без ожидания результата
+  virtual int16_t startChannelScan() { return ERR_NONE; }
+  // Опрос результата CAD, запущенного startChannelScan()
+  virtual ChannelState pollChannelScan() { return ChannelState::UNSUPPORTED; }
 };
@@ -3,6 +3,7 @@
 #include "libs/radio/lora_radiolib_settings.h" // централизованные настройки LoRa/RadioLib
 #include "libs/config_loader/config_loader.h" // доступ к загруженной конфигурации
 #include "libs/radio/frequency_tables.h"      // таблицы частот и описания
+#include "libs/airtime/lora_airtime.h"        // расчёт времени кадра в эфире
 #include <Arduino.h>
 #include <cmath>
 #include <array>
@@ -11,6 +12,9 @@
 #include <utility>
 #include <cstdio>
 #include <algorithm>
+#if !defined(ARDUINO)
+#include <chrono>
+#endif
 
 #ifndef RADIOLIB_SX126X_IRQ_NONE
 #define RADIOLIB_SX126X_IRQ_NONE 0U
@@ -20,32 +24,30 @@
 #define RADIOLIB_SX126X_IRQ_ALL 0xFFFFU
 #endif
 
-RadioSX1262* RadioSX1262::instance_ = nullptr; // инициализация статического указателя
+RadioSX1262* RadioSX1262::instances_[RadioSX1262::MAX_INSTANCES] = {nullptr, nullptr}; // модули с DIO1
 bool RadioSX1262::irqLoggerStarted_ = false;   // отметка о выводе стартового сообщения
 
 // Максимальный размер пакета для SX1262
 static constexpr size_t MAX_PACKET_SIZE = 245;
 
-// RAII-обёртка для автоматического освобождения мьютекса радиомодуля
-class ScopedRadioLock {
-public:
-  explicit ScopedRadioLock(RadioSX1262& radio) : radio_(radio) {}
-  int16_t acquire(TickType_t timeout) {
-    const int16_t state = radio_.lockRadio(timeout);
-    locked_ = (state == RADIOLIB_ERR_NONE);
-    return state;
-  }
-  ~ScopedRadioLock() {
-    if (locked_) {
-      radio_.unlockRadio();
-    }
-  }
-  bool locked() const { return locked_; }
+// Параметры модема для расчёта времени в эфире по текущим SF/BW/CR
+static lora_airtime::ModemParams makeModemParams(float bandwidthKhz, int sf, int cr) {
+  const auto& radioDefaults = LoRaRadioLibSettings::DEFAULT_OPTIONS;
+  lora_airtime::ModemParams params;
+  params.bandwidthKhz = bandwidthKhz;
+  params.spreadingFactor = static_cast<uint8_t>(sf);
+  params.codingRateDenom = static_cast<uint8_t>(cr);
+  params.preambleLength = radioDefaults.preambleLength;
+  params.crc = radioDefaults.enableCrc;
+  params.lowDataRateOptimize = radioDefaults.autoLdro &&
+                               lora_airtime::autoLowDataRateOptimize(params.bandwidthKhz, params.spreadingFactor);
+  return params;
+}
 
-private:
-  RadioSX1262& radio_;
-  bool locked_ = false;
-};
+#if !defined(ARDUINO)
+// Объект, задачей-владельцем которого является текущий поток (хост-реализация)
+static thread_local const RadioSX1262* gOwnerContext = nullptr;
+#endif
 
 const float* RadioSX1262::fRX_bank_[6] = {
     frequency_tables::RX_EAST,
@@ -94,10 +96,33 @@ const float RadioSX1262::BW_[5] = {7.81, 10.42, 15.63, 20.83, 31.25};
 const int8_t RadioSX1262::SF_[8] = {5, 6, 7, 8, 9, 10, 11, 12};
 const int8_t RadioSX1262::CR_[4] = {5, 6, 7, 8};
 
-RadioSX1262::RadioSX1262() : radio_(new Module(5, 26, 27, 25)) {}
+RadioSX1262::RadioSX1262() : RadioSX1262(5, 26, 27, 25) {}
+
+RadioSX1262::RadioSX1262(int csPin, int irqPin, int resetPin, int busyPin)
+    : radio_(new Module(csPin, irqPin, resetPin, busyPin)) {
+  assembler_.setHandler([this](const uint8_t* data, size_t len, const subpacket::FrameInfo& info) {
+    deliverFrame(data, len, info);
+  });
+  for (size_t i = 0; i < MAX_INSTANCES; ++i) {   // свободный обработчик DIO1 для этого модуля
+    if (instances_[i] == nullptr) {
+      instances_[i] = this;
+      slot_ = static_cast<int>(i);
+      break;
+    }
+  }
+}
+
+RadioSX1262::~RadioSX1262() {
+  stopTask();
+  if (slot_ >= 0) {
+    instances_[slot_] = nullptr;          // ISR больше не должен обращаться к объекту
+  }
+}
 
 bool RadioSX1262::begin() {
-  instance_ = this;               // сохраняем указатель на объект
+  if (slot_ < 0) {
+    LOG_WARN("RadioSX1262: нет свободного обработчика DIO1 для ещё одного модуля");
+  }
   if (!irqLoggerStarted_) {       // выводим стартовый лог только один раз
     DEBUG_LOG("IRQ logger started");
     irqLoggerStarted_ = true;
@@ -111,19 +136,82 @@ int16_t RadioSX1262::send(const uint8_t* data, size_t len) {
     lastError_ = ERR_INVALID_ARGUMENT;
     return lastError_;
   }
+  const Frame frame{data, len};
+  size_t sent = 0;
+  return sendBurst(&frame, 1, sent);
+}
 
-  ScopedRadioLock guard(*this);
-  const int16_t lockState = guard.acquire(toTicks(LOCK_TIMEOUT_MS));
-  if (lockState != RADIOLIB_ERR_NONE) {
-    LOG_WARN("RadioSX1262: отправка отклонена — радио занято");
-    lastError_ = lockState;
+// Блокирующая серия: запускаем автомат передачи и продвигаем его до завершения
+int16_t RadioSX1262::sendBurst(const Frame* frames, size_t count, size_t& sent) {
+  if (needsOwnerHop()) {
+    // Серию ведёт задача-владелец; finishTransmit() будит нас уведомлением, как postAndWait()
+#if defined(ARDUINO)
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+#endif
+    int16_t state = runOnOwner([&]() {
+      const int16_t started = startSendBurst(frames, count, sent);
+#if defined(ARDUINO)
+      if (started == ERR_PENDING) {
+        txWaiter_ = self;                    // регистрируем до первого TX_DONE серии
+      }
+#endif
+      return started;
+    });
+    while (state == ERR_PENDING && (state = pollSend(sent)) == ERR_PENDING) {
+#if defined(ARDUINO)
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+#else
+      std::this_thread::yield();
+#endif
+    }
+    return state;
+  }
+  int16_t state = startSendBurst(frames, count, sent);
+  if (state != ERR_PENDING) {
+    return state;
+  }
+  while ((state = serviceTransmit(true)) == ERR_PENDING) {
+    yield();
+  }
+  sent = txFramesSent_;
+  return state;
+}
+
+int16_t RadioSX1262::startSendBurst(const Frame* frames, size_t count, size_t& sent) {
+  sent = 0;
+  if (!frames || count == 0) {
+    DEBUG_LOG("RadioSX1262: пустая серия кадров");
+    lastError_ = ERR_INVALID_ARGUMENT;
+    return lastError_;
+  }
+  size_t totalLen = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (!frames[i].data || frames[i].len == 0) {
+      DEBUG_LOG("RadioSX1262: пустой кадр в серии");
+      lastError_ = ERR_INVALID_ARGUMENT;
+      return lastError_;
+    }
+    totalLen += frames[i].len;
+  }
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return startSendBurst(frames, count, sent); });
+  }
+  // Занятость проверяет только владелец: между проверкой и запуском серии её никто не займёт
+  if (txActive_ || pingActive_) {
+    DEBUG_LOG("RadioSX1262: отправка отклонена — предыдущая передача или пинг ещё идут");
+    return ERR_TIMEOUT;
+  }
+  if (role_ == Role::DOWNLINK) {             // отказ до подготовки серии: состояние передачи не меняется
+    LOG_WARN("RadioSX1262: передача отклонена — модуль работает только на приём");
+    lastError_ = ERR_INVALID_ARGUMENT;
     return lastError_;
   }
 
   const bool enforceImplicit = implicitHeaderEnabled_ && implicitHeaderLength_ > 0; // активен ли фиксированный размер кадра
   size_t fragmentCapacity = enforceImplicit ? implicitHeaderLength_ : MAX_PACKET_SIZE; // максимум данных за один вызов
-  if (fragmentCapacity == 0) {               // защита от некорректной конфигурации
-    LOG_ERROR("RadioSX1262: нулевая длина implicit header — передача невозможна");
+  if (subpacket::chunkPayload(fragmentCapacity) == 0) { // защита от некорректной конфигурации
+    LOG_ERROR("RadioSX1262: длина implicit header %u слишком мала — передача невозможна",
+              static_cast<unsigned>(fragmentCapacity));
     lastError_ = ERR_INVALID_ARGUMENT;
     return lastError_;
   }
@@ -133,54 +221,169 @@ int16_t RadioSX1262::send(const uint8_t* data, size_t len) {
              static_cast<unsigned>(MAX_PACKET_SIZE));
     fragmentCapacity = MAX_PACKET_SIZE;
   }
+  for (size_t i = 0; i < count; ++i) {
+    if (subpacket::chunkCount(frames[i].len, fragmentCapacity) == 0) {
+      LOG_ERROR("RadioSX1262: кадр %u байт не помещается в %u LoRa-пакетов",
+                static_cast<unsigned>(frames[i].len), static_cast<unsigned>(subpacket::MAX_CHUNKS));
+      lastError_ = ERR_INVALID_ARGUMENT;
+      return lastError_;
+    }
+  }
 
-  const size_t fragmentCount = (len + fragmentCapacity - 1) / fragmentCapacity; // количество LoRa-фрагментов
-  float freq_tx = fTX_bank_[static_cast<int>(bank_)][channel_];
-  float freq_rx = fRX_bank_[static_cast<int>(bank_)][channel_];
-  DEBUG_LOG("RadioSX1262: отправка %u байт %zu фрагмент(ов)",
-            static_cast<unsigned>(len), fragmentCount);
-  if (!setFrequency(freq_tx)) {              // переключаемся на TX-частоту
+  // Копируем кадры: вызывающий код может освободить буферы до окончания передачи
+  txData_.clear();
+  txData_.reserve(totalLen);
+  txFrameEnds_.clear();
+  txFrameEnds_.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    txData_.insert(txData_.end(), frames[i].data, frames[i].data + frames[i].len);
+    txFrameEnds_.push_back(txData_.size());
+  }
+  txFrameIdx_ = 0;
+  txFramesSent_ = 0;
+  txChunkCapacity_ = fragmentCapacity;
+  txChunkSeq_ = 0;
+  txChunkTotal_ = subpacket::chunkCount(frames[0].len, fragmentCapacity);
+  txImplicit_ = enforceImplicit;
+  txDoneIrq_ = false;
+  txResult_ = ERR_PENDING;
+
+  cadActive_ = false;                        // передача прерывает незавершённый CAD
+  const float freq_tx = fTX_bank_[static_cast<int>(bank_)][channel_];
+  DEBUG_LOG("RadioSX1262: отправка %u байт в %u кадр(ах)",
+            static_cast<unsigned>(totalLen), static_cast<unsigned>(count));
+  // Модуль аплинка и так стоит на TX-частоте; одиночное радио перестраивается один раз на серию
+  if (role_ != Role::UPLINK && !setFrequency(freq_tx)) {
     LOG_ERROR("RadioSX1262: не удалось установить TX-частоту перед передачей");
+    txResult_ = lastError_;
     return lastError_;
   }
 
-  std::array<uint8_t, MAX_PACKET_SIZE> padded{}; // буфер для дополнения последнего фрагмента
-  size_t offset = 0;
-  for (size_t frag = 0; offset < len; ++frag) {
-    const size_t chunk = std::min(fragmentCapacity, len - offset); // фактический объём данных
-    const uint8_t* chunkPtr = data + offset;                       // указатель на исходные данные
-    size_t sendLen = chunk;                                        // длина, которая уйдёт в RadioLib
+  txActive_ = true;
+  const int16_t state = startNextChunk();
+  if (state != RADIOLIB_ERR_NONE) {
+    LOG_ERROR_VAL("RadioSX1262: ошибка передачи, код=", state);
+    finishTransmit(state, "send: возврат к приёму после ошибки передачи");
+    return state;
+  }
+  return ERR_PENDING;
+}
+
+int16_t RadioSX1262::pollSend(size_t& sent) {
+  if (needsOwnerHop()) {
+    // Серию продвигает задача-владелец; итог публикуется до сброса txActive_
+    if (txActive_) {
+      sent = 0;
+      return ERR_PENDING;
+    }
+    sent = txFramesSent_;
+    return txResult_;
+  }
+  const int16_t state = serviceTransmit(false);
+  sent = txFramesSent_;
+  return state;
+}
+
+// Запуск следующего LoRa-пакета серии с маркером номера; вызывается владельцем радио
+int16_t RadioSX1262::startNextChunk() {
+  const size_t frameStart = txFrameIdx_ == 0 ? 0 : txFrameEnds_[txFrameIdx_ - 1];
+  const size_t frameLen = txFrameEnds_[txFrameIdx_] - frameStart;
+  std::array<uint8_t, MAX_PACKET_SIZE> packet{};                         // маркер, данные и заполнитель
+  const size_t sendLen = subpacket::buildChunk(txData_.data() + frameStart, frameLen, txChunkSeq_,
+                                               txChunkCapacity_, txImplicit_, txTag_, packet.data());
+  if (sendLen == 0) {
+    return ERR_INVALID_ARGUMENT;
+  }
+  DEBUG_LOG("RadioSX1262: кадр %u/%u, пакет %u/%u, длина=%u",
+            static_cast<unsigned>(txFrameIdx_ + 1), static_cast<unsigned>(txFrameEnds_.size()),
+            static_cast<unsigned>(txChunkSeq_ + 1), static_cast<unsigned>(txChunkTotal_),
+            static_cast<unsigned>(sendLen));
+  const int16_t state = radio_.startTransmit(packet.data(), sendLen);
+  if (state != RADIOLIB_ERR_NONE) {
+    return state;
+  }
+  // Пакет не может длиться дольше расчётного времени в эфире; запас покрывает задержки SPI
+  const uint32_t airtimeMs = packetAirtimeUs(sendLen) / 1000U;
+  txChunkAirtimeMs_ = airtimeMs;
+  txChunkTimeoutMs_ = airtimeMs * 2U + 100U;
+  txChunkStartedMs_ = millis();
+  return RADIOLIB_ERR_NONE;
+}
 
-    if (enforceImplicit) {
-      std::memcpy(padded.data(), chunkPtr, chunk);                 // копируем фактические данные
-      if (chunk < fragmentCapacity) {                              // дополняем остаток нулями
-        std::fill(padded.begin() + chunk, padded.begin() + fragmentCapacity, 0);
+// Продвижение автомата передачи: TX_DONE приходит через DIO1 (или читается из регистра, если
+// прерывание задержалось), после чего стартует следующий фрагмент либо возвращается приём
+int16_t RadioSX1262::serviceTransmit(bool pollRegister) {
+  if (!txActive_) {
+    return txResult_;
+  }
+  processPendingIrqLog();                    // TX_DONE из ISR отмечается в txDoneIrq_
+  bool done = txDoneIrq_;
+  const uint32_t elapsed = millis() - txChunkStartedMs_;
+  if (!done && (pollRegister || elapsed >= txChunkAirtimeMs_)) {
+    const uint32_t flags = radio_.getIrqFlags();
+    if ((flags & RADIOLIB_SX126X_IRQ_TX_DONE) != 0U) {
+      const int16_t clearState = radio_.clearIrqFlags(RADIOLIB_SX126X_IRQ_ALL);
+      if (clearState != RADIOLIB_ERR_NONE) {
+        LOG_WARN_VAL("RadioSX1262: не удалось очистить IRQ после TX_DONE, код=", clearState);
       }
-      chunkPtr = padded.data();
-      sendLen = fragmentCapacity;                                  // передаём ровно фиксированный размер
-    }
-
-    DEBUG_LOG("RadioSX1262: отправляется фрагмент %zu/%zu, длина=%u", frag + 1,
-              fragmentCount, static_cast<unsigned>(sendLen));
-    int state = radio_.transmit(const_cast<uint8_t*>(chunkPtr), sendLen);
-    if (state != RADIOLIB_ERR_NONE) {                              // передача не удалась
-      lastError_ = state;
-      LOG_ERROR_VAL("RadioSX1262: ошибка передачи, код=", state);
-      const int16_t failureCode = lastError_;
-      setFrequency(freq_rx);                                       // попытка вернуть RX-частоту
-      startReceiveWithRetry("send: возврат к приёму после ошибки передачи");
-      lastError_ = failureCode;
-      return lastError_;
+      done = true;
     }
-    offset += chunk;
   }
+  if (!done) {
+    if (elapsed > txChunkTimeoutMs_) {
+      LOG_WARN("RadioSX1262: TX_DONE не получен за %u мс", static_cast<unsigned>(txChunkTimeoutMs_));
+      radio_.clearIrqFlags(RADIOLIB_SX126X_IRQ_ALL);
+      finishTransmit(RADIOLIB_ERR_TX_TIMEOUT, "send: возврат к приёму после тайм-аута передачи");
+      return txResult_;
+    }
+    return ERR_PENDING;
+  }
+  txDoneIrq_ = false;
+  if (++txChunkSeq_ >= txChunkTotal_) {
+    ++txFramesSent_;                         // кадр серии передан полностью
+    ++txFrameIdx_;
+    txTag_ = !txTag_;                        // приёмник отличает следующий кадр по метке
+    txChunkSeq_ = 0;
+    if (txFrameIdx_ < txFrameEnds_.size()) {
+      const size_t frameStart = txFrameEnds_[txFrameIdx_ - 1];
+      txChunkTotal_ = subpacket::chunkCount(txFrameEnds_[txFrameIdx_] - frameStart, txChunkCapacity_);
+    }
+  }
+  if (txFrameIdx_ >= txFrameEnds_.size()) {
+    finishTransmit(RADIOLIB_ERR_NONE, "send: переход к приёму после передачи");
+    DEBUG_LOG("RadioSX1262: передача завершена");
+    return txResult_;
+  }
+  const int16_t state = startNextChunk();
+  if (state != RADIOLIB_ERR_NONE) {
+    LOG_ERROR_VAL("RadioSX1262: ошибка передачи, код=", state);
+    finishTransmit(state, "send: возврат к приёму после ошибки передачи");
+    return txResult_;
+  }
+  return ERR_PENDING;
+}
 
-  lastError_ = RADIOLIB_ERR_NONE;            // вся последовательность прошла успешно
-  setFrequency(freq_rx);                     // возвращаем RX-частоту
-  startReceiveWithRetry("send: переход к приёму после передачи");
-  DEBUG_LOG("RadioSX1262: запуск приёма после завершения передачи");
-  DEBUG_LOG("RadioSX1262: передача завершена");
-  return lastError_;
+// Смена параметров модема посреди серии исказила бы кадры — сначала дожидаемся её окончания
+void RadioSX1262::waitTransmitIdle() {
+  while (txActive_ && serviceTransmit(true) == ERR_PENDING) {
+    yield();
+  }
+}
+
+// Завершение серии: единственный возврат в приём (или standby аплинка). txActive_ сбрасывается
+// последним — после него pollSend() из другого контекста читает готовый итог
+void RadioSX1262::finishTransmit(int16_t result, const char* context) {
+  txData_.clear();
+  enterIdle(context);                        // RX-частота и приём либо standby аплинка
+  txResult_ = result;
+  lastError_ = result;
+  txActive_ = false;
+#if defined(ARDUINO)
+  TaskHandle_t waiter = txWaiter_.exchange(nullptr);   // блокирующий sendBurst() из другой задачи
+  if (waiter != nullptr) {
+    xTaskNotifyGive(waiter);
+  }
+#endif
 }
 
 int16_t RadioSX1262::ping(const uint8_t* data, size_t len,
@@ -189,25 +392,43 @@ int16_t RadioSX1262::ping(const uint8_t* data, size_t len,
                           uint32_t& elapsedUs) {
   receivedLen = 0;                                        // сбрасываем длину ответа
   elapsedUs = 0;                                          // сбрасываем время
-  int16_t result = ERR_INVALID_ARGUMENT;                  // код возврата по умолчанию
-  if (!data || len == 0 || !response || responseCapacity == 0) {
+  if (!response || responseCapacity == 0) {
     lastError_ = ERR_INVALID_ARGUMENT;                    // некорректные аргументы
     return lastError_;
   }
+  int16_t state = startPing(data, len, timeoutUs);
+  while (state == RADIOLIB_ERR_NONE || state == ERR_PENDING) {
+    state = pollPing(response, responseCapacity, receivedLen, elapsedUs);
+    if (state != ERR_PENDING) {
+      break;
+    }
+    delay(1);
+  }
+  return state;
+}
 
-  ScopedRadioLock guard(*this);
-  const int16_t lockState = guard.acquire(toTicks(LOCK_TIMEOUT_MS));
-  if (lockState != RADIOLIB_ERR_NONE) {
-    LOG_WARN("RadioSX1262: пинг отклонён — радио занято");
-    lastError_ = lockState;
+int16_t RadioSX1262::startPing(const uint8_t* data, size_t len, uint32_t timeoutUs) {
+  if (!data || len == 0) {
+    lastError_ = ERR_INVALID_ARGUMENT;                    // некорректные аргументы
     return lastError_;
   }
+  if (txActive_ || pingActive_) {
+    LOG_WARN("RadioSX1262: пинг отклонён — идёт передача");
+    lastError_ = ERR_TIMEOUT;
+    return lastError_;
+  }
+  if (role_ == Role::DOWNLINK) {
+    LOG_WARN("RadioSX1262: пинг отклонён — модуль работает только на приём");
+    lastError_ = ERR_INVALID_ARGUMENT;
+    return lastError_;
+  }
+  if (needsOwnerHop()) {                                  // отправку выполняет владелец радио
+    return runOnOwner([&]() { return startPing(data, len, timeoutUs); });
+  }
 
-  const bool needRestoreImplicit = implicitHeaderEnabled_ && implicitHeaderLength_ > 0; // нужно ли вернуть implicit-режим
-  const size_t implicitLen = implicitHeaderLength_;       // сохраняем ожидаемую длину
-  bool headerTemporarilyExplicit = false;                 // отметка временного переключения
-
-  if (needRestoreImplicit) {                              // временно включаем явный заголовок для пинга
+  pingImplicitLen_ = implicitHeaderLength_;               // сохраняем ожидаемую длину
+  pingHeaderSwitched_ = false;
+  if (implicitHeaderEnabled_ && implicitHeaderLength_ > 0) { // временно включаем явный заголовок для пинга
     const int16_t headerState = radio_.explicitHeader();
     if (headerState != RADIOLIB_ERR_NONE) {
       LOG_WARN_VAL("RadioSX1262: не удалось выключить implicit header перед ping, код=", headerState);
@@ -215,140 +436,213 @@ int16_t RadioSX1262::ping(const uint8_t* data, size_t len,
       return lastError_;
     }
     implicitHeaderEnabled_ = false;
-    headerTemporarilyExplicit = true;
+    pingHeaderSwitched_ = true;
   }
 
   float freq_tx = fTX_bank_[static_cast<int>(bank_)][channel_];
   float freq_rx = fRX_bank_[static_cast<int>(bank_)][channel_];
 
-  auto restoreImplicit = [&]() {
-    if (headerTemporarilyExplicit) {                      // восстанавливаем implicit-режим
-      if (implicitLen > 0) {
-        const int16_t restoreState = radio_.implicitHeader(implicitLen);
-        if (restoreState != RADIOLIB_ERR_NONE) {
-          LOG_WARN_VAL("RadioSX1262: не удалось вернуть implicit header после ping, код=", restoreState);
-          implicitHeaderEnabled_ = false;
-          implicitHeaderLength_ = 0;
-        } else {
-          implicitHeaderEnabled_ = true;
-          implicitHeaderLength_ = implicitLen;
-        }
-      } else {
-        implicitHeaderEnabled_ = false;
-        implicitHeaderLength_ = 0;
-      }
-    }
-  };
+  if (!setFrequency(freq_tx)) {                           // не удалось установить TX
+    LOG_ERROR("RadioSX1262: не удалось установить TX-частоту перед пингом");
+    finishPing(lastError_, "ping: возврат после ошибки установки TX-частоты");
+    return lastError_;
+  }
 
-  do {
-    if (!setFrequency(freq_tx)) {                         // не удалось установить TX
-      LOG_ERROR("RadioSX1262: не удалось установить TX-частоту перед пингом");
-      result = lastError_;
-      break;
-    }
+  const int state = radio_.transmit(const_cast<uint8_t*>(data), len); // отправляем пакет
+  if (state != RADIOLIB_ERR_NONE) {                       // ошибка передачи
+    lastError_ = state;                                   // фиксируем код ошибки
+    setFrequency(freq_rx);
+    finishPing(state, "ping: возврат в RX после ошибки передачи");
+    return state;
+  }
 
-    const int state = radio_.transmit(const_cast<uint8_t*>(data), len); // отправляем пакет
-    if (state != RADIOLIB_ERR_NONE) {                     // ошибка передачи
-      lastError_ = state;                                 // фиксируем код ошибки
-      setFrequency(freq_rx);
-      startReceiveWithRetry("ping: возврат в RX после ошибки передачи");
-      result = lastError_;
-      break;
-    }
+  if (!setFrequency(freq_rx)) {                           // возвращаем RX частоту
+    finishPing(lastError_, "ping: попытка приёма после ошибки установки частоты");
+    return lastError_;
+  }
 
-    if (!setFrequency(freq_rx)) {                         // возвращаем RX частоту
-      startReceiveWithRetry("ping: попытка приёма после ошибки установки частоты");
-      result = lastError_;
-      break;
+  packetReady_ = false;                                   // очищаем флаг готовности
+  startReceiveWithRetry("ping: ожидание ответа");        // слушаем эфир
+  DEBUG_LOG("RadioSX1262: запуск ожидания ответа после пинга");
+  DEBUG_LOG_VAL("RadioSX1262: таймаут ожидания, мкс=", timeoutUs);
+  pingTimeoutUs_ = timeoutUs;
+  pingStartedUs_ = micros();                              // стартовое время ожидания
+  pingActive_ = true;
+  lastError_ = RADIOLIB_ERR_NONE;
+  return lastError_;
+}
+
+int16_t RadioSX1262::pollPing(uint8_t* response, size_t responseCapacity,
+                              size_t& receivedLen, uint32_t& elapsedUs) {
+  if (!pingActive_) {
+    return ERR_INVALID_ARGUMENT;                          // пинг не запущен
+  }
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return pollPing(response, responseCapacity, receivedLen, elapsedUs); });
+  }
+  receivedLen = 0;
+  elapsedUs = 0;
+  flushPendingIrqLog();                                   // обрабатываем накопленные IRQ перед проверкой флага готовности
+  if (!packetReady_) {                                    // пакета пока нет
+    if ((micros() - pingStartedUs_) < pingTimeoutUs_) {
+      return ERR_PENDING;
     }
+    LOG_WARN("RadioSX1262: пинг-ответ не получен — истёк таймаут %lu мкс",
+             static_cast<unsigned long>(pingTimeoutUs_));
+    finishPing(ERR_PING_TIMEOUT, "ping: ожидание ответа");
+    return ERR_PING_TIMEOUT;
+  }
 
-    packetReady_ = false;                                 // очищаем флаг готовности
-    startReceiveWithRetry("ping: ожидание ответа");      // слушаем эфир
-    flushPendingIrqLog();                                 // разбираем отложенные IRQ до входа в цикл ожидания
-    DEBUG_LOG("RadioSX1262: запуск ожидания ответа после пинга");
-    DEBUG_LOG_VAL("RadioSX1262: таймаут ожидания, мкс=", timeoutUs);
-
-    const uint32_t start = micros();                      // стартовое время ожидания
-    std::array<uint8_t, 256> buf{};                       // временный буфер
-    bool waitingLogged = false;                           // отметка первого ожидания
-    bool success = false;                                 // отметка успешного чтения ответа
-    bool errorOccurred = false;                           // отметка выхода из цикла по ошибке
-
-    while ((micros() - start) < timeoutUs) {              // ждём ответ с таймаутом
-      flushPendingIrqLog();                               // обрабатываем накопленные IRQ перед проверкой флага готовности
-      if (!packetReady_) {                                // пакета пока нет
-        if (!waitingLogged) {                             // фиксируем начало ожидания
-          DEBUG_LOG("RadioSX1262: ожидание готовности пакета");
-          waitingLogged = true;
-        }
-        delay(1);
-        continue;
-      }
+  const size_t lenRead = radio_.getPacketLength();        // узнаём длину принятого пакета
+  std::array<uint8_t, 256> buf{};                         // временный буфер
+  packetReady_ = false;
+  if (lenRead == 0 || lenRead > buf.size()) {             // защита от некорректного размера
+    LOG_WARN_VAL("RadioSX1262: некорректная длина принятого пинг-ответа=", lenRead);
+    finishPing(ERR_INVALID_ARGUMENT, "ping: повторный запуск приёма после некорректной длины");
+    return ERR_INVALID_ARGUMENT;
+  }
 
-      const size_t lenRead = radio_.getPacketLength();    // узнаём длину принятого пакета
-      if (lenRead == 0 || lenRead > buf.size()) {         // защита от некорректного размера
-        LOG_WARN_VAL("RadioSX1262: некорректная длина принятого пинг-ответа=", lenRead);
-        startReceiveWithRetry("ping: повторный запуск приёма после некорректной длины");
-        lastError_ = ERR_INVALID_ARGUMENT;
-        result = lastError_;
-        errorOccurred = true;
-        break;
-      }
+  const int rxState = radio_.readData(buf.data(), lenRead); // читаем пакет
+  if (rxState != RADIOLIB_ERR_NONE) {                     // ошибка чтения
+    LOG_ERROR_VAL("RadioSX1262: ошибка чтения пинг-ответа, код=", rxState);
+    finishPing(rxState, "ping: перезапуск после чтения ответа");
+    return rxState;
+  }
 
-      const int rxState = radio_.readData(buf.data(), lenRead); // читаем пакет
-      if (rxState != RADIOLIB_ERR_NONE) {                 // ошибка чтения
-        lastError_ = rxState;                             // сохраняем код ошибки чтения
-        LOG_ERROR_VAL("RadioSX1262: ошибка чтения пинг-ответа, код=", rxState);
-        startReceiveWithRetry("ping: перезапуск после чтения ответа");
-        result = lastError_;
-        errorOccurred = true;
-        break;
-      }
+  receivedLen = lenRead;                                  // сохраняем длину ответа
+  if (response && responseCapacity > 0) {                 // копируем в пользовательский буфер
+    std::memcpy(response, buf.data(), std::min(receivedLen, responseCapacity));
+  }
+  elapsedUs = micros() - pingStartedUs_;                  // вычисляем затраченное время
+  lastSnr_ = radio_.getSNR();
+  lastRssi_ = radio_.getRSSI();
+  DEBUG_LOG("RadioSX1262: пинг-ответ получен, длина=%u, время=%lu мкс",
+            static_cast<unsigned>(receivedLen),
+            static_cast<unsigned long>(elapsedUs));
+  finishPing(RADIOLIB_ERR_NONE, "ping: ожидание ответа");
+  return RADIOLIB_ERR_NONE;
+}
 
-      receivedLen = lenRead;                              // сохраняем длину ответа
-      std::memcpy(response, buf.data(),                   // копируем в пользовательский буфер
-                  std::min(receivedLen, responseCapacity));
-      elapsedUs = micros() - start;                       // вычисляем затраченное время
-      lastSnr_ = radio_.getSNR();
-      lastRssi_ = radio_.getRSSI();
-      DEBUG_LOG("RadioSX1262: пинг-ответ получен, длина=%u, время=%lu мкс",
-                static_cast<unsigned>(receivedLen),
-                static_cast<unsigned long>(elapsedUs));
-      packetReady_ = false;
-      startReceiveWithRetry("ping: ожидание ответа");
-      lastError_ = RADIOLIB_ERR_NONE;
-      result = lastError_;
-      success = true;
-      break;
+// Завершение пинга: приём, восстановление implicit-заголовка и standby аплинка
+void RadioSX1262::finishPing(int16_t result, const char* context) {
+  pingActive_ = false;
+  startReceiveWithRetry(context);
+  if (pingHeaderSwitched_) {                              // восстанавливаем implicit-режим
+    pingHeaderSwitched_ = false;
+    if (pingImplicitLen_ > 0) {
+      const int16_t restoreState = radio_.implicitHeader(pingImplicitLen_);
+      if (restoreState != RADIOLIB_ERR_NONE) {
+        LOG_WARN_VAL("RadioSX1262: не удалось вернуть implicit header после ping, код=", restoreState);
+        implicitHeaderEnabled_ = false;
+        implicitHeaderLength_ = 0;
+      } else {
+        implicitHeaderEnabled_ = true;
+        implicitHeaderLength_ = pingImplicitLen_;
+      }
+    } else {
+      implicitHeaderEnabled_ = false;
+      implicitHeaderLength_ = 0;
     }
+  }
+  if (role_ == Role::UPLINK) {                            // ответ слушали на RX-частоте, аплинк возвращается на TX
+    enterIdle("ping: возврат аплинка в standby");
+  }
+  lastError_ = result;
+}
 
-    if (success || errorOccurred) {                       // либо получили ответ, либо поймали ошибку
-      break;
-    }
 
-    startReceiveWithRetry("ping: ожидание ответа");
-    LOG_WARN("RadioSX1262: пинг-ответ не получен — истёк таймаут %lu мкс",
-             static_cast<unsigned long>(timeoutUs));
-    lastError_ = ERR_PING_TIMEOUT;
-    result = lastError_;
-  } while (false);
 
-  restoreImplicit();
+void RadioSX1262::setReceiveCallback(RxCallback cb) { rx_cb_ = cb; }
+
+void RadioSX1262::setReceiveFrameCallback(RxFrameCallback cb) { rx_frame_cb_ = cb; }
+
+// Кадр со всеми пакетами уходит в оба колбэка; неполный — только в колбэк кадров,
+// которому карта потерянных пакетов служит подсказкой стираний
+void RadioSX1262::deliverFrame(const uint8_t* data, size_t len, const subpacket::FrameInfo& info) {
+  if (!info.complete) {
+    LOG_WARN("RadioSX1262: кадр собран с потерями: пакетов %u, потеряно 0x%08lX",
+             static_cast<unsigned>(info.chunks), static_cast<unsigned long>(info.missingMask));
+  }
+  if (rx_frame_cb_) {
+    rx_frame_cb_(data, len, info);
+  } else if (rx_cb_ && info.complete) {
+    rx_cb_(data, len);
+  }
+}
 
-  return result;
+uint32_t RadioSX1262::airtimeUs(size_t len) const {
+  if (len == 0) return 0;
+  lora_airtime::ModemParams params = makeModemParams(getBandwidth(), getSpreadingFactor(), getCodingRate());
+  // Повторяем нарезку send(): в implicit-режиме каждый кадр дополняется до фиксированной длины
+  const bool enforceImplicit = implicitHeaderEnabled_ && implicitHeaderLength_ > 0;
+  params.implicitHeader = enforceImplicit;
+  const size_t capacity = enforceImplicit ? std::min(implicitHeaderLength_, MAX_PACKET_SIZE) : MAX_PACKET_SIZE;
+  return lora_airtime::frameTimeOnAirUs(params, len, capacity, MAX_PACKET_SIZE, subpacket::OVERHEAD);
 }
 
+// Время в эфире одного LoRa-пакета длиной len байт при текущем режиме заголовка (мкс)
+uint32_t RadioSX1262::packetAirtimeUs(size_t len) const {
+  lora_airtime::ModemParams params = makeModemParams(getBandwidth(), getSpreadingFactor(), getCodingRate());
+  params.implicitHeader = implicitHeaderEnabled_ && implicitHeaderLength_ > 0;
+  return lora_airtime::timeOnAirUs(params, len);
+}
 
+size_t RadioSX1262::packetCapacity() const {
+  const bool enforceImplicit = implicitHeaderEnabled_ && implicitHeaderLength_ > 0;
+  return enforceImplicit ? std::min(implicitHeaderLength_, MAX_PACKET_SIZE) : MAX_PACKET_SIZE;
+}
 
-void RadioSX1262::setReceiveCallback(RxCallback cb) { rx_cb_ = cb; }
+void RadioSX1262::applyHeaderMode(bool force) {
+  const auto& radioDefaults = LoRaRadioLibSettings::DEFAULT_OPTIONS;
+  bool implicit = radioDefaults.implicitHeader && radioDefaults.implicitPayloadLength > 0;
+  size_t length = implicit ? radioDefaults.implicitPayloadLength : 0;
+  if (radioDefaults.autoHeaderMode) {
+    // Режим определяется только общими настройками модема — обе стороны выбирают одинаково
+    const auto& refs = LoRaRadioLibSettings::HEADER_MODE_REFERENCE_LENGTHS;
+    const auto& table = LoRaRadioLibSettings::IMPLICIT_LENGTH_TABLE;
+    const lora_airtime::HeaderChoice choice = lora_airtime::chooseHeaderMode(
+        makeModemParams(getBandwidth(), getSpreadingFactor(), getCodingRate()),
+        refs, sizeof(refs) / sizeof(refs[0]), table, sizeof(table) / sizeof(table[0]), MAX_PACKET_SIZE,
+        subpacket::OVERHEAD);
+    implicit = choice.implicitHeader;
+    length = choice.implicitLength;
+  }
+  if (!force && implicit == implicitHeaderEnabled_ && length == implicitHeaderLength_) {
+    return;                                         // режим не изменился
+  }
+
+  if (implicit) {
+    const int16_t hdrState = radio_.implicitHeader(length);
+    if (hdrState != RADIOLIB_ERR_NONE) {
+      LOG_WARN_VAL("RadioSX1262: не удалось включить implicit header длиной ", static_cast<int>(length));
+      LOG_WARN_VAL("RadioSX1262: код ошибки implicit header=", hdrState);
+      return;
+    }
+    implicitHeaderEnabled_ = true;
+    implicitHeaderLength_ = length;
+    DEBUG_LOG("RadioSX1262: включён режим фиксированной длины %u байт",
+              static_cast<unsigned>(implicitHeaderLength_));
+  } else {
+    const int16_t hdrState = radio_.explicitHeader();
+    if (hdrState != RADIOLIB_ERR_NONE) {
+      LOG_WARN_VAL("RadioSX1262: не удалось включить explicit header, код=", hdrState);
+      return;
+    }
+    implicitHeaderEnabled_ = false;
+    implicitHeaderLength_ = 0;
+    DEBUG_LOG("RadioSX1262: включён явный заголовок (explicit header)");
+  }
+}
 
 int16_t RadioSX1262::ensureReceiveMode() {
-  ScopedRadioLock guard(*this);
-  const int16_t lockState = guard.acquire(toTicks(LOCK_TIMEOUT_MS));
-  if (lockState != RADIOLIB_ERR_NONE) {
-    LOG_WARN("RadioSX1262: ensureReceiveMode отклонён — радио занято");
-    lastError_ = lockState;
-    return lastError_;
+  if (txActive_ || role_ == Role::UPLINK) {
+    return RADIOLIB_ERR_NONE;                // приём запустится по окончании передачи; аплинк не принимает
+  }
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return ensureReceiveMode(); });
+  }
+  if (cadActive_ && (millis() - cadStartedMs_) < cadTimeoutMs_) {
+    return RADIOLIB_ERR_NONE;                // приём будет восстановлен по завершении CAD
   }
   const float freq_rx = fRX_bank_[static_cast<int>(bank_)][channel_];
   if (!setFrequency(freq_rx)) {
@@ -364,6 +658,76 @@ int16_t RadioSX1262::ensureReceiveMode() {
   return lastError_;
 }
 
+int16_t RadioSX1262::startChannelScan() {
+  if (txActive_ || pingActive_) {
+    return ERR_TIMEOUT;                      // идёт передача или пинг — канал проверим позже
+  }
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return startChannelScan(); });
+  }
+  cadDone_ = false;
+  cadDetected_ = false;
+  if (packetReady_) {                        // пакет уже принят и не прочитан — эфир заведомо занят
+    cadActive_ = true;
+    cadDone_ = true;
+    cadDetected_ = true;
+    cadStartedMs_ = millis();
+    return RADIOLIB_ERR_NONE;
+  }
+  // Чужая передача слышна на частоте приёма, на ней же и проверяем канал
+  const float freq_rx = fRX_bank_[static_cast<int>(bank_)][channel_];
+  if (!setFrequency(freq_rx)) {
+    LOG_WARN_VAL("RadioSX1262: не удалось установить RX-частоту для CAD, код=", lastError_);
+    return lastError_;
+  }
+  const int16_t state = radio_.startChannelScan();
+  if (state != RADIOLIB_ERR_NONE) {
+    LOG_WARN_VAL("RadioSX1262: startChannelScan() вернул код=", state);
+    lastError_ = state;
+    enterIdle("startChannelScan: возврат к приёму после ошибки CAD");
+    return state;
+  }
+  // CAD занимает несколько символов; с запасом ждём 16 символов и 10 мс на обработку IRQ
+  const uint32_t symbolUs = lora_airtime::symbolTimeUs(getBandwidth(),
+                                                       static_cast<uint8_t>(getSpreadingFactor()));
+  cadTimeoutMs_ = symbolUs * 16U / 1000U + 10U;
+  cadStartedMs_ = millis();
+  cadActive_ = true;
+  return RADIOLIB_ERR_NONE;
+}
+
+ChannelState RadioSX1262::pollChannelScan() {
+  if (!cadActive_) {
+    return ChannelState::UNSUPPORTED;
+  }
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return pollChannelScan(); });
+  }
+  flushPendingIrqLog();                      // CAD_DONE приходит через DIO1
+  if (!cadDone_) {
+    if ((millis() - cadStartedMs_) < cadTimeoutMs_) {
+      return ChannelState::PENDING;
+    }
+    LOG_WARN("RadioSX1262: CAD не завершился за %u мс", static_cast<unsigned>(cadTimeoutMs_));
+    finishChannelScan("pollChannelScan: возврат к приёму после тайм-аута CAD");
+    return ChannelState::UNSUPPORTED;
+  }
+  const bool detected = cadDetected_;
+  finishChannelScan("pollChannelScan: возврат к приёму после CAD");
+  DEBUG_LOG(detected ? "RadioSX1262: CAD — канал занят" : "RadioSX1262: CAD — канал свободен");
+  return detected ? ChannelState::BUSY : ChannelState::CLEAR;
+}
+
+void RadioSX1262::finishChannelScan(const char* context) {
+  cadActive_ = false;
+  cadDone_ = false;
+  cadDetected_ = false;
+  if (packetReady_) {
+    return;                                  // приём перезапустит loop() после чтения пакета
+  }
+  enterIdle(context);
+}
+
 // Получить SNR последнего принятого пакета
 float RadioSX1262::getLastSnr() const { return lastSnr_; }
 
@@ -371,27 +735,68 @@ float RadioSX1262::getLastSnr() const { return lastSnr_; }
 float RadioSX1262::getLastRssi() const { return lastRssi_; }
 
 // Получить случайный байт из встроенного генератора
-uint8_t RadioSX1262::randomByte() { return radio_.randomByte(); }
+uint8_t RadioSX1262::randomByte() {
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return randomByte(); });
+  }
+  return radio_.randomByte();
+}
 
 bool RadioSX1262::setBank(ChannelBank bank) {
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return setBank(bank); });
+  }
+  waitTransmitIdle();
   bank_ = bank;
   channel_ = 0;
-  return setFrequency(fRX_bank_[static_cast<int>(bank_)][channel_]);
+  bool ok = setFrequency(idleFrequency());
+  if (peer_) ok = peer_->setBank(bank) && ok;         // частоты даунлинка из того же банка
+  return ok;
 }
 
 bool RadioSX1262::setChannel(uint8_t ch) {
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return setChannel(ch); });
+  }
+  waitTransmitIdle();
   // проверяем, что канал входит в диапазон текущего банка
   if (ch >= BANK_CHANNELS_[static_cast<int>(bank_)]) return false;
   channel_ = ch;
-  return setFrequency(fRX_bank_[static_cast<int>(bank_)][channel_]);
+  bool ok = setFrequency(idleFrequency());
+  if (peer_) ok = peer_->setChannel(ch) && ok;
+  return ok;
 }
 
 bool RadioSX1262::setFrequency(float freq) {
   int state = radio_.setFrequency(freq);      // задаём частоту
   lastError_ = state;                         // запоминаем результат операции
+  currentFrequency_ = (state == RADIOLIB_ERR_NONE) ? freq : 0.0f;
   return state == RADIOLIB_ERR_NONE;          // возвращаем успех
 }
 
+float RadioSX1262::idleFrequency() const {
+  const int bank = static_cast<int>(bank_);
+  return role_ == Role::UPLINK ? fTX_bank_[bank][channel_] : fRX_bank_[bank][channel_];
+}
+
+bool RadioSX1262::enterIdle(const char* context) {
+  // Аплинк после собственной серии уже стоит на TX-частоте — лишняя перестройка не нужна
+  const bool retune = role_ != Role::UPLINK || currentFrequency_ != idleFrequency();
+  if (retune && !setFrequency(idleFrequency())) {
+    LOG_WARN_VAL("RadioSX1262: не удалось вернуть рабочую частоту, код=", lastError_);
+    return false;
+  }
+  if (role_ != Role::UPLINK) {
+    return startReceiveWithRetry(context);
+  }
+  const int16_t state = radio_.standby();     // аплинк не слушает эфир: DIO1 приходит только от TX/CAD
+  lastError_ = state;
+  if (state != RADIOLIB_ERR_NONE) {
+    LOG_WARN_VAL("RadioSX1262: standby() аплинка завершился ошибкой, код=", state);
+  }
+  return state == RADIOLIB_ERR_NONE;
+}
+
 bool RadioSX1262::startReceiveWithRetry(const char* context) {
   constexpr uint8_t kMaxAttempts = 3;                     // ограничиваем число повторов
   const char* ctx = (context && context[0] != '\0') ? context : "без контекста";
@@ -439,6 +844,10 @@ bool RadioSX1262::startReceiveWithRetry(const char* context) {
 }
 
 bool RadioSX1262::setBandwidth(float bw) {
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return setBandwidth(bw); });
+  }
+  waitTransmitIdle();
   int idx = -1;
   for (int i = 0; i < 5; ++i) {
     if (std::fabs(BW_[i] - bw) < 0.01f) { idx = i; break; }
@@ -446,10 +855,16 @@ bool RadioSX1262::setBandwidth(float bw) {
   if (idx < 0) return false;                           // значение не из таблицы
   bw_preset_ = idx;
   int state = radio_.setBandwidth(bw);                 // задаём полосу пропускания
+  if (state == RADIOLIB_ERR_NONE) applyHeaderMode(false); // выгодный режим заголовка зависит от SF/BW/CR
+  if (peer_ && !peer_->setBandwidth(bw)) return false; // приёмник пары обязан совпадать по модему
   return state == RADIOLIB_ERR_NONE;                   // возвращаем успех
 }
 
 bool RadioSX1262::setSpreadingFactor(int sf) {
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return setSpreadingFactor(sf); });
+  }
+  waitTransmitIdle();
   int idx = -1;
   for (int i = 0; i < 8; ++i) {
     if (SF_[i] == sf) { idx = i; break; }
@@ -457,10 +872,16 @@ bool RadioSX1262::setSpreadingFactor(int sf) {
   if (idx < 0) return false;                           // недопустимое значение
   sf_preset_ = idx;
   int state = radio_.setSpreadingFactor(sf);           // задаём фактор расширения
+  if (state == RADIOLIB_ERR_NONE) applyHeaderMode(false); // выгодный режим заголовка зависит от SF/BW/CR
+  if (peer_ && !peer_->setSpreadingFactor(sf)) return false;
   return state == RADIOLIB_ERR_NONE;                   // возвращаем успех
 }
 
 bool RadioSX1262::setCodingRate(int cr) {
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return setCodingRate(cr); });
+  }
+  waitTransmitIdle();
   int idx = -1;
   for (int i = 0; i < 4; ++i) {
     if (CR_[i] == cr) { idx = i; break; }
@@ -468,10 +889,16 @@ bool RadioSX1262::setCodingRate(int cr) {
   if (idx < 0) return false;                           // недопустимое значение
   cr_preset_ = idx;
   int state = radio_.setCodingRate(cr);                // задаём коэффициент кодирования
+  if (state == RADIOLIB_ERR_NONE) applyHeaderMode(false); // выгодный режим заголовка зависит от SF/BW/CR
+  if (peer_ && !peer_->setCodingRate(cr)) return false;
   return state == RADIOLIB_ERR_NONE;                   // возвращаем успех
 }
 
 bool RadioSX1262::setPower(uint8_t preset) {
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return setPower(preset); });
+  }
+  waitTransmitIdle();
   if (preset >= 10) return false;                      // индекс вне диапазона
   pw_preset_ = preset;
   int state = radio_.setOutputPower(Pwr_[pw_preset_]); // установка мощности
@@ -479,7 +906,14 @@ bool RadioSX1262::setPower(uint8_t preset) {
 }
 
 bool RadioSX1262::setRxBoostedGainMode(bool enabled) {
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return setRxBoostedGainMode(enabled); });
+  }
+  waitTransmitIdle();
   int state = radio_.setRxBoostedGainMode(enabled, true); // устанавливаем режим LNA
+  if (peer_ && !peer_->setRxBoostedGainMode(enabled)) {   // усиление важно прежде всего приёмнику пары
+    return false;
+  }
   if (state == RADIOLIB_ERR_NONE) {
     rxBoostedGainEnabled_ = enabled;                     // сохраняем текущее состояние
     return true;
@@ -488,13 +922,10 @@ bool RadioSX1262::setRxBoostedGainMode(bool enabled) {
 }
 
 int16_t RadioSX1262::resetToDefaults() {
-  ScopedRadioLock guard(*this);
-  const int16_t lockState = guard.acquire(toTicks(LOCK_TIMEOUT_MS));
-  if (lockState != RADIOLIB_ERR_NONE) {
-    LOG_WARN("RadioSX1262: resetToDefaults отклонён — радио занято");
-    lastError_ = lockState;
-    return lastError_;
+  if (needsOwnerHop()) {
+    return runOnOwner([&]() { return resetToDefaults(); });
   }
+  waitTransmitIdle();
 
   lastError_ = RADIOLIB_ERR_NONE;                // сбрасываем сохранённый код ошибки
   const auto& cfg = ConfigLoader::getConfig();   // читаем загруженную конфигурацию
@@ -548,8 +979,9 @@ int16_t RadioSX1262::resetToDefaults() {
   tcxo_ = radioDefaults.useDio3ForTcxo ? radioDefaults.tcxoVoltage : 0.0f; // используем ли внешний TCXO
   const uint8_t syncWord = static_cast<uint8_t>(radioDefaults.syncWord & 0xFFU); // младший байт синхрослова
 
+  currentFrequency_ = 0.0f;                       // enterIdle() ниже установит частоту явно
   int state = radio_.begin(
-      fRX_bank_[static_cast<int>(bank_)][channel_],
+      idleFrequency(),
       BW_[bw_preset_], SF_[sf_preset_], CR_[cr_preset_],
       syncWord, Pwr_[pw_preset_], radioDefaults.preambleLength, tcxo_, radioDefaults.enableRegulatorDCDC);
   if (state != RADIOLIB_ERR_NONE) {
@@ -571,7 +1003,9 @@ int16_t RadioSX1262::resetToDefaults() {
           RADIOLIB_SX126X_IRQ_CRC_ERR,
       RADIOLIB_SX126X_IRQ_NONE,
       RADIOLIB_SX126X_IRQ_NONE);
-  radio_.setDio1Action(onDio1Static);                     // колбэк приёма
+  if (slot_ >= 0) {
+    radio_.setDio1Action(slot_ == 0 ? onDio1Slot0 : onDio1Slot1); // колбэк приёма этого модуля
+  }
 
   const uint8_t crcLen = radioDefaults.enableCrc ? 2 : 0; // CRC LoRa: 2 байта или отключено
   const int16_t crcState = radio_.setCRC(crcLen);
@@ -585,41 +1019,31 @@ int16_t RadioSX1262::resetToDefaults() {
 
   implicitHeaderEnabled_ = false;
   implicitHeaderLength_ = 0;
-  if (radioDefaults.implicitHeader && radioDefaults.implicitPayloadLength > 0) {
-    const int16_t hdrState = radio_.implicitHeader(radioDefaults.implicitPayloadLength);
-    if (hdrState != RADIOLIB_ERR_NONE) {
-      LOG_WARN_VAL("RadioSX1262: не удалось включить implicit header длиной ", radioDefaults.implicitPayloadLength);
-      LOG_WARN_VAL("RadioSX1262: код ошибки implicit header=", hdrState);
-    } else {
-      implicitHeaderEnabled_ = true;
-      implicitHeaderLength_ = radioDefaults.implicitPayloadLength;
-      DEBUG_LOG("RadioSX1262: включён режим фиксированной длины %u байт",
-                static_cast<unsigned>(implicitHeaderLength_));
-    }
-  } else {
-    const int16_t hdrState = radio_.explicitHeader();
-    if (hdrState != RADIOLIB_ERR_NONE) {
-      LOG_WARN_VAL("RadioSX1262: не удалось включить explicit header, код=", hdrState);
-    }
-  }
+  applyHeaderMode(true);                                  // режим заголовка с минимальным временем в эфире
 
   if (!setRxBoostedGainMode(cfg.radio.rxBoostedGain)) {   // применение усиления по умолчанию
     rxBoostedGainEnabled_ = false;                        // фиксируем фактическое состояние
     LOG_WARN("RadioSX1262: не удалось установить RX boosted gain");
   }
-  if (!startReceiveWithRetry("resetToDefaults: запуск приёма")) {
+  if (!enterIdle("resetToDefaults: запуск приёма")) {
     return lastError_;                                    // не удалось войти в режим RX
   }
-  DEBUG_LOG("RadioSX1262: запуск приёма после применения настроек по умолчанию на частоте %.3f МГц",
-            static_cast<double>(fRX_bank_[static_cast<int>(bank_)][channel_]));
+  DEBUG_LOG("RadioSX1262: настройки по умолчанию применены, ожидание на частоте %.3f МГц",
+            static_cast<double>(idleFrequency()));
   lastError_ = RADIOLIB_ERR_NONE;
   return lastError_;
 }
 
 
-void RadioSX1262::onDio1Static() {
-  if (instance_) {
-    instance_->handleDio1();
+void RadioSX1262::onDio1Slot0() {
+  if (instances_[0]) {
+    instances_[0]->handleDio1();
+  }
+}
+
+void RadioSX1262::onDio1Slot1() {
+  if (instances_[1]) {
+    instances_[1]->handleDio1();
   }
 }
 
@@ -719,6 +1143,9 @@ void RadioSX1262::logIrqFlags(uint32_t flags) {
 }
 
 void RadioSX1262::flushPendingIrqLog() {
+  if (needsOwnerHop()) {
+    return;               // IRQ разбирает задача-владелец, регистры из чужого контекста не читаем
+  }
   // Обеспечиваем обходной ручной вызов переноса IRQ-логов из ISR в основной поток
   processPendingIrqLog();
 }
@@ -726,6 +1153,16 @@ void RadioSX1262::flushPendingIrqLog() {
 void RadioSX1262::handleDio1() {
   irqNeedsRead_ = true;   // отмечаем необходимость чтения IRQ-регистров в основном потоке
   irqLogPending_ = true;  // помечаем, что требуется вывод в loop()
+#if defined(ARDUINO)
+  TaskHandle_t owner = ownerTask_.load();
+  if (owner != nullptr) {  // будим задачу-владельца сразу, не дожидаясь её тайм-аута
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(owner, &woken);
+    if (woken == pdTRUE) {
+      portYIELD_FROM_ISR();
+    }
+  }
+#endif
 }
 
 void RadioSX1262::processPendingIrqLog() {
@@ -770,22 +1207,25 @@ void RadioSX1262::processPendingIrqLog() {
 
     const bool hasRxIndicators = hasRxDone || hasHeaderValid || hasSyncValid; // есть признаки приёма
 
+    if (txActive_ && (flags & RADIOLIB_SX126X_IRQ_TX_DONE) != 0U) {
+      txDoneIrq_ = true;                                   // фрагмент передан, автомат TX продолжит серию
+    }
+    if (cadActive_ && (flags & RADIOLIB_SX126X_IRQ_CAD_DONE) != 0U) {
+      cadDone_ = true;                                     // результат CAD забирает pollChannelScan()
+      cadDetected_ = (flags & RADIOLIB_SX126X_IRQ_CAD_DETECTED) != 0U;
+    }
+
     bool recoverableImplicitHeaderError = false;
     if (hasHeaderError && hasRxDone && implicitHeaderEnabled_) {
       recoverableImplicitHeaderError = true; // событие характерно для длинного кадра в implicit-режиме
       LOG_WARN("RadioSX1262: обнаружен пакет длиннее implicit-лимита %u байт — переключаемся на явный заголовок", 
                static_cast<unsigned>(implicitHeaderLength_));
-      ScopedRadioLock guard(*this);
-      if (guard.acquire(toTicks(0)) == RADIOLIB_ERR_NONE) {
-        const int16_t headerState = radio_.explicitHeader();
-        if (headerState == RADIOLIB_ERR_NONE) {
-          implicitHeaderEnabled_ = false; // сбрасываем implicit, чтобы принимать переменную длину
-          implicitHeaderLength_ = 0;
-        } else {
-          LOG_WARN_VAL("RadioSX1262: не удалось отключить implicit header, код=", headerState);
-        }
+      const int16_t headerState = radio_.explicitHeader();
+      if (headerState == RADIOLIB_ERR_NONE) {
+        implicitHeaderEnabled_ = false; // сбрасываем implicit, чтобы принимать переменную длину
+        implicitHeaderLength_ = 0;
       } else {
-        LOG_WARN("RadioSX1262: не удалось захватить мьютекс радио для переключения режима заголовка");
+        LOG_WARN_VAL("RadioSX1262: не удалось отключить implicit header, код=", headerState);
       }
     }
 
@@ -855,16 +1295,51 @@ void RadioSX1262::setIrqLogCallback(IrqLogCallback cb) {
 
 // Проверка флага готовности и чтение данных
 void RadioSX1262::loop() {
-  flushPendingIrqLog();                    // отложенный вывод статусов IRQ
-  if (!packetReady_) {                      // пакет пока не готов
+  if (taskRunning_) {
+    processRxRing(false);                   // эфир обслуживает задача-владелец, здесь только разбор
     return;
   }
-  ScopedRadioLock guard(*this);             // защищаем доступ к радиомодулю из фонового цикла
-  const int16_t lockState = guard.acquire(toTicks(0));
-  if (lockState != RADIOLIB_ERR_NONE) {     // другой поток (ping/отправка) удерживает мьютекс
-    DEBUG_LOG("RadioSX1262: loop пропущен — радио занято внешней операцией");
-    return;                                 // повторим обработку, когда передача завершится
+  serviceOwner();
+  if (txActive_) {
+    return;
   }
+  processRxRing(true);
+}
+
+// Разбор слотов идёт, пока радио уже слушает эфир. Без задачи-владельца пакет, пришедший
+// за это время, забирается из FIFO между слотами и не теряется
+void RadioSX1262::processRxRing(bool readBetweenSlots) {
+  size_t head = rxHead_.load(std::memory_order_relaxed);
+  if (head == rxTail_.load(std::memory_order_acquire)) {
+    assembler_.poll(millis());              // неполный кадр отдаём по тайм-ауту
+    return;
+  }
+  while (head != rxTail_.load(std::memory_order_acquire)) {
+    processRxSlot(rxRing_[head % RX_RING_SLOTS]);
+    rxHead_.store(++head, std::memory_order_release); // слот свободен для владельца
+    if (readBetweenSlots) {
+      flushPendingIrqLog();
+      if (packetReady_ && !txActive_ && !pingActive_) {
+        readPacketToRing();
+      }
+    }
+  }
+}
+
+// Один проход владельца радио: разбор IRQ, продвижение передачи, чтение FIFO
+void RadioSX1262::serviceOwner() {
+  processPendingIrqLog();                   // отложенный вывод статусов IRQ
+  if (txActive_) {
+    serviceTransmit(false);                 // следующий фрагмент или возврат к приёму
+    return;
+  }
+  if (packetReady_ && !pingActive_) {        // ответ на пинг забирает pollPing()
+    readPacketToRing();                     // FIFO → кольцо, приём перезапускается сразу
+  }
+}
+
+// Чтение принятого пакета в свободный слот кольца и немедленный перезапуск приёма
+bool RadioSX1262::readPacketToRing() {
   size_t len = radio_.getPacketLength();    // длина доступного пакета после фильтра IRQ
   // При завершении передачи длина пакета может быть мусорной и вызвать
   // выделение огромного буфера, что приводит к перезагрузке
@@ -872,59 +1347,79 @@ void RadioSX1262::loop() {
     packetReady_ = false;                   // сбрасываем флаг
     startReceiveWithRetry("loop: восстановление после некорректной длины");
     DEBUG_LOG("RadioSX1262: перезапуск приёма после мусорной длины пакета в loop");
-    return;
+    return false;
   }
-  std::array<uint8_t, 256> buf;            // статический буфер на стеке
-  int state = radio_.readData(buf.data(), len);
-  if (state == RADIOLIB_ERR_NONE) {
-    lastSnr_ = radio_.getSNR();             // сохраняем SNR
-    lastRssi_ = radio_.getRSSI();           // сохраняем RSSI
-    // Формируем шестнадцатеричный дамп полезной нагрузки для отладочного лога
-    std::array<char, 3 * 256 + 1> hexDump{};
-    size_t hexOffset = 0;
-    bool truncated = false;
-    for (size_t i = 0; i < len; ++i) {
-      const size_t remaining = hexDump.size() - hexOffset;
-      if (remaining <= 4) {                 // оставляем место под завершающий нуль
-        truncated = true;
-        break;
-      }
-      const int written = std::snprintf(hexDump.data() + hexOffset,
-                                        remaining,
-                                        (i == 0) ? "%02X" : " %02X",
-                                        static_cast<unsigned>(buf[i]));
-      if (written <= 0) {
-        truncated = true;
-        break;
-      }
-      const size_t writtenSize = static_cast<size_t>(written);
-      if (writtenSize >= remaining) {
-        truncated = true;
-        hexOffset = hexDump.size() - 1;
-        break;
-      }
-      hexOffset += writtenSize;
-    }
-    const char* dumpText = hexDump.data();
-    if (truncated) {
-      DEBUG_LOG("RadioSX1262: принят пакет длиной %u байт, дамп усечён: %s",
-                static_cast<unsigned>(len),
-                dumpText);
+  bool stored = false;
+  const size_t tail = rxTail_.load(std::memory_order_relaxed);
+  if (tail - rxHead_.load(std::memory_order_acquire) < RX_RING_SLOTS) {
+    RxSlot& slot = rxRing_[tail % RX_RING_SLOTS];
+    const int state = radio_.readData(slot.data.data(), len);
+    if (state == RADIOLIB_ERR_NONE) {
+      slot.len = len;
+      slot.snr = radio_.getSNR();           // параметры именно этого пакета
+      slot.rssi = radio_.getRSSI();
+      rxTail_.store(tail + 1, std::memory_order_release); // слот виден потребителю
+      stored = true;
+      lastError_ = RADIOLIB_ERR_NONE;       // читаем без ошибок
     } else {
-      DEBUG_LOG("RadioSX1262: принят пакет длиной %u байт: %s",
-                static_cast<unsigned>(len),
-                dumpText);
+      lastError_ = state;                   // фиксируем код сбоя чтения
+    }
+  } else {
+    ++rxRingOverflows_;                     // обработка не успевает за эфиром — пакет теряется
+    LOG_WARN("RadioSX1262: кольцо приёма заполнено, пакет %u байт отброшен", static_cast<unsigned>(len));
+  }
+  packetReady_ = false;                     // FIFO прочитан
+  startReceiveWithRetry("loop: перезапуск приёма после чтения пакета");
+  return stored;
+}
+
+// Разбор пакета из кольца: отладочный дамп и сборка кадра
+void RadioSX1262::processRxSlot(const RxSlot& slot) {
+  const size_t len = slot.len;
+  lastSnr_ = slot.snr;                      // сохраняем SNR
+  lastRssi_ = slot.rssi;                    // сохраняем RSSI
+  // Формируем шестнадцатеричный дамп полезной нагрузки для отладочного лога
+  std::array<char, 3 * 256 + 1> hexDump{};
+  size_t hexOffset = 0;
+  bool truncated = false;
+  for (size_t i = 0; i < len; ++i) {
+    const size_t remaining = hexDump.size() - hexOffset;
+    if (remaining <= 4) {                   // оставляем место под завершающий нуль
+      truncated = true;
+      break;
     }
-    if (rx_cb_) {
-      rx_cb_(buf.data(), len);              // передаём данные пользователю
+    const int written = std::snprintf(hexDump.data() + hexOffset,
+                                      remaining,
+                                      (i == 0) ? "%02X" : " %02X",
+                                      static_cast<unsigned>(slot.data[i]));
+    if (written <= 0) {
+      truncated = true;
+      break;
+    }
+    const size_t writtenSize = static_cast<size_t>(written);
+    if (writtenSize >= remaining) {
+      truncated = true;
+      hexOffset = hexDump.size() - 1;
+      break;
     }
-    lastError_ = RADIOLIB_ERR_NONE;         // читаем без ошибок
+    hexOffset += writtenSize;
+  }
+  const char* dumpText = hexDump.data();
+  if (truncated) {
+    DEBUG_LOG("RadioSX1262: принят пакет длиной %u байт, дамп усечён: %s",
+              static_cast<unsigned>(len),
+              dumpText);
   } else {
-    lastError_ = state;                     // фиксируем код сбоя чтения
+    DEBUG_LOG("RadioSX1262: принят пакет длиной %u байт: %s",
+              static_cast<unsigned>(len),
+              dumpText);
+  }
+  (void)dumpText;
+  // Ждать следующий пакет кадра не дольше двух длительностей пакета с запасом на разворот
+  assembler_.setTimeout(packetAirtimeUs(packetCapacity()) * 2U / 1000U + 100U);
+  if (!assembler_.push(slot.data.data(), len, packetCapacity(), millis())) {
+    DEBUG_LOG("RadioSX1262: пакет без корректного маркера отброшен");
   }
-  packetReady_ = false;                     // пакет обработан
-  startReceiveWithRetry("loop: перезапуск приёма после обработки пакета");
-  DEBUG_LOG("RadioSX1262: перезапуск приёма после обработки пакета в loop");
 }
 
 int16_t RadioSX1262::sendBeacon() {
@@ -937,44 +1432,139 @@ int16_t RadioSX1262::sendBeacon() {
   return send(beacon, sizeof(beacon));    // отправляем как обычный пакет
 }
 
-TickType_t RadioSX1262::toTicks(uint32_t timeoutMs) const {
+bool RadioSX1262::startTask(uint8_t core) {
+  if (taskRunning_) {
+    return true;
+  }
+  taskRunning_ = true;
 #if defined(ARDUINO)
-  return pdMS_TO_TICKS(timeoutMs);
+  TaskHandle_t handle = nullptr;
+#if defined(ESP32)
+  const BaseType_t created = xTaskCreatePinnedToCore(&RadioSX1262::ownerTaskEntry, "radio", TASK_STACK_SIZE,
+                                                     this, TASK_PRIORITY, &handle, core);
 #else
-  return static_cast<TickType_t>(timeoutMs);
+  const BaseType_t created = xTaskCreate(&RadioSX1262::ownerTaskEntry, "radio", TASK_STACK_SIZE,
+                                         this, TASK_PRIORITY, &handle);
 #endif
+  if (created != pdPASS) {
+    taskRunning_ = false;
+    LOG_ERROR("RadioSX1262: не удалось создать задачу-владельца радио");
+    return false;
+  }
+  ownerTask_ = handle;
+#else
+  ownerThread_ = std::thread(&RadioSX1262::ownerLoop, this);
+#endif
+  LOG_INFO("RadioSX1262: задача-владелец радио запущена на ядре %u", static_cast<unsigned>(core));
+  return true;
 }
 
-int16_t RadioSX1262::lockRadio(TickType_t timeout) {
+void RadioSX1262::stopTask() {
+  if (!taskRunning_) {
+    return;
+  }
+  taskRunning_ = false;
 #if defined(ARDUINO)
-  if (radioMutex_ == nullptr) {
-    radioMutex_ = xSemaphoreCreateMutex();             // создаём мьютекс при первом обращении
-    if (radioMutex_ == nullptr) {
-      LOG_ERROR("RadioSX1262: не удалось создать мьютекс доступа к SX1262");
-      return ERR_TIMEOUT;
-    }
+  wakeOwner();
+  while (ownerTask_.load() != nullptr) {
+    delay(1);                                          // задача удаляет себя сама после выхода из цикла
   }
-  const BaseType_t taken = xSemaphoreTake(radioMutex_, timeout);
-  return (taken == pdTRUE) ? RADIOLIB_ERR_NONE : ERR_TIMEOUT;
 #else
-  if (timeout == portMAX_DELAY) {
-    radioMutex_.lock();
-    return RADIOLIB_ERR_NONE;
+  if (ownerThread_.joinable()) {
+    ownerThread_.join();
   }
-  const auto duration = std::chrono::milliseconds(timeout);
-  if (radioMutex_.try_lock_for(duration)) {
-    return RADIOLIB_ERR_NONE;
+#endif
+}
+
+bool RadioSX1262::needsOwnerHop() const {
+  if (!taskRunning_) {
+    return false;
   }
-  return ERR_TIMEOUT;
+#if defined(ARDUINO)
+  return xTaskGetCurrentTaskHandle() != ownerTask_.load();
+#else
+  return gOwnerContext != this;
+#endif
+}
+
+// Передача команды владельцу и ожидание её выполнения; команда живёт на стеке вызывающего
+void RadioSX1262::postAndWait(Command& cmd) {
+#if defined(ARDUINO)
+  cmd.waiter = xTaskGetCurrentTaskHandle();
+#endif
+  while (!commands_.tryPush(&cmd)) {
+#if defined(ARDUINO)
+    delay(1);                                          // очередь рассчитана на всех вызывающих
+#else
+    std::this_thread::yield();
+#endif
+  }
+  wakeOwner();
+  while (!cmd.done.load(std::memory_order_acquire)) {
+#if defined(ARDUINO)
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+#else
+    std::this_thread::yield();
+#endif
+  }
+}
+
+void RadioSX1262::drainCommands() {
+  Command* cmd = nullptr;
+  while (commands_.tryPop(cmd)) {
+    cmd->invoke(cmd->ctx);
+#if defined(ARDUINO)
+    TaskHandle_t waiter = cmd->waiter;                 // после done команда может исчезнуть
+#endif
+    cmd->done.store(true, std::memory_order_release);
+#if defined(ARDUINO)
+    xTaskNotifyGive(waiter);
 #endif
+  }
 }
 
-void RadioSX1262::unlockRadio() {
+void RadioSX1262::wakeOwner() {
 #if defined(ARDUINO)
-  if (radioMutex_ != nullptr) {
-    xSemaphoreGive(radioMutex_);
+  TaskHandle_t owner = ownerTask_.load();
+  if (owner != nullptr) {
+    xTaskNotifyGive(owner);
   }
+#endif
+}
+
+void RadioSX1262::waitOwnerEvent(uint32_t timeoutMs) {
+#if defined(ARDUINO)
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));  // DIO1 и новые команды будят раньше
 #else
-  radioMutex_.unlock();
+  (void)timeoutMs;
+  std::this_thread::sleep_for(std::chrono::microseconds(200));
+#endif
+}
+
+// Цикл задачи-владельца: команды, IRQ, передача и приём выполняются только здесь
+void RadioSX1262::ownerLoop() {
+#if defined(ARDUINO)
+  ownerTask_ = xTaskGetCurrentTaskHandle();            // задача может стартовать раньше возврата из xTaskCreate
+#else
+  gOwnerContext = this;
+#endif
+  while (taskRunning_) {
+    drainCommands();
+    serviceOwner();
+    // Во время передачи и CAD просыпаемся чаще: TX_DONE читается из регистра и без DIO1
+    waitOwnerEvent((txActive_ || cadActive_ || pingActive_) ? 1U : OWNER_IDLE_WAIT_MS);
+  }
+  drainCommands();                                     // не оставляем вызывающих без ответа
+#if !defined(ARDUINO)
+  gOwnerContext = nullptr;
+#endif
+}
+
+void RadioSX1262::ownerTaskEntry(void* arg) {
+  auto* self = static_cast<RadioSX1262*>(arg);
+  self->ownerLoop();
+#if defined(ARDUINO)
+  self->ownerTask_ = nullptr;
+  vTaskDelete(nullptr);
 #endif
 }
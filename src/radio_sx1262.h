@@ -1,23 +1,20 @@
 #pragma once
 #include <RadioLib.h>
+#include <array>
+#include <atomic>
 #include <vector>
 #include <cstdint>
 #include <type_traits>
 #include <utility>
 #include "radio_interface.h"
 #include "channel_bank.h"
+#include "libs/lockfree/mpsc_queue.h"
 
 #if defined(ARDUINO)
 #include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
+#include <freertos/task.h>
 #else
-#include <mutex>
-#include <chrono>
-#include <limits>
-using TickType_t = uint32_t;                             // эквивалент FreeRTOS-типа для тестовой среды
-#ifndef portMAX_DELAY
-static constexpr TickType_t portMAX_DELAY = std::numeric_limits<TickType_t>::max();
-#endif
+#include <thread>
 #endif
 
 // Вспомогательные признаки для определения доступного варианта IRQ-API в RadioLib
@@ -80,33 +77,88 @@ int16_t CallPointerGetIrqStatus(Radio&, uint16_t*, long) {
 // Реализация радиоинтерфейса на базе SX1262
 class RadioSX1262 : public IRadio {
 public:
+  // Назначение модуля: одно радио на приём и передачу либо половина дуплексной пары
+  enum class Role : uint8_t {
+    HALF_DUPLEX,   // передача на TX-частоте, между сериями — приём на RX-частоте
+    UPLINK,        // только передача: модуль стоит на TX-частоте в standby
+    DOWNLINK       // только приём: модуль не покидает RX-частоту, передача запрещена
+  };
+
   RadioSX1262();
+  // Модуль на заданных выводах (NSS, DIO1, RESET, BUSY)
+  RadioSX1262(int csPin, int irqPin, int resetPin, int busyPin);
+  ~RadioSX1262();
+  // Назначение модуля; задаётся до begin()
+  void setRole(Role role) { role_ = role; }
+  Role getRole() const { return role_; }
+  // Радио приёма дуплексной пары: смена банка, канала и параметров модема повторяется на нём,
+  // чтобы обе половины работали с одинаковыми SF/BW/CR и парой частот
+  void setDuplexPeer(RadioSX1262* peer) { peer_ = peer; }
+  RadioSX1262* getDuplexPeer() const { return peer_; }
   // Инициализация модуля и установка параметров по умолчанию
   bool begin();
+  // Запуск задачи-владельца SX1262 на выбранном ядре. После запуска только она обращается
+  // к модулю: вызовы из других контекстов передаются ей командами через очередь, а loop()
+  // лишь разбирает уже прочитанные пакеты
+  bool startTask(uint8_t core = TASK_CORE);
+  // Остановка задачи-владельца и возврат к обслуживанию радио из loop()
+  void stopTask();
+  bool isTaskRunning() const { return taskRunning_; }
   // Отправка данных
   int16_t send(const uint8_t* data, size_t len) override;
+  // Серия кадров за один заход в TX: перестройка на RX и запуск приёма только в конце
+  int16_t sendBurst(const Frame* frames, size_t count, size_t& sent) override;
+  // Неблокирующая серия: фрагменты продвигаются по TX_DONE из loop()/pollSend()
+  int16_t startSendBurst(const Frame* frames, size_t count, size_t& sent) override;
+  int16_t pollSend(size_t& sent) override;
+  // Идёт ли асинхронная передача
+  bool isTransmitting() const { return txActive_; }
   // Выполнение пинга с ожиданием эха
   int16_t ping(const uint8_t* data, size_t len,
                uint8_t* response, size_t responseCapacity,
                size_t& receivedLen, uint32_t timeoutUs,
                uint32_t& elapsedUs);
+  // Неблокирующий пинг: startPing() отправляет запрос и включает приём, pollPing() возвращает
+  // ERR_PENDING до эха или тайм-аута. Пока пинг ждёт ответа, передача и CAD отклоняются
+  int16_t startPing(const uint8_t* data, size_t len, uint32_t timeoutUs);
+  int16_t pollPing(uint8_t* response, size_t responseCapacity,
+                   size_t& receivedLen, uint32_t& elapsedUs);
+  bool isPinging() const { return pingActive_; }
   // Отправка служебного маяка
   int16_t sendBeacon();
   // Обработка готовности пакета в основном цикле
   void loop();
   // Установка колбэка приёма
   void setReceiveCallback(RxCallback cb) override;
+  // Установка колбэка собранных кадров с картой пакетов
+  void setReceiveFrameCallback(RxFrameCallback cb) override;
   // Возвращение в режим приёма
   int16_t ensureReceiveMode() override;
+  // Время в эфире для send(len) с учётом текущих SF/BW/CR и нарезки implicit-кадров (мкс)
+  uint32_t airtimeUs(size_t len) const override;
+  // Неблокирующая проверка занятости канала (CAD) на частоте приёма
+  bool supportsChannelScan() const override { return true; }
+  int16_t startChannelScan() override;
+  ChannelState pollChannelScan() override;
   // Получение параметров последнего принятого пакета
   float getLastSnr() const;  // последний SNR
   float getLastRssi() const; // последний RSSI
   // Получить случайный байт
   uint8_t randomByte();
+  // Статистика сборки кадров из LoRa-пакетов
+  uint32_t getCompleteFrames() const { return assembler_.getCompleteFrames(); }
+  uint32_t getPartialFrames() const { return assembler_.getPartialFrames(); }
+  uint32_t getDroppedChunks() const { return assembler_.getDroppedChunks(); }
+  // Пакеты, потерянные из-за переполнения кольца приёма
+  uint32_t getRxRingOverflows() const { return rxRingOverflows_.load(); }
+  // Текущий режим заголовка PHY: implicit (фиксированная длина) или explicit
+  bool isImplicitHeader() const { return implicitHeaderEnabled_; }
+  size_t getImplicitLength() const { return implicitHeaderLength_; }
   // Получить последний код ошибки RadioLib
   int16_t getLastErrorCode() const { return lastError_; }
   static constexpr int16_t ERR_TIMEOUT = IRadio::ERR_TIMEOUT; // Propagated radio timeout error
   static constexpr int16_t ERR_PING_TIMEOUT = -31999;         // Ping-specific timeout result
+  static constexpr uint8_t TASK_CORE = 0;                     // ядро задачи-владельца по умолчанию
     // Выбор банка каналов (EAST, WEST, TEST, ALL)
     bool setBank(ChannelBank bank);
     // Выбор канала 0-166 в зависимости от банка
@@ -153,15 +205,80 @@ public:
   void setIrqLogCallback(IrqLogCallback cb);
 
 private:
-  static void onDio1Static();            // статический обработчик прерывания
+  static void onDio1Slot0();             // обработчики прерывания для каждого модуля
+  static void onDio1Slot1();
   void handleDio1();                     // обработка приёма
   void processPendingIrqLog();           // перенос логов IRQ из контекста прерывания
 
+  // Команда задаче-владельцу: функция выполняется в её контексте, вызывающий ждёт done
+  struct Command {
+    void (*invoke)(void* ctx) = nullptr;
+    void* ctx = nullptr;
+    std::atomic<bool> done{false};
+#if defined(ARDUINO)
+    TaskHandle_t waiter = nullptr;       // задача, которую будим по завершении
+#endif
+  };
+  // Выполнение fn в контексте владельца радио с возвратом результата вызывающему
+  template <typename Fn>
+  auto runOnOwner(Fn&& fn) -> decltype(fn()) {
+    decltype(fn()) result{};
+    auto body = [&]() { result = fn(); };
+    Command cmd;
+    cmd.invoke = [](void* ctx) { (*static_cast<decltype(body)*>(ctx))(); };
+    cmd.ctx = &body;
+    postAndWait(cmd);
+    return result;
+  }
+  // Нужно ли передать вызов задаче-владельцу (задача запущена, а мы не в ней)
+  bool needsOwnerHop() const;
+  void postAndWait(Command& cmd);
+  void drainCommands();
+  // Один проход владельца: IRQ, автомат передачи, чтение FIFO в кольцо
+  void serviceOwner();
+  void ownerLoop();
+  void waitOwnerEvent(uint32_t timeoutMs);
+  void wakeOwner();
+  static void ownerTaskEntry(void* arg);
+
+  // Автомат асинхронной передачи
+  int16_t startNextChunk();
+  int16_t serviceTransmit(bool pollRegister);
+  void finishTransmit(int16_t result, const char* context);
+  // Выбор режима заголовка (explicit или implicit с длиной из таблицы) по минимуму времени в эфире
+  void applyHeaderMode(bool force);
+  // Слот кольца приёма: копия FIFO и параметры пакета
+  struct RxSlot {
+    std::array<uint8_t, 256> data{};
+    size_t len = 0;
+    float snr = 0.0f;
+    float rssi = 0.0f;
+  };
+  // Чтение FIFO в кольцо приёма с немедленным перезапуском RX и разбор слота после него
+  bool readPacketToRing();
+  void processRxSlot(const RxSlot& slot);
+  // Разбор накопленных слотов; readBetweenSlots — забирать FIFO между слотами (без задачи-владельца)
+  void processRxRing(bool readBetweenSlots);
+  // Время в эфире одного LoRa-пакета и его ёмкость при текущем режиме заголовка
+  uint32_t packetAirtimeUs(size_t len) const;
+  size_t packetCapacity() const;
+  // Передача собранного кадра пользовательским колбэкам
+  void deliverFrame(const uint8_t* data, size_t len, const subpacket::FrameInfo& info);
+  void waitTransmitIdle();
+
   // Непосредственная установка частоты
   bool setFrequency(float freq);
+  // Частота, на которой модуль ждёт между операциями: TX для UPLINK, иначе RX
+  float idleFrequency() const;
+  // Возврат в исходное состояние роли: приём на RX-частоте или standby на TX-частоте
+  bool enterIdle(const char* context);
 
   // Запуск приёма с повторными попытками и логированием
   bool startReceiveWithRetry(const char* context);
+  // Завершение CAD и возврат в режим приёма
+  void finishChannelScan(const char* context);
+  // Завершение пинга с восстановлением заголовка и режима роли
+  void finishPing(int16_t result, const char* context);
 
   // Обёртка над SX1262 с публичным доступом к очистке IRQ-статуса
   struct PublicSX1262 : public SX1262 {
@@ -224,14 +341,51 @@ private:
   friend class RadioSX1262TestAccessor;       // тестовый доступ к внутренностям
   PublicSX1262 radio_;                   // экземпляр радиомодуля
   RxCallback rx_cb_;                     // пользовательский колбэк
+  RxFrameCallback rx_frame_cb_;          // колбэк кадров с картой пакетов
+  static constexpr size_t RX_RING_SLOTS = 4;      // пакеты, ожидающие разбора после перезапуска RX
+  std::array<RxSlot, RX_RING_SLOTS> rxRing_{};    // предвыделенное кольцо приёма
+  std::atomic<size_t> rxHead_{0};                 // счётчик разобранных слотов (пишет потребитель)
+  std::atomic<size_t> rxTail_{0};                 // счётчик заполненных слотов (пишет владелец радио)
+  std::atomic<uint32_t> rxRingOverflows_{0};      // пакеты, потерянные из-за заполненного кольца
+  subpacket::Assembler assembler_;       // сборка кадров из LoRa-пакетов
   IrqLogCallback irqCallback_ = nullptr; // внешнее уведомление об IRQ-логе
-  static RadioSX1262* instance_;         // указатель на текущий объект
+  static constexpr size_t MAX_INSTANCES = 2;             // модулей с собственным DIO1
+  static RadioSX1262* instances_[MAX_INSTANCES];         // объекты для обработчиков прерываний
+  int slot_ = -1;                        // индекс в instances_ (-1 — без обработчика DIO1)
+  Role role_ = Role::HALF_DUPLEX;        // назначение модуля
+  RadioSX1262* peer_ = nullptr;          // радио приёма дуплексной пары
+  float currentFrequency_ = 0.0f;        // последняя успешно установленная частота (0 — неизвестна)
   static bool irqLoggerStarted_;         // отметка, что стартовый лог уже выведен
   volatile bool packetReady_ = false;    // флаг готовности пакета
   volatile bool irqNeedsRead_ = false;   // требуется ли чтение IRQ-регистров в основном потоке
   volatile bool irqLogPending_ = false;  // требуется ли вывести отложенный лог IRQ
   volatile uint32_t pendingIrqFlags_ = 0;          // сохранённые флаги IRQ из ISR
   volatile int16_t pendingIrqClearState_ = RADIOLIB_ERR_NONE; // результат очистки IRQ
+  std::atomic<bool> txActive_{false};    // идёт асинхронная передача серии (сбрасывается последним)
+  volatile bool txDoneIrq_ = false;      // DIO1 сообщил TX_DONE текущего фрагмента
+  std::vector<uint8_t> txData_;          // копия кадров серии подряд
+  std::vector<size_t> txFrameEnds_;      // границы кадров в txData_
+  size_t txChunkSeq_ = 0;                // номер пакета в текущем кадре
+  size_t txChunkTotal_ = 0;              // число пакетов текущего кадра
+  bool txTag_ = false;                   // метка кадра, чередуется между кадрами
+  size_t txFrameIdx_ = 0;                // индекс передаваемого кадра
+  size_t txFramesSent_ = 0;              // полностью переданные кадры серии
+  size_t txChunkCapacity_ = 0;           // размер LoRa-фрагмента
+  bool txImplicit_ = false;              // дополнять фрагменты до фиксированной длины
+  uint32_t txChunkStartedMs_ = 0;        // запуск текущего фрагмента (millis)
+  uint32_t txChunkAirtimeMs_ = 0;        // расчётное время фрагмента в эфире
+  uint32_t txChunkTimeoutMs_ = 0;        // предельное ожидание TX_DONE
+  int16_t txResult_ = RADIOLIB_ERR_NONE; // итог последней серии
+  bool cadActive_ = false;               // запущен CAD, ждём CAD_DONE
+  bool cadDone_ = false;                 // CAD завершён (получен CAD_DONE)
+  bool cadDetected_ = false;             // CAD обнаружил активность LoRa
+  uint32_t cadStartedMs_ = 0;            // момент запуска CAD (millis)
+  uint32_t cadTimeoutMs_ = 0;            // допустимая длительность CAD
+  std::atomic<bool> pingActive_{false};  // пинг ждёт эха, ответ не уходит в кольцо приёма
+  bool pingHeaderSwitched_ = false;      // implicit-заголовок временно выключен на время пинга
+  size_t pingImplicitLen_ = 0;           // длина implicit-кадра для восстановления
+  uint32_t pingStartedUs_ = 0;           // начало ожидания ответа (micros)
+  uint32_t pingTimeoutUs_ = 0;           // допустимое ожидание ответа
 
   ChannelBank bank_ = ChannelBank::EAST; // текущий банк
   uint8_t channel_ = 0;                  // текущий канал
@@ -258,16 +412,18 @@ private:
   static const int8_t CR_[4];
 
   static constexpr int16_t ERR_INVALID_ARGUMENT = -31998;     // некорректные параметры вызова
-  static constexpr uint32_t LOCK_TIMEOUT_MS = 500;    // тайм-аут ожидания мьютекса, мс
+  static constexpr size_t COMMAND_QUEUE_SIZE = 8;     // одновременных вызовов из других контекстов
+  static constexpr uint32_t OWNER_IDLE_WAIT_MS = 10;  // сон владельца без событий DIO1
+  static constexpr uint32_t TASK_STACK_SIZE = 6144;   // стек задачи-владельца, байт
+  static constexpr unsigned TASK_PRIORITY = 3;        // выше основного цикла и логгера
 
-  friend class ScopedRadioLock;
-  int16_t lockRadio(TickType_t timeout);
-  void unlockRadio();
+  lockfree::MpscQueue<Command*, COMMAND_QUEUE_SIZE> commands_; // команды владельцу радио
+  std::atomic<bool> taskRunning_{false};              // работает ли задача-владелец
 #if defined(ARDUINO)
-  SemaphoreHandle_t radioMutex_ = nullptr;            // мьютекс для синхронизации доступа к SX1262
+  std::atomic<TaskHandle_t> ownerTask_{nullptr};      // задача-владелец (её будит DIO1)
+  std::atomic<TaskHandle_t> txWaiter_{nullptr};       // задача в sendBurst(), ждущая конца серии
 #else
-  std::timed_mutex radioMutex_;                       // хост-реализация мьютекса
+  std::thread ownerThread_;                           // хост-реализация задачи-владельца
 #endif
-  TickType_t toTicks(uint32_t timeoutMs) const;
 };
 
@@ -9,9 +9,12 @@
 #include "libs/crypto/aes_ccm.h" // AES-CCM шифрование
 #include "libs/crypto/chacha20_poly1305.h" // AEAD ChaCha20-Poly1305
 #include "libs/protocol/ack_utils.h" // проверка ACK для фильтрации буфера
+#include "libs/protocol/aggregate_utils.h" // разбор агрегированных кадров
+#include "libs/lzss/lzss.h"             // распаковка сжатых кадров
 #include "default_settings.h"         // параметры по умолчанию
 #include "libs/config_loader/config_loader.h" // доступ к конфигурации запуска
 #include "libs/fec/fec_profile.h"             // единые настройки ФЕК
+#include <cstdio>
 #include <vector>
 #include <algorithm>
 #include <array>
@@ -124,6 +127,20 @@ RxModule::RxModule()
   last_conv_cleanup_ = std::chrono::steady_clock::now(); // отметка для фоновой очистки кэша свёртки
 }
 
+// Кадр от радиоуровня: границы LoRa-пакетов уже восстановлены, потерянные пакеты отмечены в info
+void RxModule::onReceiveFrame(const uint8_t* data, size_t len, const subpacket::FrameInfo& info) {
+  last_frame_info_ = info;
+  if (!info.complete) {
+    // Пока конвейер декодирования отключён, восстановить стёртые пакеты нечем — кадр отбрасываем
+    char detail[64];
+    std::snprintf(detail, sizeof(detail), "потеря LoRa-пакетов (маска 0x%08lX)",
+                  static_cast<unsigned long>(info.missingMask));
+    registerDrop(detail);
+    return;
+  }
+  onReceive(data, len);
+}
+
 // Передаём данные колбэку, если заголовок валиден
 void RxModule::onReceive(const uint8_t* data, size_t len) {
   RxProfilingScope profile_scope(*this, len);           // начинаем измерение пути кадра
@@ -132,6 +149,31 @@ void RxModule::onReceive(const uint8_t* data, size_t len) {
     return;
   }
 
+  // Сжатый кадр: распаковка в буфер не длиннее COMPRESS_MAX_OUTPUT, результат разбирается заново
+  if (data[0] == lzss::MARKER && !unpacking_) {
+    std::vector<uint8_t> unpacked;
+    if (lzss::unpack(data, len, unpacked, DefaultSettings::COMPRESS_MAX_OUTPUT)) {
+      ++decompressed_frames_;
+      unpacking_ = true;
+      onReceive(unpacked.data(), unpacked.size());
+      unpacking_ = false;
+      return;
+    }
+  }
+
+  // Агрегированный кадр: каждая запись проходит тот же путь, что и отдельно принятый кадр
+  if (data[0] == protocol::aggregate::MARKER) {
+    size_t records = 0;
+    if (protocol::aggregate::forEach(data, len, [&](const uint8_t* rec, size_t rec_len) {
+          onReceive(rec, rec_len);
+          ++records;
+        })) {
+      ++aggregate_frames_;
+      aggregate_records_ += static_cast<uint32_t>(records);
+      return;
+    }
+  }
+
   // Временно отключаем все этапы обработки: данные сразу передаём в пользовательский
   // колбэк без дескремблирования, декодирования и проверки. Полный конвейер сохранён
   // ниже в закомментированном блоке, чтобы позже вернуть сложную обработку.
@@ -380,6 +422,8 @@ void RxModule::onReceive(const uint8_t* data, size_t len) {
   work_buf_.clear();
   size_t result_len = 0;
   const bool conv_flag = (hdr_flags & FrameHeader::FLAG_CONV_ENCODED) != 0;
+  const auto conv_rate = static_cast<conv_codec::Rate>((hdr_flags & FrameHeader::CONV_RATE_MASK) >>
+                                                       FrameHeader::CONV_RATE_SHIFT); // прокалывание из заголовка
   const bool header_rs_flag = (hdr_flags & FrameHeader::FLAG_RS_ENCODED) != 0;
   const bool header_bit_flag = (hdr_flags & FrameHeader::FLAG_BIT_INTERLEAVED) != 0;
   const auto& radio_cfg = ConfigLoader::getConfig().radio;
@@ -521,7 +565,7 @@ void RxModule::onReceive(const uint8_t* data, size_t len) {
     if (!payload_ptr->empty() && expect_bit_interleaver) {
       bit_interleaver::deinterleave(payload_ptr->data(), payload_ptr->size());
     }
-    if (!conv_codec::viterbiDecode(payload_ptr->data(), payload_ptr->size(), result_buf_)) {
+    if (!conv_codec::viterbiDecode(payload_ptr->data(), payload_ptr->size(), result_buf_, conv_rate)) {
       decode_ok = false;
     } else {
       if (cipher_len_hint) {
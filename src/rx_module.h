@@ -10,6 +10,7 @@
 #include <string>
 #include "libs/packetizer/packet_gatherer.h" // сборщик пакетов
 #include "libs/received_buffer/received_buffer.h" // буфер принятых сообщений
+#include "libs/subpacket/subpacket.h" // карта LoRa-пакетов кадра
 #include "default_settings.h"
 
 // Модуль приёма данных
@@ -20,6 +21,10 @@ public:
   RxModule();
   // Обработка входящего пакета
   void onReceive(const uint8_t* data, size_t len);
+  // Обработка кадра, собранного радиоуровнем, с картой потерянных и дополненных пакетов
+  void onReceiveFrame(const uint8_t* data, size_t len, const subpacket::FrameInfo& info);
+  // Карта пакетов последнего кадра — подсказки стираний для декодера
+  subpacket::FrameInfo lastFrameInfo() const { return last_frame_info_; }
   // Включение профилирования и диагностики задержек
   void enableProfiling(bool enable);
   // Получение последнего снимка профилирования
@@ -74,6 +79,11 @@ public:
   void setEncryptionEnabled(bool enabled);
   // Фоновая очистка очередей с незавершёнными блоками
   void tickCleanup();
+  // Принятые агрегированные кадры и записи, разобранные из них
+  uint32_t aggregateFrameCount() const { return aggregate_frames_; }
+  uint32_t aggregateRecordCount() const { return aggregate_records_; }
+  // Принятые сжатые кадры (lzss)
+  uint32_t decompressedCount() const { return decompressed_frames_; }
 private:
   Callback cb_;
   std::function<void()> ack_cb_;              // отдельный обработчик ACK
@@ -89,6 +99,10 @@ private:
   uint32_t raw_counter_ = 0;         // счётчик сырых пакетов без заголовка
   bool encryption_forced_ = DefaultSettings::USE_ENCRYPTION; // ожидание шифрования по умолчанию
   bool profiling_enabled_ = false;   // включено ли профилирование
+  uint32_t aggregate_frames_ = 0;    // агрегированных кадров
+  uint32_t aggregate_records_ = 0;   // записей в них
+  uint32_t decompressed_frames_ = 0; // распакованных кадров
+  bool unpacking_ = false;           // идёт разбор распакованного кадра — вложенное сжатие не разбираем
   bool assembling_ = false;          // активна ли текущая сборка сообщения
   uint32_t active_msg_id_ = 0;       // идентификатор собираемого сообщения
   uint16_t expected_frag_cnt_ = 0;   // сколько фрагментов ожидается
@@ -123,6 +137,7 @@ private:
   };
   std::unordered_map<uint32_t, SplitPrefixInfo> inflight_prefix_; // префиксы, ожидающие завершения
   ProfilingSnapshot last_profile_;   // последний снимок профилирования
+  subpacket::FrameInfo last_frame_info_; // карта пакетов последнего кадра
   DropStats drop_stats_;             // накопитель причин отброса кадров
   struct FragmentMismatchSlot {
     uint32_t msg_id = 0;                                 // идентификатор сообщения
@@ -1,9 +1,17 @@
 #include "tx_module.h"
 #include "libs/frame/frame_header.h" // заголовок кадра
+#include "libs/frame/delta_header.h" // дельта-заголовки фрагментов
 #include "libs/rs255223/rs255223.h"    // RS(255,223)
 #include "libs/byte_interleaver/byte_interleaver.h" // байтовый интерливинг
 #include "libs/conv_codec/conv_codec.h" // свёрточное кодирование
 #include "libs/bit_interleaver/bit_interleaver.h" // битовый интерливинг
+#include "libs/harq/harq.h"                       // версии избыточности HARQ
+#include "libs/erasure/erasure_code.h"            // внешний код стираний по фрагментам
+#include "libs/packetizer/fragment_cursor.h"     // нарезка сообщения без копирования
+#include "libs/frame_interleaver/frame_interleaver.h" // межкадровый интерливинг
+#include "libs/jpeg_uep/jpeg_uep.h"                // неравная защита частей JPEG
+#include "libs/protocol/aggregate_utils.h"         // агрегированные кадры
+#include "libs/lzss/lzss.h"                        // сжатие коротких текстов
 #include "libs/scrambler/scrambler.h" // скремблер
 #include "libs/key_loader/key_loader.h" // загрузка ключа
 #include "libs/crypto/chacha20_poly1305.h" // AEAD ChaCha20-Poly1305
@@ -17,6 +25,7 @@
 #include <string>
 #include <array>
 #include <cstring>
+#include <new>
 #ifndef ARDUINO
 #include <thread>
 #endif
@@ -57,7 +66,32 @@ static constexpr size_t EFFECTIVE_DATA_CHUNK =
         ? (MAX_CONV_PLAINTEXT < RS_DATA_PAYLOAD ? MAX_CONV_PLAINTEXT : RS_DATA_PAYLOAD)
         : (RS_DATA_PAYLOAD ? RS_DATA_PAYLOAD : MAX_CONV_PLAINTEXT);
 static_assert(EFFECTIVE_DATA_CHUNK > 0, "Размер части для кодирования должен быть положительным");
-static constexpr size_t MAX_CIPHER_CHUNK = EFFECTIVE_DATA_CHUNK + TAG_LEN; // максимум байт шифртекста в одном блоке
+
+// Размер открытой части фрагмента под выбранный профиль: при свёртке блок вместе с тегом
+// и хвостом кодера должен уместиться в MAX_FRAGMENT_LEN после кодирования на своей скорости
+static size_t dataChunkFor(const fec::Profile& profile) {
+  if (!profile.use_conv) return EFFECTIVE_DATA_CHUNK;
+  const size_t conv_input = conv_codec::maxInputSize(MAX_FRAGMENT_LEN, profile.conv_rate);
+  return conv_input > CONV_TAIL_BYTES + TAG_LEN ? conv_input - CONV_TAIL_BYTES - TAG_LEN : EFFECTIVE_DATA_CHUNK;
+}
+
+// Длина полезной нагрузки фрагмента с открытой частью plain_len байт: тег, RS и свёртка
+// по тем же правилам, что и при подготовке фрагмента
+static size_t fragmentPayloadLen(size_t plain_len, const fec::Profile& profile) {
+  const size_t cipher_len = plain_len + TAG_LEN;
+  if (!profile.use_conv) return cipher_len;
+  if (profile.use_rs && cipher_len == RS_DATA_LEN) {
+    const size_t rs_payload = conv_codec::encodedSize(RS_ENC_LEN + CONV_TAIL_BYTES, profile.conv_rate);
+    if (rs_payload <= MAX_FRAGMENT_LEN) return rs_payload;
+  }
+  const size_t conv_payload = conv_codec::encodedSize(cipher_len + CONV_TAIL_BYTES, profile.conv_rate);
+  return conv_payload <= MAX_FRAGMENT_LEN ? conv_payload : cipher_len;
+}
+
+// Длина кадра в эфире: заголовок, полезная нагрузка и пилоты через каждые PILOT_INTERVAL байт
+static size_t frameLenFor(size_t header_len, size_t payload_len) {
+  return header_len + payload_len + (payload_len ? (payload_len - 1) / PILOT_INTERVAL * PILOT_MARKER.size() : 0);
+}
 
 // Указатель на функцию шифрования, который может быть переопределён тестами
 static TxModule::EncryptOverride g_encrypt_impl = crypto::chacha20poly1305::encrypt;
@@ -121,7 +155,7 @@ static uint32_t packMetadata(uint8_t flags, uint16_t frag_idx, uint16_t payload_
 TxModule::TxModule(IRadio& radio, const std::array<size_t,4>& capacities, PayloadMode mode)
   : radio_(radio), buffers_{MessageBuffer(capacities[0]), MessageBuffer(capacities[1]),
                              MessageBuffer(capacities[2]), MessageBuffer(capacities[3])},
-    splitter_(mode), key_(KeyLoader::loadKey()) {
+    splitter_(mode), key_(KeyLoader::loadKey()), lbt_rng_(std::random_device{}()) {
   // ключ считывается один раз и используется при шифровании
   last_send_ = std::chrono::steady_clock::now() - std::chrono::milliseconds(pause_ms_);
   last_attempt_ = last_send_;
@@ -143,11 +177,40 @@ void TxModule::setPayloadMode(PayloadMode mode) { splitter_.setMode(mode); }
 
 // Помещаем сообщение в очередь согласно классу QoS
 uint16_t TxModule::queue(const uint8_t* data, size_t len, uint8_t qos) {
+  return enqueueAs(data, len, qos, SubmitMode::QUEUE, 0);
+}
+
+uint16_t TxModule::queueImage(const uint8_t* data, size_t len, uint8_t qos) {
+  return enqueueAs(data, len, qos, SubmitMode::IMAGE, 0);
+}
+
+uint16_t TxModule::queuePlain(const uint8_t* data, size_t len, uint8_t qos) {
+  return enqueueAs(data, len, qos, SubmitMode::PLAIN, 0);
+}
+
+// Проверка заявки, общая для прямой постановки и submit(); qos приводится к 0..3,
+// изображение без маркеров JPEG ставится как обычное сообщение
+bool TxModule::acceptable(const uint8_t* data, size_t len, uint8_t& qos, SubmitMode& mode) const {
   if (!data || len == 0) {                        // проверка указателя
-    DEBUG_LOG("TxModule: пустой ввод");
-    return 0;
+    DEBUG_LOG(mode == SubmitMode::PLAIN ? "TxModule: пустой ввод для plain" : "TxModule: пустой ввод");
+    return false;
   }
   if (qos > 3) qos = 3;                           // ограничение диапазона QoS
+  if (mode == SubmitMode::IMAGE && !jpeg_uep::isJpeg(data, len)) {
+    mode = SubmitMode::QUEUE;                     // без маркеров JPEG защищать выборочно нечего
+  }
+  if (len > DefaultSettings::TX_PLAIN_MAX_LEN && (mode == SubmitMode::PLAIN || !isFramedLongEnabled())) {
+    // Длинное сообщение ушло бы кадрами с FrameHeader, которые приём этой прошивки не
+    // декодирует: отказываем сразу, а не отправляем в эфир то, что дойдёт мусором
+    DEBUG_LOG("TxModule: сообщение длиннее «сырого» кадра");
+    return false;
+  }
+  return true;
+}
+
+// Постановка в очередь класса QoS под идентификатором id (0 — выдаёт буфер) с пометкой режима
+uint16_t TxModule::enqueueAs(const uint8_t* data, size_t len, uint8_t qos, SubmitMode mode, uint16_t id) {
+  if (!acceptable(data, len, qos, mode)) return 0;
   // Полностью отключаем расширенную обработку: ACK больше не выносим в отдельную очередь,
   // данные сразу же ставим в буфер без модификации. Это сохраняет прямую схему
   // «данные → байты → отправка» и оставляет исходную реализацию закомментированной
@@ -156,38 +219,109 @@ uint16_t TxModule::queue(const uint8_t* data, size_t len, uint8_t qos) {
   // Старая логика формирования отдельного ACK:
   // if (is_ack_marker) { ... }
   DEBUG_LOG_VAL("TxModule: постановка длины=", len);
-  uint16_t res = buffers_[qos].enqueue(data, len);
-  if (res) {
+  uint16_t res = id ? buffers_[qos].enqueue(data, len, id) : buffers_[qos].enqueue(data, len);
+  if (!res) {
+    DEBUG_LOG(mode == SubmitMode::IMAGE   ? "TxModule: ошибка постановки JPEG"
+              : mode == SubmitMode::PLAIN ? "TxModule: очередь переполнена при plain постановке"
+                                          : "TxModule: ошибка постановки");
+    return 0;
+  }
+  if (mode == SubmitMode::IMAGE) {
+    DEBUG_LOG_VAL("TxModule: JPEG с неравной защитой id=", res);
+    uep_messages_.insert(queueKey(qos, res));    // фрагменты будут нарезаны по маркерам
+  } else if (mode == SubmitMode::PLAIN || len <= DefaultSettings::TX_PLAIN_MAX_LEN) {
     DEBUG_LOG_VAL("TxModule: сообщение id=", res);
-    plain_messages_.insert(res);                 // принудительно помечаем кадр как «сырой»
+    plain_messages_.insert(queueKey(qos, res));  // принудительно помечаем кадр как «сырой»
   } else {
-    DEBUG_LOG("TxModule: ошибка постановки");
+    DEBUG_LOG_VAL("TxModule: длинное сообщение id=", res); // режется на фрагменты при отправке
   }
   return res;
 }
 
-uint16_t TxModule::queuePlain(const uint8_t* data, size_t len, uint8_t qos) {
-  if (!data || len == 0) {
-    DEBUG_LOG("TxModule: пустой ввод для plain");
-    return 0;
-  }
-  if (qos > 3) qos = 3;
-  if (len > buffers_[qos].slotSize()) {
-    DEBUG_LOG("TxModule: plain сообщение не помещается в слот");
+// Заявка из любой задачи: идентификатор выдаётся сразу, данные копируются в ячейку очереди
+// заявок (или в отдельный блок, если не помещаются), в буфер класса их переносит потребитель
+uint16_t TxModule::submit(const uint8_t* data, size_t len, uint8_t qos, SubmitMode mode) {
+  if (!acceptable(data, len, qos, mode) || len > buffers_[qos].slotSize()) {
+    submit_rejected_.fetch_add(1, std::memory_order_relaxed);
     return 0;
   }
-  uint16_t res = buffers_[qos].enqueue(data, len);
-  if (res) {
-    DEBUG_LOG_VAL("TxModule: plain сообщение id=", res);
-    plain_messages_.insert(res);               // помечаем идентификатор как «сырой»
+  Submission sub;
+  sub.qos = qos;
+  sub.mode = mode;
+  sub.len = static_cast<uint16_t>(len);
+  if (len <= sub.bytes.size()) {
+    std::copy(data, data + len, sub.bytes.begin());
   } else {
-    DEBUG_LOG("TxModule: очередь переполнена при plain постановке");
+    sub.heap = new (std::nothrow) uint8_t[len];   // медленный путь: изображения и длинные тексты
+    if (!sub.heap) {
+      submit_rejected_.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+    }
+    std::copy(data, data + len, sub.heap);
   }
-  return res;
+  sub.id = buffers_[qos].reserveId();
+  if (!submissions_.tryPush(sub)) {
+    delete[] sub.heap;
+    submit_rejected_.fetch_add(1, std::memory_order_relaxed);
+    return 0;                                     // очередь заявок заполнена, вызывающий повторит
+  }
+  return sub.id;
+}
+
+TxModule::~TxModule() {
+  Submission sub;
+  while (submissions_.tryPop(sub)) delete[] sub.heap; // непринятые заявки с отдельным блоком
+}
+
+// Перенос заявок в очереди классов; только из задачи, которая вызывает loop()
+size_t TxModule::drainSubmissions() {
+  size_t moved = 0;
+  Submission sub;
+  while (submissions_.tryPop(sub)) {
+    const uint8_t* data = sub.heap ? sub.heap : sub.bytes.data();
+    if (enqueueAs(data, sub.len, sub.qos, sub.mode, sub.id)) {
+      ++moved;
+    } else {
+      submit_lost_.fetch_add(1, std::memory_order_relaxed); // идентификатор уже выдан, но очередь класса полна
+      LOG_WARN("TxModule: заявка id=%u qos=%u потеряна — очередь класса заполнена",
+               static_cast<unsigned>(sub.id), static_cast<unsigned>(sub.qos));
+    }
+    delete[] sub.heap;
+    sub.heap = nullptr;
+  }
+  return moved;
+}
+
+// Снятие сообщения с сохранением ёмкости его данных для следующего fetchNext()
+void TxModule::recycle(std::optional<PendingMessage>& slot) {
+  if (slot && slot->data.capacity() > spare_data_.capacity()) {
+    spare_data_ = std::move(slot->data);
+    spare_data_.clear();
+  }
+  slot.reset();
+}
+
+size_t TxModule::getQueueUsedBytes() const {
+  size_t used = 0;
+  for (const auto& buf : buffers_) used += buf.usedBytes();
+  return used;
+}
+
+size_t TxModule::getQueueBudgetBytes() const {
+  size_t budget = 0;
+  for (const auto& buf : buffers_) budget += buf.byteBudget();
+  return budget;
 }
 
 // Пытаемся отправить первое сообщение
 bool TxModule::loop() {
+  drainSubmissions();                             // заявки других задач встают в очереди классов
+  if (async_.active) {                            // кадры ещё в эфире — ждём завершения передачи
+    return pollAsyncSend();
+  }
+  if (suspended_) {                               // радио настроено другим модулем — не трогаем его
+    return false;
+  }
   if (processImmediateAck()) {                    // приоритетная отправка подтверждений
     return true;
   }
@@ -204,7 +338,7 @@ bool TxModule::loop() {
         }
         inflight_->attempts_left = ack_retry_limit_;
         inflight_->expect_ack = false;
-        inflight_.reset();
+        recycle(inflight_);
       }
       scheduleFromArchive();
       bypass_pause = true;                         // после отмены ожидания отправляем следующий пакет сразу
@@ -221,12 +355,14 @@ bool TxModule::loop() {
         if (inflight_->attempts_left > 0) {
           --inflight_->attempts_left;
           waiting_ack_ = false;
+          ++ack_timeout_count_;
           DEBUG_LOG("TxModule: повтор без ACK");
           inflight_->next_fragment = 0;
           inflight_->completed = false;
           inflight_->next_allowed_send = std::chrono::steady_clock::time_point::min();
           bypass_pause = true;                     // повторяем без учёта общей паузы
         } else {
+          ++ack_timeout_count_;
           DEBUG_LOG("TxModule: ACK не получен, перенос в архив");
           uint8_t failed_qos = inflight_->qos;
           std::string failed_tag = inflight_->packet_tag;
@@ -235,7 +371,7 @@ bool TxModule::loop() {
           inflight_->completed = false;
           inflight_->next_allowed_send = std::chrono::steady_clock::time_point::min();
           archive_.push_back(std::move(*inflight_));
-          inflight_.reset();
+          recycle(inflight_);
           waiting_ack_ = false;
           archiveFollowingParts(failed_qos, failed_tag);
           bypass_pause = true;                     // освобождаем место для следующего сообщения без задержки
@@ -247,10 +383,11 @@ bool TxModule::loop() {
     }
   }
 
-  if (pause_ms_) {
+  const uint32_t pause_ms = currentPauseMs();
+  if (pause_ms) {
     if (bypass_pause) {
-      last_send_ = now - std::chrono::milliseconds(pause_ms_); // отматываем таймер, чтобы не ждать паузу
-    } else if (now - last_send_ < std::chrono::milliseconds(pause_ms_)) {
+      last_send_ = now - std::chrono::milliseconds(pause_ms); // отматываем таймер, чтобы не ждать паузу
+    } else if (now - last_send_ < std::chrono::milliseconds(pause_ms)) {
       DEBUG_LOG("TxModule: пауза");
         const int16_t ensureState = radio_.ensureReceiveMode();
         if (ensureState != IRadio::ERR_NONE) {
@@ -271,22 +408,34 @@ bool TxModule::loop() {
     MessageBuffer* buf = nullptr;
     uint8_t qos_idx = 0;
     for (size_t i = 0; i < buffers_.size(); ++i) {
+      if (parked_[i]) {                            // сначала продолжаем приостановленное сообщение класса
+        out = std::move(*parked_[i]);
+        parked_[i].reset();
+        DEBUG_LOG("TxModule: возобновлена передача id=%u qos=%u с фрагмента %u",
+                  static_cast<unsigned>(out.id),
+                  static_cast<unsigned>(out.qos),
+                  static_cast<unsigned>(out.next_fragment));
+        return true;
+      }
       if (buffers_[i].hasPending()) { buf = &buffers_[i]; qos_idx = static_cast<uint8_t>(i); break; }
     }
     if (!buf) {
       return false;
     }
-    std::vector<uint8_t> msg;
-    uint16_t id = 0;
-    if (!buf->pop(id, msg)) {
+    MessageBuffer::View view;
+    if (!buf->peek(view)) {
       DEBUG_LOG("TxModule: ошибка извлечения");
       return false;
     }
+    const uint16_t id = view.id;
+    out.data.swap(spare_data_);                  // буфер завершённого сообщения: без нового выделения
+    out.data.assign(view.data, view.data + view.len); // копия прямо из арены очереди
+    buf->discard();
     out.id = id;
-    out.data = std::move(msg);
     out.qos = qos_idx;
     out.attempts_left = ack_retry_limit_;
-    out.is_plain = plain_messages_.erase(id) > 0; // проверяем, требуется ли «сырой» режим
+    out.is_plain = plain_messages_.erase(queueKey(qos_idx, id)) > 0; // проверяем, требуется ли «сырой» режим
+    out.jpeg_uep = uep_messages_.erase(queueKey(qos_idx, id)) > 0;
     bool wants_ack = ack_enabled_ && ack_retry_limit_ != 0 && ack_timeout_ms_ != 0 && !isAckPayload(out.data);
     out.expect_ack = out.is_plain ? false : wants_ack;
     if (out.is_plain) {
@@ -302,14 +451,21 @@ bool TxModule::loop() {
     out.completed = false;
     out.next_allowed_send = std::chrono::steady_clock::time_point::min();
     out.fragments.clear();
+    if (aggregation_enabled_ && out.is_plain) {
+      aggregatePlain(out);                       // попутные короткие сообщения уходят тем же кадром
+    }
+    if (compression_enabled_ && out.is_plain) {
+      compressPlain(out);                        // сжимаем уже готовый кадр, вместе с агрегатом
+    }
     return true;
   };
 
   if (ack_enabled_) {
+    preemptCurrent(inflight_);                     // между фрагментами уступаем место более важному классу
     if (!inflight_) {
       if (delayed_) {
         inflight_.emplace(std::move(*delayed_));
-        delayed_.reset();
+        recycle(delayed_);
       } else {
         PendingMessage fresh;
         if (!fetchNext(fresh)) return false;
@@ -319,6 +475,7 @@ bool TxModule::loop() {
     if (!inflight_) return false;
     message = &*inflight_;
   } else {
+    preemptCurrent(delayed_);
     if (!delayed_) {
       PendingMessage fresh;
       if (!fetchNext(fresh)) return false;
@@ -330,41 +487,144 @@ bool TxModule::loop() {
   }
 
   if (!message) return false;
-  bool sent = transmit(*message);
+  const bool sent = transmit(*message, ack_enabled_ ? SendSource::INFLIGHT : SendSource::DELAYED);
+  if (async_.active) {
+    return false;                                  // итог передачи заберёт pollAsyncSend()
+  }
+  return completeQueuedSend(*message, sent);
+}
+
+// Склейка коротких «сырых» сообщений: за извлечённым сообщением из головы очередей классов
+// 0..AGGREGATE_MAX_QOS забираются следующие, пока кадр не превысит AGGREGATE_MAX_FRAME.
+// Порядок внутри класса сохраняется, сообщение, не влезающее в кадр, останавливает класс
+bool TxModule::aggregatePlain(PendingMessage& head) {
+  if (head.qos > DefaultSettings::AGGREGATE_MAX_QOS || head.data.size() > DefaultSettings::AGGREGATE_MAX_RECORD) {
+    return false;
+  }
+  std::vector<uint8_t> frame;
+  protocol::aggregate::begin(frame);
+  protocol::aggregate::append(frame, head.data.data(), head.data.size());
+  for (uint8_t q = 0; q <= DefaultSettings::AGGREGATE_MAX_QOS && q < buffers_.size(); ++q) {
+    auto& buf = buffers_[q];
+    while (frame[1] < protocol::aggregate::MAX_RECORDS) {
+      MessageBuffer::View next;
+      if (!buf.peek(next) || plain_messages_.count(queueKey(q, next.id)) == 0) break;
+      if (next.len > DefaultSettings::AGGREGATE_MAX_RECORD ||
+          protocol::aggregate::grownSize(frame.size(), next.len) > DefaultSettings::AGGREGATE_MAX_FRAME) {
+        break;
+      }
+      plain_messages_.erase(queueKey(q, next.id));
+      protocol::aggregate::append(frame, next.data, next.len); // запись копируется прямо из арены очереди
+      buf.discard();
+    }
+  }
+  if (frame[1] < 2) {
+    return false;                                  // попутных сообщений нет — кадр уходит как есть
+  }
+  aggregated_count_ += frame[1];
+  DEBUG_LOG("TxModule: id=%u объединён с %u сообщениями, кадр %u байт", static_cast<unsigned>(head.id),
+            static_cast<unsigned>(frame[1] - 1), static_cast<unsigned>(frame.size()));
+  head.data = std::move(frame);
+  return true;
+}
+
+// Сжатие «сырого» кадра перед отправкой. Кадр заменяется сжатым, только если тот короче:
+// бинарные данные и короткие служебные пакеты уходят без изменений
+bool TxModule::compressPlain(PendingMessage& message) {
+  if (!lzss::pack(message.data.data(), message.data.size(), compress_buf_, DefaultSettings::COMPRESS_DICTIONARY)) {
+    return false;
+  }
+  ++compressed_count_;
+  compression_saved_bytes_ += static_cast<uint32_t>(message.data.size() - compress_buf_.size());
+  DEBUG_LOG("TxModule: id=%u сжат %u -> %u байт", static_cast<unsigned>(message.id),
+            static_cast<unsigned>(message.data.size()), static_cast<unsigned>(compress_buf_.size()));
+  message.data.swap(compress_buf_);
+  return true;
+}
+
+// Завершение отправки сообщения из очереди: ожидание ACK, архив или переход к следующему
+bool TxModule::completeQueuedSend(PendingMessage& message, bool sent) {
   if (!sent) {
+    if (lbtWaiting(std::chrono::steady_clock::now())) {
+      return false;                                // кадр ждёт свободного канала, а не провален
+    }
     DEBUG_LOG("TxModule: отправка не удалась");
     if (ack_enabled_ && inflight_) {
       inflight_->attempts_left = ack_retry_limit_;
       archive_.push_back(std::move(*inflight_));
-      inflight_.reset();
+      recycle(inflight_);
       waiting_ack_ = false;
     }
     return false;
   }
 
   auto send_moment = last_send_;
-  if (!message->completed) {
+  if (!message.completed) {
     return true;
   }
   if (ack_enabled_) {
-    if (message->expect_ack) {
+    if (message.expect_ack) {
       waiting_ack_ = true;
       last_attempt_ = send_moment;
     } else {
       waiting_ack_ = false;
       if (inflight_) {
         inflight_->attempts_left = ack_retry_limit_;
-        inflight_.reset();
+        recycle(inflight_);
       }
       onSendSuccess();
     }
   } else {
     onSendSuccess();
-    delayed_.reset();
+    recycle(delayed_);
   }
   return true;
 }
 
+// Опрос асинхронной передачи и завершение учёта отправленного сообщения
+bool TxModule::pollAsyncSend() {
+  size_t sent = 0;
+  const int16_t state = radio_.pollSend(sent);
+  if (state == IRadio::ERR_PENDING) {
+    return false;
+  }
+  async_.active = false;
+  PendingMessage* message = nullptr;
+  switch (async_.source) {
+    case SendSource::ACK:
+      if (!ack_queue_.empty()) message = &ack_queue_.front();
+      break;
+    case SendSource::INFLIGHT:
+      if (inflight_) message = &*inflight_;
+      break;
+    case SendSource::DELAYED:
+      if (delayed_) message = &*delayed_;
+      break;
+  }
+  if (!message) {
+    DEBUG_LOG("TxModule: сообщение завершённой передачи уже снято с отправки");
+    return false;
+  }
+  const bool ok = finishSend(*message, async_.prefix, async_.start,
+                             async_.airtime_us.data(), async_.count, state, sent);
+  if (async_.source == SendSource::ACK) {
+    return completeImmediateAck(ok);
+  }
+  return completeQueuedSend(*message, ok);
+}
+
+void TxModule::waitForSendCompletion() {
+  while (async_.active) {
+    pollAsyncSend();
+    if (!async_.active) break;
+#ifdef ARDUINO
+    yield();
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+  }
+}
+
 // Установка паузы между отправками
 void TxModule::setSendPause(uint32_t pause_ms) {
   pause_ms_ = pause_ms;
@@ -375,6 +635,155 @@ uint32_t TxModule::getSendPause() const {
   return pause_ms_;
 }
 
+void TxModule::setAirtimePacing(bool enabled) {
+  if (airtime_pacing_ == enabled) return;
+  airtime_pacing_ = enabled;
+  DEBUG_LOG(enabled ? "TxModule: паузы по времени в эфире" : "TxModule: фиксированная пауза между кадрами");
+}
+
+void TxModule::setFullDuplex(bool enabled) {
+  full_duplex_ = enabled;
+  pacer_.setTurnaround(enabled ? 0 : DefaultSettings::RX_TURNAROUND_MS);
+  DEBUG_LOG(enabled ? "TxModule: дуплекс — приём на отдельном радио, разворот TX→RX не нужен"
+                    : "TxModule: полудуплекс — пауза на разворот TX→RX");
+}
+
+void TxModule::setDutyCycle(uint8_t percent) {
+  pacer_.setDutyCycle(percent);
+}
+
+uint32_t TxModule::getAirtimeBudgetLeftMs() const {
+  return pacer_.remainingBudgetMs(std::chrono::steady_clock::now());
+}
+
+// Действующая пауза от начала последнего кадра: по времени в эфире, если радио умеет его
+// оценить, иначе фиксированная SEND_PAUSE
+uint32_t TxModule::currentPauseMs() const {
+  const bool cad = lbtActive();
+  if ((airtime_pacing_ || cad) && last_airtime_us_ != 0) {
+    return pacer_.gapAfterLastMs();
+  }
+  if (cad) {
+    return 0;                                      // занятость эфира проверяет CAD, слепая пауза не нужна
+  }
+  return pause_ms_;
+}
+
+void TxModule::setListenBeforeTalk(bool enabled) {
+  if (lbt_enabled_ == enabled) return;
+  lbt_enabled_ = enabled;
+  lbt_scanning_ = false;
+  lbt_busy_streak_ = 0;
+  lbt_backoff_until_ = std::chrono::steady_clock::time_point{};
+  DEBUG_LOG(enabled ? "TxModule: проверка канала перед передачей включена" : "TxModule: проверка канала отключена");
+}
+
+// CAD работает только с радио, которое его поддерживает
+bool TxModule::lbtActive() const {
+  return lbt_enabled_ && radio_.supportsChannelScan();
+}
+
+// Ожидаем результата CAD или конца отсрочки — передача не провалена, а отложена
+bool TxModule::lbtWaiting(const std::chrono::steady_clock::time_point& now) const {
+  return lbtActive() && (lbt_scanning_ || now < lbt_backoff_until_);
+}
+
+// Случайная отсрочка в растущем окне [LBT_BACKOFF_MIN_MS, min * 2^n], ограниченном LBT_BACKOFF_MAX_MS
+uint32_t TxModule::nextLbtBackoffMs() {
+  const uint32_t lo = DefaultSettings::LBT_BACKOFF_MIN_MS;
+  uint32_t hi = lo;
+  for (uint8_t i = 0; i < lbt_busy_streak_ && hi < DefaultSettings::LBT_BACKOFF_MAX_MS; ++i) {
+    hi *= 2;
+  }
+  hi = std::min(hi, DefaultSettings::LBT_BACKOFF_MAX_MS);
+  if (hi <= lo) return lo;
+  std::uniform_int_distribution<uint32_t> dist(lo, hi);
+  return dist(lbt_rng_);
+}
+
+// Неблокирующая проверка канала перед кадром: true — можно передавать сейчас
+bool TxModule::listenBeforeTalk(const std::chrono::steady_clock::time_point& now) {
+  if (!lbtActive()) return true;
+  if (now < lbt_backoff_until_) return false;
+  if (!lbt_scanning_) {
+    const int16_t state = radio_.startChannelScan();
+    if (state == IRadio::ERR_TIMEOUT) {
+      return false;                                // радио ещё передаёт, повторим позже
+    }
+    if (state != IRadio::ERR_NONE) {
+      DEBUG_LOG_VAL("TxModule: CAD не запущен, передаём без проверки, код=", state);
+      return true;
+    }
+    lbt_scanning_ = true;
+  }
+  switch (radio_.pollChannelScan()) {
+    case ChannelState::PENDING:
+      return false;
+    case ChannelState::BUSY: {
+      lbt_scanning_ = false;
+      ++lbt_busy_count_;
+      if (++lbt_busy_streak_ >= DefaultSettings::LBT_MAX_ATTEMPTS) {
+        LOG_WARN("TxModule: канал занят %u проверок подряд, передаём без CAD",
+                 static_cast<unsigned>(lbt_busy_streak_));
+        lbt_busy_streak_ = 0;
+        ++lbt_forced_count_;
+        return true;
+      }
+      const uint32_t backoff = nextLbtBackoffMs();
+      lbt_backoff_until_ = now + std::chrono::milliseconds(backoff);
+      DEBUG_LOG("TxModule: канал занят, отсрочка %u мс", static_cast<unsigned>(backoff));
+      return false;
+    }
+    case ChannelState::CLEAR:
+      ++lbt_clear_count_;
+      break;
+    case ChannelState::UNSUPPORTED:
+    default:
+      break;                                       // CAD прерван — решения нет, не задерживаем кадр
+  }
+  lbt_scanning_ = false;
+  lbt_busy_streak_ = 0;
+  return true;
+}
+
+// Учёт времени в эфире отправленного кадра (или серии кадров) для пейсинга и статистики
+void TxModule::recordAirtime(const std::chrono::steady_clock::time_point& start, uint32_t airtime_us) {
+  last_airtime_us_ = airtime_us;
+  if (last_airtime_us_ != 0) {
+    pacer_.onTransmit(start, last_airtime_us_);
+    DEBUG_LOG("TxModule: в эфире %u мкс, пауза %u мс",
+              static_cast<unsigned>(last_airtime_us_),
+              static_cast<unsigned>(currentPauseMs()));
+  }
+}
+
+void TxModule::setBurstEnabled(bool enabled) {
+  burst_enabled_ = enabled;
+}
+
+// Сколько фрагментов сообщения отправить одной серией. Серия возможна, только если пауза
+// между кадрами определяется временем в эфире (а не фиксированной PAUSE), бюджет duty cycle
+// покрывает всю серию и более важный класс QoS не ждёт своей очереди
+size_t TxModule::burstLength(const PendingMessage& message,
+                             const std::chrono::steady_clock::time_point& now) const {
+  const size_t remaining = message.fragments.size() - message.next_fragment;
+  if (!burst_enabled_ || remaining < 2 || !(airtime_pacing_ || lbtActive()) ||
+      hasHigherPriority(message.qos)) {
+    return 1;
+  }
+  const size_t limit = std::min<size_t>(remaining, DefaultSettings::TX_BURST_MAX_FRAMES);
+  uint64_t budget_us = static_cast<uint64_t>(pacer_.remainingBudgetMs(now)) * 1000ULL;
+  size_t count = 0;
+  for (; count < limit; ++count) {
+    const auto& frag = message.fragments[message.next_fragment + count];
+    const size_t frame_len = frameLenFor(headerLength(message, message.next_fragment + count), frag.payload_size);
+    const uint32_t airtime = radio_.airtimeUs(frame_len);
+    if (airtime == 0 || airtime > budget_us) break;
+    budget_us -= airtime;
+  }
+  return std::max<size_t>(count, 1);
+}
+
 void TxModule::setAckTimeout(uint32_t timeout_ms) {
   auto now = std::chrono::steady_clock::now();
   uint32_t previous_timeout = ack_timeout_ms_;
@@ -390,7 +799,7 @@ void TxModule::setAckTimeout(uint32_t timeout_ms) {
       inflight_->attempts_left = ack_retry_limit_;
       inflight_->expect_ack = false;
       if (had_waiting) {
-        inflight_.reset();
+        recycle(inflight_);
       }
     }
     if (delayed_) {
@@ -454,7 +863,7 @@ void TxModule::reloadKey() {
 }
 
 
-bool TxModule::transmit(PendingMessage& message) {
+bool TxModule::transmit(PendingMessage& message, SendSource source) {
   const auto& msg = message.data;
   if (msg.empty()) {
     DEBUG_LOG("TxModule: пустой пакет");
@@ -472,24 +881,100 @@ bool TxModule::transmit(PendingMessage& message) {
   if (!canSendFragment(message, now)) {
     return false;                                      // пауза ещё не истекла, попробуем в следующем цикле
   }
+  if (!listenBeforeTalk(now)) {
+    return false;                                      // CAD ещё идёт или канал занят
+  }
 
   if (message.is_plain) {
-    const int16_t sendState = radio_.send(msg.data(), msg.size());
-    if (sendState != IRadio::ERR_NONE) {
-      if (sendState == IRadio::ERR_TIMEOUT) {
-        DEBUG_LOG("TxModule: plain-пакет отложен — радио занято");
-        message.next_allowed_send = now + std::chrono::milliseconds(5);
-      } else {
-        DEBUG_LOG_VAL("TxModule: plain-пакет не отправлен, код=", sendState);
-      }
+    const IRadio::Frame frame{msg.data(), msg.size()};
+    return startSend(message, source, prefix, now, &frame, 1);
+  }
+
+  if (!ensureFragmentsReady(message)) {
+    DEBUG_LOG("TxModule: не удалось подготовить фрагменты");
+    return false;
+  }
+
+  if (message.next_fragment >= message.fragments.size()) {
+    message.completed = true;
+    if (!prefix.empty() && (!ack_enabled_ || !message.expect_ack)) {
+      SimpleLogger::logStatus(prefix + " GO");
+    }
+    return false;
+  }
+
+  // Несколько фрагментов подряд уходят одной серией, если пауза между ними не нужна
+  const size_t burst = burstLength(message, now);
+  std::vector<std::vector<uint8_t>> frames(burst);
+  std::array<IRadio::Frame, DefaultSettings::TX_BURST_MAX_FRAMES> radio_frames{};
+  for (size_t i = 0; i < burst; ++i) {
+    if (!buildFrame(message, message.next_fragment + i, frames[i])) {
       return false;
     }
-    last_send_ = now;
-    if (pause_ms_ != 0) {
-      message.next_allowed_send = now + std::chrono::milliseconds(pause_ms_);
+    radio_frames[i] = IRadio::Frame{frames[i].data(), frames[i].size()};
+  }
+
+  return startSend(message, source, prefix, now, radio_frames.data(), burst);
+}
+
+// Запуск передачи кадров; асинхронное радио завершит её позже через pollAsyncSend()
+bool TxModule::startSend(PendingMessage& message, SendSource source, const std::string& prefix,
+                         const std::chrono::steady_clock::time_point& now,
+                         const IRadio::Frame* frames, size_t count) {
+  std::array<uint32_t, DefaultSettings::TX_BURST_MAX_FRAMES> airtime_us{};
+  for (size_t i = 0; i < count; ++i) {
+    airtime_us[i] = radio_.airtimeUs(frames[i].len);
+  }
+  size_t sent = 0;
+  const int16_t state = radio_.startSendBurst(frames, count, sent);
+  if (state == IRadio::ERR_PENDING) {
+    async_.active = true;
+    async_.source = source;
+    async_.start = now;
+    async_.airtime_us = airtime_us;
+    async_.count = count;
+    async_.prefix = prefix;
+    return false;
+  }
+  return finishSend(message, prefix, now, airtime_us.data(), count, state, sent);
+}
+
+// Учёт результата передачи: пауза, время в эфире, продвижение по фрагментам и статусы
+bool TxModule::finishSend(PendingMessage& message, const std::string& prefix,
+                          const std::chrono::steady_clock::time_point& start,
+                          const uint32_t* airtime_us, size_t count, int16_t state, size_t sent) {
+  if (state != IRadio::ERR_NONE && sent == 0) {
+    if (state == IRadio::ERR_TIMEOUT) {
+      // Радио ещё передаёт чужую серию; сообщение остаётся первым в очереди без искусственной паузы
+      DEBUG_LOG(message.is_plain ? "TxModule: plain-пакет отложен — идёт передача"
+                                 : "TxModule: фрагмент отложен — идёт передача");
+    } else if (message.is_plain) {
+      DEBUG_LOG_VAL("TxModule: plain-пакет не отправлен, код=", state);
     } else {
-      message.next_allowed_send = std::chrono::steady_clock::time_point::min();
+      DEBUG_LOG_VAL("TxModule: ошибка отправки фрагмента, код=", state);
     }
+    return false;
+  }
+  if (state != IRadio::ERR_NONE) {
+    DEBUG_LOG("TxModule: серия прервана после %u из %u фрагментов, код=%d",
+              static_cast<unsigned>(sent), static_cast<unsigned>(count), static_cast<int>(state));
+  } else if (count > 1) {
+    DEBUG_LOG("TxModule: серия из %u фрагментов за один заход в TX", static_cast<unsigned>(count));
+  }
+  uint32_t total_airtime_us = 0;
+  for (size_t i = 0; i < sent; ++i) {
+    total_airtime_us += airtime_us[i];
+  }
+  last_send_ = start;
+  recordAirtime(start, total_airtime_us);
+  const uint32_t pause_ms = currentPauseMs();
+  if (pause_ms != 0) {
+    message.next_allowed_send = start + std::chrono::milliseconds(pause_ms);
+  } else {
+    message.next_allowed_send = std::chrono::steady_clock::time_point::min();
+  }
+
+  if (message.is_plain) {
     message.next_fragment = 1;
     message.completed = true;
     if (!prefix.empty() && (!ack_enabled_ || !message.expect_ack)) {
@@ -498,20 +983,62 @@ bool TxModule::transmit(PendingMessage& message) {
     return true;
   }
 
-  if (!ensureFragmentsReady(message)) {
-    DEBUG_LOG("TxModule: не удалось подготовить фрагменты");
-    return false;
+  for (size_t i = 0; i < sent; ++i) {
+    header_bytes_saved_ += static_cast<uint32_t>(FrameHeader::SIZE - headerLength(message, message.next_fragment + i));
   }
+  message.next_fragment += sent;
+  message.completed = message.next_fragment >= message.fragments.size();
 
-  if (message.next_fragment >= message.fragments.size()) {
-    message.completed = true;
-    if (!prefix.empty() && (!ack_enabled_ || !message.expect_ack)) {
+  if (!prefix.empty()) {
+    if (!message.completed || message.expect_ack) {
+      SimpleLogger::logStatus(prefix + " PROG");
+    } else if (!ack_enabled_ || !message.expect_ack) {
       SimpleLogger::logStatus(prefix + " GO");
     }
-    return false;
   }
 
-  auto& frag = message.fragments[message.next_fragment];
+  DEBUG_LOG_VAL("TxModule: отправлен фрагмент=", message.next_fragment - 1);
+  return true;
+}
+
+// Полный заголовок фрагмента сообщения
+static FrameHeader makeHeader(uint16_t msg_id, uint16_t frag_cnt, uint8_t flags, uint16_t frag_idx,
+                              uint16_t payload_len, uint8_t interleave) {
+  FrameHeader hdr;
+  hdr.ver = FRAME_VERSION_AEAD;
+  hdr.msg_id = msg_id;
+  hdr.frag_cnt = frag_cnt;
+  hdr.setFlags(flags);
+  hdr.setFragIdx(frag_idx);
+  hdr.setPayloadLen(payload_len);
+  hdr.interleave = interleave;
+  return hdr;
+}
+
+// Полный заголовок (контекст для дельт) несут первый фрагмент, каждый DELTA_HEADER_REFRESH-й
+// и фрагмент, чьи флаги или глубина интерливинга отличаются от предыдущего. Повтор сообщения
+// начинается с индекса 0, поэтому контекст восстанавливается и после потери кадра
+bool TxModule::fullHeaderAt(const PendingMessage& message, size_t index) const {
+  if (!delta_headers_ || index == 0 || index % DefaultSettings::DELTA_HEADER_REFRESH == 0) return true;
+  const auto& frag = message.fragments[index];
+  const auto& prev = message.fragments[index - 1];
+  return frag.header_flags != prev.header_flags || frag.frame_interleave != prev.frame_interleave ||
+         frag.payload_size > 0xFF;
+}
+
+// Длина заголовка фрагмента index в кадре
+size_t TxModule::headerLength(const PendingMessage& message, size_t index) const {
+  if (fullHeaderAt(message, index)) return FrameHeader::SIZE;
+  size_t ctx = index - 1;
+  while (!fullHeaderAt(message, ctx)) --ctx;
+  return message.fragments[index].payload_size == message.fragments[ctx].payload_size
+             ? delta_header::DELTA_SHORT_SIZE
+             : delta_header::DELTA_SIZE;
+}
+
+// Сборка кадра фрагмента: заголовок, пилоты и скремблирование
+bool TxModule::buildFrame(const PendingMessage& message, size_t index, std::vector<uint8_t>& frame) {
+  const PreparedFragment& frag = message.fragments[index];
   uint32_t header_meta = packMetadata(frag.header_flags,
                                       static_cast<uint16_t>(frag.chunk_idx),
                                       frag.payload_size);
@@ -520,23 +1047,32 @@ bool TxModule::transmit(PendingMessage& message) {
     return false;
   }
 
-  FrameHeader hdr;
-  hdr.ver = FRAME_VERSION_AEAD;
-  hdr.msg_id = static_cast<uint16_t>(message.id);
-  hdr.frag_cnt = static_cast<uint16_t>(message.fragments.size());
-  hdr.setFlags(frag.header_flags);
-  hdr.setFragIdx(static_cast<uint16_t>(frag.chunk_idx));
-  hdr.setPayloadLen(frag.payload_size);
-
+  const uint16_t frag_cnt = message.frag_cnt ? message.frag_cnt : static_cast<uint16_t>(message.fragments.size());
+  FrameHeader hdr = makeHeader(static_cast<uint16_t>(message.id), frag_cnt, frag.header_flags,
+                               static_cast<uint16_t>(frag.chunk_idx), frag.payload_size, frag.frame_interleave);
   std::array<uint8_t, MAX_FRAME_SIZE> frame_buf{};
   uint8_t hdr_buf[FrameHeader::SIZE];
   if (!hdr.encode(hdr_buf, sizeof(hdr_buf), frag.payload.data(), frag.payload_size)) {
     LOG_ERROR("TxModule: не удалось закодировать заголовок");
     return false;
   }
+  size_t hdr_len = FrameHeader::SIZE;
+  if (!fullHeaderAt(message, index)) {
+    size_t ctx = index - 1;
+    while (!fullHeaderAt(message, ctx)) --ctx;
+    const auto& ctx_frag = message.fragments[ctx];
+    const FrameHeader context = makeHeader(hdr.msg_id, frag_cnt, ctx_frag.header_flags,
+                                           static_cast<uint16_t>(ctx_frag.chunk_idx), ctx_frag.payload_size,
+                                           ctx_frag.frame_interleave);
+    hdr_len = delta_header::encodeDelta(context, hdr, hdr_buf, sizeof(hdr_buf));
+    if (hdr_len == 0) {
+      LOG_ERROR("TxModule: не удалось закодировать дельта-заголовок");
+      return false;
+    }
+  }
   size_t frame_size = 0;
-  std::memcpy(frame_buf.data() + frame_size, hdr_buf, FrameHeader::SIZE);
-  frame_size += FrameHeader::SIZE;
+  std::memcpy(frame_buf.data() + frame_size, hdr_buf, hdr_len);
+  frame_size += hdr_len;
 
   size_t payload_bytes = insertPilots(frag.payload.data(), frag.payload_size,
                                       frame_buf.data() + frame_size,
@@ -577,37 +1113,46 @@ bool TxModule::transmit(PendingMessage& message) {
     LOG_ERROR_VAL("TxModule: превышен размер кадра=", frame_size);
     return false;
   }
+  frame.assign(frame_buf.begin(), frame_buf.begin() + frame_size);
+  return true;
+}
 
-  const int16_t sendState = radio_.send(frame_buf.data(), frame_size);
-  if (sendState != IRadio::ERR_NONE) {
-    if (sendState == IRadio::ERR_TIMEOUT) {
-      DEBUG_LOG("TxModule: фрагмент отложен — радио занято");
-      message.next_allowed_send = now + std::chrono::milliseconds(5);
-    } else {
-      DEBUG_LOG_VAL("TxModule: ошибка отправки фрагмента, код=", sendState);
-    }
-    return false;
-  }
-  last_send_ = now;
-  if (pause_ms_ != 0) {
-    message.next_allowed_send = now + std::chrono::milliseconds(pause_ms_);
-  } else {
-    message.next_allowed_send = std::chrono::steady_clock::time_point::min();
+// Профиль FEC для новых сообщений: адаптация канала или конфигурация, HARQ начинает с 5/6;
+// без прокалывания любая скорость сводится к 1/2
+fec::Profile TxModule::activeProfile() const {
+  fec::Profile profile = fec_override_ ? *fec_override_ : fec::currentProfile();
+  if (!puncturing_enabled_) {
+    profile.conv_rate = conv_codec::Rate::R1_2;
+  } else if (harq_enabled_ && profile.use_conv) {
+    profile.conv_rate = conv_codec::Rate::R5_6;            // первая версия HARQ — самая высокая скорость
   }
+  return profile;
+}
 
-  ++message.next_fragment;
-  message.completed = message.next_fragment >= message.fragments.size();
+// Время между кадрами сверх их длительности: разворот TX→RX, в серии — одна пауза на серию
+uint32_t TxModule::frameOverheadUs() const {
+  const uint32_t turnaround_us = DefaultSettings::RX_TURNAROUND_MS * 1000U;
+  return burst_enabled_ ? turnaround_us / DefaultSettings::TX_BURST_MAX_FRAMES : turnaround_us;
+}
 
-  if (!prefix.empty()) {
-    if (!message.completed || message.expect_ack) {
-      SimpleLogger::logStatus(prefix + " PROG");
-    } else if (!ack_enabled_ || !message.expect_ack) {
-      SimpleLogger::logStatus(prefix + " GO");
-    }
-  }
+fragment_planner::Plan TxModule::planFor(size_t len, const fec::Profile& profile, size_t max_chunk) const {
+  const size_t header_len = delta_headers_ ? delta_header::DELTA_SHORT_SIZE : FrameHeader::SIZE;
+  fragment_planner::Plan plan;
+  fragment_planner::plan(len, 1, max_chunk, frameOverheadUs(), [&](size_t chunk) {
+    return radio_.airtimeUs(frameLenFor(header_len, fragmentPayloadLen(chunk, profile)));
+  }, plan);
+  return plan;
+}
 
-  DEBUG_LOG_VAL("TxModule: отправлен фрагмент=", message.next_fragment - 1);
-  return true;
+fragment_planner::Plan TxModule::planFragments(size_t len) const {
+  const fec::Profile profile = activeProfile();
+  return planFor(len, profile, dataChunkFor(profile));
+}
+
+uint64_t TxModule::predictAirtimeUs(size_t len, bool framed) const {
+  if (len == 0 || radio_.airtimeUs(len) == 0) return 0;
+  if (framed) return planFragments(len).airtime_us;
+  return static_cast<uint64_t>(radio_.airtimeUs(len)) + frameOverheadUs();
 }
 
 bool TxModule::ensureFragmentsReady(PendingMessage& message) {
@@ -625,6 +1170,7 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
   }
 
   message.fragments.clear();
+  message.frag_cnt = 0;
   message.next_fragment = 0;
   message.completed = false;
 
@@ -639,41 +1185,99 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
     return true;
   }
 
-  PacketSplitter rs_splitter(PayloadMode::SMALL, EFFECTIVE_DATA_CHUNK);
-  MessageBuffer tmp((msg.size() + EFFECTIVE_DATA_CHUNK - 1) / EFFECTIVE_DATA_CHUNK);
-  rs_splitter.splitAndEnqueue(tmp, msg.data(), msg.size(), false);
-
-  std::vector<uint8_t> part;
-  part.reserve(tmp.slotSize());
-  std::vector<std::vector<uint8_t>> plain_parts;
-  while (tmp.hasPending()) {
-    part.clear();
-    uint16_t dummy = 0;
-    if (!tmp.pop(dummy, part)) break;
-    plain_parts.push_back(part);
+  fec::Profile fec_cfg = activeProfile();
+  // Неравная защита JPEG: маркерные сегменты идут на скорости 1/2 с битовым интерливингом,
+  // данные скана — не медленнее UEP_SCAN_RATE
+  fec::Profile strong_cfg = fec_cfg;
+  std::vector<jpeg_uep::Segment> uep_parts;
+  if (message.jpeg_uep) {
+    fec::Profile header_cfg = fec_cfg;
+    header_cfg.use_conv = true;
+    header_cfg.use_bit_interleaver = true;
+    header_cfg.conv_rate = conv_codec::Rate::R1_2;
+    fec::Profile scan_cfg = fec_cfg;
+    if (puncturing_enabled_ && static_cast<uint8_t>(scan_cfg.conv_rate) < DefaultSettings::UEP_SCAN_RATE) {
+      scan_cfg.conv_rate = static_cast<conv_codec::Rate>(DefaultSettings::UEP_SCAN_RATE);
+    }
+    if (jpeg_uep::plan(msg.data(), msg.size(), dataChunkFor(header_cfg), dataChunkFor(scan_cfg), uep_parts)) {
+      strong_cfg = header_cfg;
+      fec_cfg = scan_cfg;
+    } else {
+      LOG_WARN("TxModule: JPEG id=%u не разобран, части без неравной защиты",
+               static_cast<unsigned>(message.id));
+    }
   }
-
-  if (plain_parts.empty()) {
-    LOG_ERROR("TxModule: разделитель вернул пустые части");
+  const size_t data_chunk = dataChunkFor(fec_cfg);
+  const size_t max_cipher_chunk = std::max(data_chunk, dataChunkFor(strong_cfg)) + TAG_LEN;
+  // Внешний код: исходные части короче на префикс длины, чтобы восстановительный фрагмент
+  // с тем же символом уложился в data_chunk. Части разной длины (JPEG) им не покрываются
+  const size_t outer_chunk = data_chunk - erasure::LEN_PREFIX;
+  const size_t outer_k = (msg.size() + outer_chunk - 1) / outer_chunk;
+  const size_t outer_repair = (outer_fec_percent_ && uep_parts.empty() &&
+                               outer_k >= DefaultSettings::OUTER_FEC_MIN_FRAGMENTS)
+                                  ? erasure::repairCount(outer_k, outer_fec_percent_)
+                                  : 0;
+
+  // Части читаются прямо из буфера сообщения: курсор выдаёт участки по split_chunk,
+  // для JPEG участки задаёт план неравной защиты. Копируются только восстановительные символы
+  size_t split_chunk = outer_repair ? outer_chunk : data_chunk;
+  if (uep_parts.empty() && !outer_repair && airtime_planning_) {
+    const auto plan = planFor(msg.size(), fec_cfg, data_chunk);
+    if (plan.count) split_chunk = plan.chunk;
+  }
+  const packetizer::FragmentCursor cursor(msg.data(), msg.size(), split_chunk);
+  const size_t source_count = uep_parts.empty() ? cursor.count() : uep_parts.size();
+  if (source_count == 0) {
+    LOG_ERROR("TxModule: сообщение не разделено на части");
     return false;
   }
 
-  message.fragments.reserve(plain_parts.size());
+  // Восстановительные фрагменты идут после исходных с номерами K..K+R-1, в заголовке frag_cnt = K
+  uint16_t total_fragments = static_cast<uint16_t>(source_count);
+  std::vector<std::vector<uint8_t>> repair;
+  if (outer_repair) {
+    if (erasure::buildRepair(msg.data(), msg.size(), split_chunk, outer_repair, repair)) {
+      message.frag_cnt = total_fragments;
+      repair_fragment_count_ += static_cast<uint32_t>(outer_repair);
+      DEBUG_LOG("TxModule: внешний код для id=%u: %u исходных + %u восстановительных",
+                static_cast<unsigned>(message.id), static_cast<unsigned>(total_fragments),
+                static_cast<unsigned>(outer_repair));
+    } else {
+      repair.clear();
+    }
+  }
+  const size_t part_count = source_count + repair.size();
+  // Часть part_idx без копирования; critical — маркерный сегмент JPEG
+  auto partAt = [&](size_t part_idx, packetizer::Span& span, bool& critical) {
+    critical = false;
+    if (part_idx >= source_count) {
+      const auto& sym = repair[part_idx - source_count];
+      span.data = sym.data();
+      span.len = sym.size();
+      span.offset = 0;
+      span.index = static_cast<uint16_t>(part_idx);
+    } else if (!uep_parts.empty()) {
+      const auto& seg = uep_parts[part_idx];
+      span.data = msg.data() + seg.offset;
+      span.len = seg.len;
+      span.offset = seg.offset;
+      span.index = static_cast<uint16_t>(part_idx);
+      critical = seg.critical;
+    } else {
+      cursor.at(part_idx, span);
+    }
+  };
+
+  message.fragments.reserve(part_count);
 
-  const auto& radio_cfg = ConfigLoader::getConfig().radio;
-  const bool conv_config = radio_cfg.useConv;
-  const bool rs_config = radio_cfg.useRs;
-  const bool bit_config = radio_cfg.useBitInterleaver;
-  const bool rs_allowed = conv_config && rs_config;
-  const bool bit_allowed = conv_config && bit_config;
   static bool warned_rs_without_conv = false;
-  if (rs_config && !conv_config && !warned_rs_without_conv) {
+  if (fec_cfg.use_rs && !fec_cfg.use_conv && !warned_rs_without_conv) {
     LOG_WARN("TxModule: useRs=true при отключённой свёртке, RS-кодирование будет игнорировано");
     warned_rs_without_conv = true;
   }
 
   std::vector<uint8_t> enc;
-  enc.reserve(MAX_CIPHER_CHUNK);
+  enc.reserve(max_cipher_chunk);
   std::vector<uint8_t> tag;
   tag.reserve(TAG_LEN);
   std::vector<uint8_t> conv;
@@ -681,29 +1285,38 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
   std::vector<uint8_t> conv_input;
   conv_input.reserve(RS_ENC_LEN + CONV_TAIL_BYTES);
 
-  uint16_t total_fragments = static_cast<uint16_t>(plain_parts.size());
   auto abortPreparation = [&]() {
     message.fragments.clear();
+    message.frag_cnt = 0;
     message.next_fragment = 0;
     message.completed = false;
     return false;
   };
 
-  for (size_t part_idx = 0; part_idx < plain_parts.size(); ++part_idx) {
-    const auto& stored_part = plain_parts[part_idx];
+  packetizer::Span part;
+  bool critical = false;
+  for (size_t part_idx = 0; part_idx < part_count; ++part_idx) {
+    partAt(part_idx, part, critical);
+    const fec::Profile& part_cfg = critical ? strong_cfg : fec_cfg;
+    const bool conv_config = part_cfg.use_conv;
+    const conv_codec::Rate conv_rate = part_cfg.conv_rate;
+    const uint8_t rate_bits = static_cast<uint8_t>((static_cast<uint8_t>(conv_rate) << FrameHeader::CONV_RATE_SHIFT) &
+                                                   FrameHeader::CONV_RATE_MASK);
+    const bool rs_allowed = conv_config && part_cfg.use_rs;
+    const bool bit_allowed = conv_config && part_cfg.use_bit_interleaver;
     enc.clear();
     tag.clear();
     conv.clear();
     conv_input.clear();
 
-    const size_t plain_len = stored_part.size();
+    const size_t plain_len = part.len;
     uint16_t current_idx = static_cast<uint16_t>(part_idx);
     uint8_t base_flags = 0;
     if (encryption_enabled_) base_flags |= FrameHeader::FLAG_ENCRYPTED;
     if (message.expect_ack) base_flags |= FrameHeader::FLAG_ACK_REQUIRED;
 
     size_t cipher_len_guess = plain_len + TAG_LEN;
-    if (cipher_len_guess > MAX_CIPHER_CHUNK) {
+    if (cipher_len_guess > max_cipher_chunk) {
       LOG_ERROR_VAL("TxModule: ожидаемый шифртекст превышает лимит=", cipher_len_guess);
       return abortPreparation();
     }
@@ -715,7 +1328,7 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
     if (conv_config && cipher_len_guess > 0) {
       if (rs_allowed && cipher_len_guess == RS_DATA_LEN) {
         size_t conv_input_len = RS_ENC_LEN + CONV_TAIL_BYTES;
-        size_t conv_payload_len = conv_input_len * 2;
+        size_t conv_payload_len = conv_codec::encodedSize(conv_input_len, conv_rate);
         if (conv_payload_len <= MAX_FRAGMENT_LEN) {
           conv_expected = true;
           planned_rs = true;
@@ -724,7 +1337,7 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
       }
       if (!conv_expected) {
         size_t conv_input_len = cipher_len_guess + CONV_TAIL_BYTES;
-        size_t conv_payload_len = conv_input_len * 2;
+        size_t conv_payload_len = conv_codec::encodedSize(conv_input_len, conv_rate);
         if (conv_payload_len <= MAX_FRAGMENT_LEN) {
           conv_expected = true;
           payload_guess = conv_payload_len;
@@ -741,7 +1354,7 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
     }
 
     uint8_t planned_flags = base_flags;
-    if (conv_expected) planned_flags |= FrameHeader::FLAG_CONV_ENCODED;
+    if (conv_expected) planned_flags |= FrameHeader::FLAG_CONV_ENCODED | rate_bits;
     if (planned_rs) planned_flags |= FrameHeader::FLAG_RS_ENCODED;
     if (planned_bit_interleaver) planned_flags |= FrameHeader::FLAG_BIT_INTERLEAVED;
     uint32_t packed_meta = packMetadata(planned_flags, current_idx, static_cast<uint16_t>(payload_guess));
@@ -758,19 +1371,19 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
       if (!g_encrypt_impl(key_.data(), key_.size(),
                           nonce.data(), nonce.size(),
                           aad.data(), aad.size(),
-                          stored_part.data(), stored_part.size(),
+                          part.data, part.len,
                           enc, tag)) {
         LOG_ERROR("TxModule: ошибка шифрования");
         return abortPreparation();
       }
       enc.insert(enc.end(), tag.begin(), tag.end());
     } else {
-      enc.assign(stored_part.begin(), stored_part.end());
+      enc.assign(part.data, part.data + part.len);
       enc.insert(enc.end(), TAG_LEN, 0x00);
     }
 
     const size_t cipher_len = enc.size();
-    if (cipher_len > MAX_CIPHER_CHUNK) {
+    if (cipher_len > max_cipher_chunk) {
       LOG_ERROR_VAL("TxModule: блок шифртекста превышает лимит=", cipher_len);
       return abortPreparation();
     }
@@ -785,13 +1398,13 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
         byte_interleaver::interleave(rs_buf, RS_ENC_LEN);
         conv_input.assign(rs_buf, rs_buf + RS_ENC_LEN);
         conv_input.insert(conv_input.end(), CONV_TAIL_BYTES, 0x00);
-        conv_codec::encodeBits(conv_input.data(), conv_input.size(), conv);
+        conv_codec::encodeBits(conv_input.data(), conv_input.size(), conv, conv_rate);
         conv_applied = true;
         rs_applied = true;
       } else if (!enc.empty()) {
         conv_input.assign(enc.begin(), enc.end());
         conv_input.insert(conv_input.end(), CONV_TAIL_BYTES, 0x00);
-        conv_codec::encodeBits(conv_input.data(), conv_input.size(), conv);
+        conv_codec::encodeBits(conv_input.data(), conv_input.size(), conv, conv_rate);
         conv_applied = true;
       }
       if (conv_applied && bit_allowed && !conv.empty()) {
@@ -815,7 +1428,7 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
     frag.payload.assign(conv.begin(), conv.end());
 
     uint8_t final_flags = base_flags;
-    if (conv_applied) final_flags |= FrameHeader::FLAG_CONV_ENCODED;
+    if (conv_applied) final_flags |= FrameHeader::FLAG_CONV_ENCODED | rate_bits;
     if (rs_applied) final_flags |= FrameHeader::FLAG_RS_ENCODED;
     if (bit_applied) final_flags |= FrameHeader::FLAG_BIT_INTERLEAVED;
     uint32_t final_meta = packMetadata(final_flags, current_idx, frag.payload_size);
@@ -832,9 +1445,12 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
     frag.chunk_idx = current_idx;
     frag.header_flags = final_flags;
     frag.packed_meta = final_meta;
+    if (harq_enabled_ && conv_applied && !critical) {
+      frag.coded_input = conv_input;                     // из него строятся версии по NACK
+    }
     message.fragments.push_back(frag);
-    DEBUG_LOG("TxModule: фрагмент idx=%u rs=%u conv=%u bit=%u payload=%u", static_cast<unsigned>(current_idx),
-              rs_applied ? 1U : 0U, conv_applied ? 1U : 0U, bit_applied ? 1U : 0U,
+    DEBUG_LOG("TxModule: фрагмент idx=%u rs=%u conv=%u(%s) bit=%u payload=%u", static_cast<unsigned>(current_idx),
+              rs_applied ? 1U : 0U, conv_applied ? 1U : 0U, conv_codec::rateName(conv_rate), bit_applied ? 1U : 0U,
               static_cast<unsigned>(frag.payload_size));
   }
 
@@ -843,17 +1459,139 @@ bool TxModule::ensureFragmentsReady(PendingMessage& message) {
     return false;
   }
 
+  // Межкадровый интерливинг: группы по depth соседних фрагментов, начиная с индекса 0.
+  // Перемежаются только группы из блоков одной длины, хвост сообщения уходит как есть
+  const uint8_t depth = std::min(fec_cfg.frame_interleave, frame_interleaver::MAX_DEPTH);
+  if (depth > 1) {
+    std::array<uint8_t*, frame_interleaver::MAX_DEPTH> rows{};
+    for (size_t start = 0; start + depth <= message.fragments.size(); start += depth) {
+      const size_t len = message.fragments[start].payload.size();
+      bool same_len = true;
+      for (size_t j = 0; j < depth; ++j) {
+        auto& frag = message.fragments[start + j];
+        same_len = same_len && frag.payload.size() == len;
+        rows[j] = frag.payload.data();
+      }
+      if (!same_len || !frame_interleaver::interleave(rows.data(), depth, len)) continue;
+      for (size_t j = 0; j < depth; ++j) {
+        message.fragments[start + j].frame_interleave = depth;
+      }
+    }
+  }
+
+  // Повторы защищённых частей JPEG уходят после скана: замирание реже накрывает обе копии.
+  // Копия — тот же кадр с тем же индексом, приёмник отбрасывает её или складывает с первой
+  if (!uep_parts.empty() && DefaultSettings::UEP_HEADER_COPIES > 1) {
+    message.frag_cnt = static_cast<uint16_t>(message.fragments.size());
+    const size_t unique = message.fragments.size();
+    for (uint8_t copy = 1; copy < DefaultSettings::UEP_HEADER_COPIES; ++copy) {
+      for (size_t i = 0; i < unique; ++i) {
+        if (!uep_parts[i].critical) continue;
+        message.fragments.push_back(message.fragments[i]);
+        ++uep_copy_count_;
+      }
+    }
+  }
+
+  const bool has_harq_input = std::any_of(message.fragments.begin(), message.fragments.end(),
+                                          [](const PreparedFragment& f) { return !f.coded_input.empty(); });
+  if (harq_enabled_ && has_harq_input) {
+    harq_history_.push_back(message);                    // NACK может прийти и после снятия с отправки
+    while (harq_history_.size() > DefaultSettings::HARQ_HISTORY) {
+      harq_history_.pop_front();
+    }
+  }
+
+  return true;
+}
+
+bool TxModule::onNackReceived(uint16_t msg_id, uint16_t frag_idx, uint8_t rv) {
+  if (rv >= harq::RV_COUNT) {
+    DEBUG_LOG("TxModule: NACK с недопустимой версией rv=%u", static_cast<unsigned>(rv));
+    return false;
+  }
+  // Идентификаторы уникальны только внутри класса QoS (каждый MessageBuffer начинает с 1), а NACK
+  // несёт лишь id из заголовка кадра: сообщения сравниваем по queueKey() и, если тот же id есть
+  // в нескольких классах, не угадываем — избыточность чужого фрагмента приёмнику только навредит
+  const PreparedFragment* src = nullptr;
+  uint16_t src_frag_cnt = 0;
+  uint32_t src_key = 0;
+  bool ambiguous = false;
+  auto lookup = [&](const PendingMessage& message) {
+    if (message.id != msg_id) return;
+    const uint32_t key = queueKey(message.qos, message.id);
+    for (const auto& frag : message.fragments) {
+      if (frag.chunk_idx != frag_idx || frag.coded_input.empty()) continue;
+      if (!src) {                                        // самое свежее сообщение класса
+        src = &frag;
+        src_key = key;
+        src_frag_cnt = message.frag_cnt ? message.frag_cnt : static_cast<uint16_t>(message.fragments.size());
+      } else if (key != src_key) {
+        ambiguous = true;
+      }
+      return;
+    }
+  };
+  if (inflight_) lookup(*inflight_);
+  for (auto it = harq_history_.rbegin(); it != harq_history_.rend(); ++it) {
+    lookup(*it);
+  }
+  if (!src) {
+    DEBUG_LOG("TxModule: NACK для неизвестного фрагмента id=%u idx=%u",
+              static_cast<unsigned>(msg_id), static_cast<unsigned>(frag_idx));
+    return false;
+  }
+  if (ambiguous) {
+    DEBUG_LOG("TxModule: NACK id=%u idx=%u подходит сообщениям разных классов QoS, пропущен",
+              static_cast<unsigned>(msg_id), static_cast<unsigned>(frag_idx));
+    return false;
+  }
+
+  PreparedFragment frag;
+  if (!harq::buildRedundancy(src->coded_input.data(), src->coded_input.size(), rv, frag.payload)) {
+    return false;
+  }
+  if (src->bit_interleaved && !frag.payload.empty()) {
+    bit_interleaver::interleave(frag.payload.data(), frag.payload.size());
+  }
+  const uint8_t keep = FrameHeader::FLAG_ENCRYPTED | FrameHeader::FLAG_ACK_REQUIRED |
+                       FrameHeader::FLAG_RS_ENCODED | FrameHeader::FLAG_BIT_INTERLEAVED;
+  frag.header_flags = static_cast<uint8_t>((src->header_flags & keep) | FrameHeader::FLAG_CONV_ENCODED |
+                                           FrameHeader::FLAG_HARQ_REDUNDANCY |
+                                           ((rv << FrameHeader::CONV_RATE_SHIFT) & FrameHeader::CONV_RATE_MASK));
+  frag.payload_size = static_cast<uint16_t>(frag.payload.size());
+  frag.conv_encoded = true;
+  frag.rs_encoded = src->rs_encoded;
+  frag.bit_interleaved = src->bit_interleaved;
+  frag.cipher_len = src->cipher_len;
+  frag.plain_len = src->plain_len;
+  frag.chunk_idx = src->chunk_idx;
+  frag.packed_meta = packMetadata(frag.header_flags, frag.chunk_idx, frag.payload_size);
+
+  // Избыточность уходит вне очереди, как ACK: приёмник держит первую версию и ждёт ответа
+  PendingMessage redundancy;
+  redundancy.id = msg_id;
+  redundancy.data = frag.payload;
+  redundancy.is_ack = true;
+  redundancy.frag_cnt = src_frag_cnt;                   // заголовок как у исходного фрагмента
+  redundancy.next_allowed_send = std::chrono::steady_clock::time_point::min();
+  redundancy.fragments.push_back(std::move(frag));
+  ack_queue_.push_back(std::move(redundancy));
+  ++harq_redundancy_count_;
+  DEBUG_LOG("TxModule: NACK id=%u idx=%u, поставлена версия rv=%u",
+            static_cast<unsigned>(msg_id), static_cast<unsigned>(frag_idx), static_cast<unsigned>(rv));
   return true;
 }
 
 bool TxModule::canSendFragment(PendingMessage& message, const std::chrono::steady_clock::time_point& now) {
-  if (pause_ms_ == 0) {
+  const uint32_t pause_ms = currentPauseMs();
+  if (pause_ms == 0) {
     return true;
   }
   auto sentinel = std::chrono::steady_clock::time_point::min();
   auto target = message.next_allowed_send;
   if (target == sentinel) {
-    target = last_send_ + std::chrono::milliseconds(pause_ms_);
+    target = last_send_ + std::chrono::milliseconds(pause_ms);
     message.next_allowed_send = target;
   }
   if (now < target) {
@@ -870,11 +1608,12 @@ bool TxModule::isAckPayload(const std::vector<uint8_t>& data) {
   return protocol::ack::isAckPayload(data);
 }
 
-std::string TxModule::extractPacketTag(const std::vector<uint8_t>& data) {
-  if (data.empty() || data.front() != '[') return {};
-  auto pipe = std::find(data.begin(), data.end(), '|');
-  if (pipe == data.end() || pipe == data.begin() + 1) return {};
-  return std::string(data.begin() + 1, pipe);          // возвращаем часть между '[' и '|'
+std::string TxModule::extractPacketTag(const uint8_t* data, size_t len) {
+  if (!data || len == 0 || data[0] != '[') return {};
+  const uint8_t* end = data + len;
+  const uint8_t* pipe = std::find(data, end, '|');
+  if (pipe == end || pipe == data + 1) return {};
+  return std::string(data + 1, pipe);                  // возвращаем часть между '[' и '|'
 }
 
 std::string TxModule::extractStatusPrefix(const std::vector<uint8_t>& data) {
@@ -888,10 +1627,9 @@ void TxModule::archiveFollowingParts(uint8_t qos, const std::string& tag) {
   if (tag.empty() || qos >= buffers_.size()) return;    // нет смысла обрабатывать пустой тег
   auto& buf = buffers_[qos];
   while (true) {
-    uint16_t peek_id = 0;
-    const std::vector<uint8_t>* next = buf.peek(peek_id);
-    if (!next) break;                                   // очередь пуста
-    if (extractPacketTag(*next) != tag) break;          // следующий элемент принадлежит другому пакету
+    MessageBuffer::View next;
+    if (!buf.peek(next)) break;                         // очередь пуста
+    if (extractPacketTag(next.data, next.len) != tag) break; // следующий элемент принадлежит другому пакету
     uint16_t id = 0;
     std::vector<uint8_t> data;
     if (!buf.pop(id, data)) break;                      // защита от расхождений между peek и pop
@@ -899,7 +1637,8 @@ void TxModule::archiveFollowingParts(uint8_t qos, const std::string& tag) {
     archived.id = id;
     archived.data = std::move(data);
     archived.qos = qos;
-    archived.is_plain = plain_messages_.erase(id) > 0;
+    archived.is_plain = plain_messages_.erase(queueKey(qos, id)) > 0;
+    archived.jpeg_uep = uep_messages_.erase(queueKey(qos, id)) > 0;
     if (archived.is_plain) {
       archived.attempts_left = 0;                      // «сырые» пакеты не требуют повторов
       archived.expect_ack = false;
@@ -938,13 +1677,40 @@ void TxModule::scheduleFromArchive() {
   DEBUG_LOG("TxModule: восстановлен пакет из архива");
 }
 
+// Есть ли сообщения более высокого приоритета, чем указанный класс QoS
+bool TxModule::hasHigherPriority(uint8_t qos) const {
+  for (size_t i = 0; i < qos && i < buffers_.size(); ++i) {
+    if (parked_[i] || buffers_[i].hasPending()) return true;
+  }
+  return false;
+}
+
+// Приостановка частично отправленного сообщения, если ждут кадры более важного класса.
+// Прогресс (индекс фрагмента, подготовленные фрагменты, таймер паузы) сохраняется в parked_,
+// поэтому после отправки срочных данных передача продолжается с того же места.
+bool TxModule::preemptCurrent(std::optional<PendingMessage>& current) {
+  if (!current || current->completed || current->is_ack) return false;
+  if (current->qos >= parked_.size()) return false;
+  if (!hasHigherPriority(current->qos)) return false;
+  auto& slot = parked_[current->qos];
+  if (slot) return false;                          // слот класса занят — продолжаем без вытеснения
+  DEBUG_LOG("TxModule: передача id=%u qos=%u приостановлена на фрагменте %u",
+            static_cast<unsigned>(current->id),
+            static_cast<unsigned>(current->qos),
+            static_cast<unsigned>(current->next_fragment));
+  slot.emplace(std::move(*current));
+  current.reset();
+  return true;
+}
+
 void TxModule::onSendSuccess() {
   scheduleFromArchive();
 }
 
 bool TxModule::waitForPauseWindow() {
-  if (pause_ms_ == 0) return true;
-  auto target = last_send_ + std::chrono::milliseconds(pause_ms_);
+  const uint32_t pause_ms = currentPauseMs();
+  if (pause_ms == 0) return true;
+  auto target = last_send_ + std::chrono::milliseconds(pause_ms);
   auto now = std::chrono::steady_clock::now();
   if (now >= target) return true;
   const int16_t ensureState = radio_.ensureReceiveMode();
@@ -964,19 +1730,24 @@ bool TxModule::processImmediateAck() {
     }
     return true;                                   // сообщаем циклу, что ACK ещё ожидает отправки
   }
-  PendingMessage ack = std::move(ack_queue_.front());
-  ack_queue_.pop_front();
-  const uint16_t ack_id = ack.id;
-  const uint8_t ack_qos = ack.qos;
-  bool sent = transmit(ack);                      // отправляем ACK отдельной веткой
-  if (!sent) {                                    // не удалось — возвращаем в начало очереди
-    ack_queue_.push_front(std::move(ack));
+  const bool sent = transmit(ack_queue_.front(), SendSource::ACK); // ACK остаётся в очереди до конца передачи
+  if (async_.active) {
+    return true;                                   // ACK в эфире, итог заберёт pollAsyncSend()
+  }
+  return completeImmediateAck(sent);
+}
+
+bool TxModule::completeImmediateAck(bool sent) {
+  if (!sent) {                                    // не удалось — ACK остаётся в начале очереди
     auto retry = std::chrono::steady_clock::now();
     next_ack_send_time_ = ack_delay_ms_ == 0
                               ? retry
                               : retry + std::chrono::milliseconds(ack_delay_ms_); // готовим новую попытку
     return false;
   }
+  const uint16_t ack_id = ack_queue_.front().id;
+  const uint8_t ack_qos = ack_queue_.front().qos;
+  ack_queue_.pop_front();
   onSendSuccess();                                // позволяем архиву продолжить отдачу
   auto sent_at = std::chrono::steady_clock::now();
   next_ack_send_time_ = ack_delay_ms_ == 0
@@ -997,7 +1768,10 @@ void TxModule::setAckEnabled(bool enabled) {
     if (inflight_) {
       inflight_->expect_ack = false;
       inflight_->attempts_left = ack_retry_limit_;
-      inflight_.reset();
+      recycle(inflight_);
+    }
+    for (auto& parked : parked_) {
+      if (parked) parked->expect_ack = false;      // приостановленные сообщения больше не ждут ACK
     }
     scheduleFromArchive();
   }
@@ -1031,7 +1805,7 @@ void TxModule::setAckRetryLimit(uint8_t retries) {
         SimpleLogger::logStatus(inflight_->status_prefix + " GO");
       }
       inflight_->attempts_left = ack_retry_limit_;
-      inflight_.reset();
+      recycle(inflight_);
     }
     onSendSuccess();
   }
@@ -1049,12 +1823,14 @@ void TxModule::onAckReceived() {
   waiting_ack_ = false;
   if (had_inflight) {
     inflight_->attempts_left = ack_retry_limit_;
-    inflight_.reset();
+    recycle(inflight_);
   }
-  if (pause_ms_ != 0) {
-    last_send_ = std::chrono::steady_clock::now() - std::chrono::milliseconds(pause_ms_); // снимаем ограничение паузы после подтверждения
+  const uint32_t pause_ms = currentPauseMs();
+  if (pause_ms != 0) {
+    last_send_ = std::chrono::steady_clock::now() - std::chrono::milliseconds(pause_ms); // снимаем ограничение паузы после подтверждения
   }
   if (had_inflight) {
+    ++ack_success_count_;
     DEBUG_LOG("TxModule: ACK получен для id=%u qos=%u",
               static_cast<unsigned int>(inflight_id),
               static_cast<unsigned int>(inflight_qos));
@@ -1074,6 +1850,7 @@ void TxModule::setEncryptionEnabled(bool enabled) {
 }
 
 void TxModule::prepareExternalSend() {
+  waitForSendCompletion();                        // внешняя отправка не должна прерывать кадры очереди
   while (!waitForPauseWindow()) {
 #ifdef ARDUINO
     yield();
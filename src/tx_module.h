@@ -1,15 +1,21 @@
 #pragma once
 #include <cstdint>
+#include <atomic>
 #include <chrono>
 #include <array>
 #include <deque>
 #include <optional>
+#include <random>
 #include <vector>
 #include <string>
 #include <unordered_set>
 #include "radio_interface.h"
+#include "libs/fec/fec_profile.h"
 #include "message_buffer.h"
 #include "libs/packetizer/packet_splitter.h" // подключаем разделитель пакетов из каталога libs
+#include "libs/airtime/airtime_pacer.h"         // паузы по времени кадра в эфире
+#include "libs/fragment_planner/fragment_planner.h" // размер фрагментов по времени в эфире
+#include "libs/lockfree/mpsc_queue.h"           // заявки на отправку из других задач
 #include "default_settings.h"                  // параметры по умолчанию
 
 // Модуль передачи данных с поддержкой классов QoS
@@ -17,12 +23,24 @@ class TxModule {
 public:
   // Конструктор принимает радио, размеры очередей по классам QoS и режим пакета
   TxModule(IRadio& radio, const std::array<size_t,4>& capacities, PayloadMode mode = PayloadMode::SMALL);
+  ~TxModule();
   // Смена режима размера полезной нагрузки
   void setPayloadMode(PayloadMode mode);
   // Добавляет сообщение в очередь на отправку с указанием класса QoS (0..3)
   uint16_t queue(const uint8_t* data, size_t len, uint8_t qos = 0);
+  // Изображение JPEG с неравной защитой: маркерные сегменты на скорости 1/2 с повтором, данные
+  // скана по границам интервалов рестарта на облегчённой скорости. Прочие данные — как queue()
+  uint16_t queueImage(const uint8_t* data, size_t len, uint8_t qos = 0);
   // Постановка сообщения без префикса и без дополнительного разбиения на части
   uint16_t queuePlain(const uint8_t* data, size_t len, uint8_t qos = 0);
+  // Способ постановки заявки submit(): как queue(), queuePlain() или queueImage()
+  enum class SubmitMode : uint8_t { QUEUE, PLAIN, IMAGE };
+  // Постановка из любой задачи (приём, веб, Serial) без блокировок: заявка копируется в
+  // очередь без ожидания и переносится в буфер класса в начале loop(). Возвращает уже
+  // выданный идентификатор или 0, если заявка отвергнута или очередь заявок заполнена
+  uint16_t submit(const uint8_t* data, size_t len, uint8_t qos = 0, SubmitMode mode = SubmitMode::QUEUE);
+  // Перенос накопленных заявок в очереди классов; вызывается из задачи, владеющей loop()
+  size_t drainSubmissions();
   // Отправляет первое доступное сообщение (если есть)
   // Возвращает true при успешной передаче
   bool loop();
@@ -30,6 +48,91 @@ public:
   void setSendPause(uint32_t pause_ms);
   // Получить текущую паузу между отправками (мс)
   uint32_t getSendPause() const;
+  // Паузы по фактическому времени в эфире (true) или фиксированная SEND_PAUSE (false)
+  void setAirtimePacing(bool enabled);
+  bool isAirtimePacingEnabled() const { return airtime_pacing_; }
+  // Приём идёт на отдельном радио: после кадра не нужен разворот TX→RX
+  void setFullDuplex(bool enabled);
+  bool isFullDuplex() const { return full_duplex_; }
+  // Допустимая доля занятого эфира (1..100 %)
+  void setDutyCycle(uint8_t percent);
+  uint8_t getDutyCycle() const { return pacer_.dutyCycle(); }
+  // Время в эфире последнего отправленного кадра (мкс, 0 — неизвестно)
+  uint32_t getLastAirtimeUs() const { return last_airtime_us_; }
+  // Бюджет эфира на окно и его остаток (мс)
+  uint32_t getAirtimeBudgetMs() const { return pacer_.budgetMs(); }
+  uint32_t getAirtimeBudgetLeftMs() const;
+  // Пауза, действующая после последнего кадра (мс)
+  uint32_t getEffectivePause() const { return currentPauseMs(); }
+  // Отправка нескольких фрагментов сообщения одной серией через IRadio::sendBurst()
+  void setBurstEnabled(bool enabled);
+  bool isBurstEnabled() const { return burst_enabled_; }
+  // Проверка канала (CAD) перед передачей; при занятом канале — случайная отсрочка
+  void setListenBeforeTalk(bool enabled);
+  bool isListenBeforeTalkEnabled() const { return lbt_enabled_; }
+  // Счётчики CAD: свободный канал, занятый канал, передачи без проверки после исчерпания попыток
+  uint32_t getLbtClearCount() const { return lbt_clear_count_; }
+  uint32_t getLbtBusyCount() const { return lbt_busy_count_; }
+  uint32_t getLbtForcedCount() const { return lbt_forced_count_; }
+  // Исходы ожидания ACK: подтверждённые сообщения и попытки, истёкшие по тайм-ауту
+  uint32_t getAckSuccessCount() const { return ack_success_count_; }
+  uint32_t getAckTimeoutCount() const { return ack_timeout_count_; }
+  // Профиль FEC вместо флагов конфигурации (адаптация канала); действует на ещё не
+  // подготовленные сообщения
+  void setFecOverride(const fec::Profile& profile) { fec_override_ = profile; }
+  void clearFecOverride() { fec_override_.reset(); }
+  // Проколотые скорости свёртки (convRate, HARQ 5/6, скан UEP); выключено, пока приёмная сторона
+  // не выполняет депрокалывание, и все фрагменты уходят на 1/2
+  void setPuncturingEnabled(bool enabled) { puncturing_enabled_ = enabled; }
+  bool isPuncturingEnabled() const { return puncturing_enabled_; }
+  // HARQ с нарастающей избыточностью: свёрнутые фрагменты уходят на скорости 5/6, а по NACK
+  // досылается только запрошенная версия избыточности
+  void setHarqEnabled(bool enabled) { harq_enabled_ = enabled; }
+  bool isHarqEnabled() const { return harq_enabled_; }
+  // NACK от приёмника: false — фрагмент уже не хранится или версия недопустима
+  bool onNackReceived(uint16_t msg_id, uint16_t frag_idx, uint8_t rv);
+  uint32_t getHarqRedundancyCount() const { return harq_redundancy_count_; }
+  // Внешний код стираний: к длинным сообщениям добавляется percent % восстановительных фрагментов
+  void setOuterFec(uint8_t percent) { outer_fec_percent_ = percent > 100 ? 100 : percent; }
+  uint8_t getOuterFec() const { return outer_fec_percent_; }
+  uint32_t getRepairFragmentCount() const { return repair_fragment_count_; }
+  // Агрегация: короткие «сырые» сообщения классов 0..AGGREGATE_MAX_QOS, накопившиеся за паузу,
+  // уходят одним кадром с записями по длине (protocol::aggregate)
+  void setAggregationEnabled(bool enabled) { aggregation_enabled_ = enabled; }
+  bool isAggregationEnabled() const { return aggregation_enabled_; }
+  uint32_t getAggregatedCount() const { return aggregated_count_; }
+  // Сообщения длиннее TX_PLAIN_MAX_LEN уходят фрагментами с FrameHeader; по умолчанию
+  // отвергаются, пока приёмная сторона не декодирует такие кадры
+  void setFramedLongEnabled(bool enabled) { framed_long_enabled_.store(enabled, std::memory_order_relaxed); }
+  bool isFramedLongEnabled() const { return framed_long_enabled_.load(std::memory_order_relaxed); }
+  // Сжатие «сырых» кадров (lzss) после агрегации; кадр, который не становится короче, уходит как есть
+  void setCompressionEnabled(bool enabled) { compression_enabled_ = enabled; }
+  bool isCompressionEnabled() const { return compression_enabled_; }
+  uint32_t getCompressedCount() const { return compressed_count_; }
+  uint32_t getCompressionSavedBytes() const { return compression_saved_bytes_; }
+  // Сжатые заголовки: полный заголовок на первом фрагменте и каждом DELTA_HEADER_REFRESH-м,
+  // остальные фрагменты несут дельту 3–4 байта (delta_header)
+  void setDeltaHeaders(bool enabled) { delta_headers_ = enabled; }
+  bool isDeltaHeadersEnabled() const { return delta_headers_; }
+  uint32_t getHeaderBytesSaved() const { return header_bytes_saved_; }
+  // Размер фрагментов по времени в эфире: части подбираются под текущий профиль FEC, тег,
+  // заголовок, пилоты и нарезку радио на пакеты вместо фиксированного максимума
+  void setAirtimePlanning(bool enabled) { airtime_planning_ = enabled; }
+  bool isAirtimePlanningEnabled() const { return airtime_planning_; }
+  // План фрагментов сообщения len байт под текущий профиль; count == 0 — сообщение не делится
+  fragment_planner::Plan planFragments(size_t len) const;
+  // Ожидаемое время передачи len байт (мкс): одним «сырым» кадром, как queue() отправляет
+  // сообщения до TX_PLAIN_MAX_LEN байт,
+  // или фрагментами (framed). 0 — радио не сообщает время в эфире
+  uint64_t predictAirtimeUs(size_t len, bool framed) const;
+  // Повторов защищённых частей JPEG, подготовленных queueImage()
+  uint32_t getUepCopyCount() const { return uep_copy_count_; }
+  // Занятые и предельные байты арен очередей всех классов QoS
+  size_t getQueueUsedBytes() const;
+  size_t getQueueBudgetBytes() const;
+  // Заявки submit(), отвергнутые сразу (переполнение, неверные данные) и потерянные при переносе
+  uint32_t getSubmitRejectedCount() const { return submit_rejected_.load(std::memory_order_relaxed); }
+  uint32_t getSubmitLostCount() const { return submit_lost_.load(std::memory_order_relaxed); }
   // Задать тайм-аут ожидания ACK (мс)
   void setAckTimeout(uint32_t timeout_ms);
   // Получить тайм-аут ожидания ACK (мс)
@@ -43,10 +146,18 @@ public:
   void setAckRetryLimit(uint8_t retries);
   void onAckReceived();
   void setEncryptionEnabled(bool enabled);
+  // Идёт ли асинхронная передача кадров очереди
+  bool isSending() const { return async_.active; }
+  // Дождаться окончания асинхронной передачи (используется перед прямой отправкой через Radio)
+  void waitForSendCompletion();
   // Ожидание глобальной паузы перед прямой отправкой через Radio (например, маяк или ping)
   void prepareExternalSend();
   // Фиксация момента завершения прямой отправки, чтобы пауза применялась ко всем модулям
   void completeExternalSend();
+  // Приостановка новых отправок, пока эфиром распоряжается другой модуль (сканер каналов).
+  // Уже запущенная серия доводится до конца, очередь копится и уходит после возобновления
+  void setSuspended(bool suspended) { suspended_ = suspended; }
+  bool isSuspended() const { return suspended_; }
   // Тестовый хук для подмены функции шифрования (используется только в unit-тестах)
   using EncryptOverride = bool (*)(const uint8_t* key, size_t key_len,
                                    const uint8_t* nonce, size_t nonce_len,
@@ -57,6 +168,7 @@ public:
   static void setEncryptOverrideForTests(EncryptOverride fn);
   static void resetEncryptOverrideForTests();
 private:
+  friend class TxModuleTestAccessor;              // доступ к внутреннему состоянию из unit-тестов
   struct PreparedFragment {
     std::vector<uint8_t> payload;               // кодированный фрагмент
     uint16_t payload_size = 0;                       // длина полезных данных фрагмента
@@ -68,6 +180,8 @@ private:
     uint16_t chunk_idx = 0;                          // индекс фрагмента внутри сообщения
     uint8_t header_flags = 0;                        // итоговые флаги кадра
     uint32_t packed_meta = 0;                        // упакованные метаданные
+    std::vector<uint8_t> coded_input;                // вход свёртки для версий избыточности HARQ
+    uint8_t frame_interleave = 0;                    // глубина межкадровой группы (0 — кадр не перемежён)
   };
 
   struct PendingMessage {
@@ -78,32 +192,126 @@ private:
     bool expect_ack = false;                 // требуется ли подтверждение
     bool is_ack = false;                     // флаг компактного ACK
     bool is_plain = false;                   // признак «сырых» пакетов без заголовка
+    bool jpeg_uep = false;                   // JPEG с неравной защитой частей
     std::string packet_tag;                  // идентификатор пакета для группировки частей
     std::string status_prefix;               // префикс для журнала статусов
     size_t next_fragment = 0;                // индекс следующего фрагмента к отправке
     std::chrono::steady_clock::time_point next_allowed_send{}; // момент, когда разрешена отправка
     bool completed = false;                  // признак завершённой передачи
     std::vector<PreparedFragment> fragments; // подготовленные фрагменты для повторов
+    uint16_t frag_cnt = 0;                   // исходных фрагментов в заголовке; 0 — все подготовленные
   };
 
-  bool transmit(PendingMessage& message);
+  // Где лежит сообщение, чья передача идёт асинхронно
+  enum class SendSource : uint8_t { INFLIGHT, DELAYED, ACK };
+  struct AsyncSend {
+    bool active = false;                               // радио вернуло ERR_PENDING
+    SendSource source = SendSource::DELAYED;           // владелец сообщения
+    std::chrono::steady_clock::time_point start{};     // момент запуска передачи
+    std::array<uint32_t, DefaultSettings::TX_BURST_MAX_FRAMES> airtime_us{}; // время кадров в эфире
+    size_t count = 0;                                  // кадров в серии
+    std::string prefix;                                // префикс статусов сообщения
+  };
+
+  bool transmit(PendingMessage& message, SendSource source);
+  bool startSend(PendingMessage& message, SendSource source, const std::string& prefix,
+                 const std::chrono::steady_clock::time_point& now,
+                 const IRadio::Frame* frames, size_t count);
+  bool finishSend(PendingMessage& message, const std::string& prefix,
+                  const std::chrono::steady_clock::time_point& start,
+                  const uint32_t* airtime_us, size_t count, int16_t state, size_t sent);
+  bool pollAsyncSend();
+  bool completeQueuedSend(PendingMessage& message, bool sent);
+  bool completeImmediateAck(bool sent);
   bool ensureFragmentsReady(PendingMessage& message);
   bool canSendFragment(PendingMessage& message, const std::chrono::steady_clock::time_point& now);
   static bool isAckPayload(const std::vector<uint8_t>& data);
-  static std::string extractPacketTag(const std::vector<uint8_t>& data);
+  static std::string extractPacketTag(const uint8_t* data, size_t len);
+  static std::string extractPacketTag(const std::vector<uint8_t>& data) { return extractPacketTag(data.data(), data.size()); }
   static std::string extractStatusPrefix(const std::vector<uint8_t>& data);
   void archiveFollowingParts(uint8_t qos, const std::string& tag);
   void scheduleFromArchive();
   void onSendSuccess();
   bool waitForPauseWindow();
   bool processImmediateAck();
+  uint32_t currentPauseMs() const;
+  void recordAirtime(const std::chrono::steady_clock::time_point& start, uint32_t airtime_us);
+  bool buildFrame(const PendingMessage& message, size_t index, std::vector<uint8_t>& frame);
+  bool fullHeaderAt(const PendingMessage& message, size_t index) const;
+  size_t headerLength(const PendingMessage& message, size_t index) const;
+  size_t burstLength(const PendingMessage& message, const std::chrono::steady_clock::time_point& now) const;
+  bool lbtActive() const;
+  bool lbtWaiting(const std::chrono::steady_clock::time_point& now) const;
+  bool listenBeforeTalk(const std::chrono::steady_clock::time_point& now);
+  uint32_t nextLbtBackoffMs();
+  bool hasHigherPriority(uint8_t qos) const;
+  bool aggregatePlain(PendingMessage& head);
+  bool compressPlain(PendingMessage& message);
+  fec::Profile activeProfile() const;
+  fragment_planner::Plan planFor(size_t len, const fec::Profile& profile, size_t max_chunk) const;
+  uint32_t frameOverheadUs() const;
+  // Идентификаторы MessageBuffer уникальны только внутри класса QoS
+  static uint32_t queueKey(uint8_t qos, uint16_t id) { return (static_cast<uint32_t>(qos) << 16) | id; }
+  // Заявка submit(): короткие данные лежат в самой ячейке, длинные — в отдельном блоке heap
+  struct Submission {
+    uint16_t id = 0;
+    uint16_t len = 0;
+    uint8_t qos = 0;
+    SubmitMode mode = SubmitMode::QUEUE;
+    uint8_t* heap = nullptr;
+    std::array<uint8_t, DefaultSettings::TX_SUBMIT_INLINE> bytes{};
+  };
+  bool acceptable(const uint8_t* data, size_t len, uint8_t& qos, SubmitMode& mode) const;
+  uint16_t enqueueAs(const uint8_t* data, size_t len, uint8_t qos, SubmitMode mode, uint16_t id);
+  bool preemptCurrent(std::optional<PendingMessage>& current);
+  void recycle(std::optional<PendingMessage>& slot);
 
   IRadio& radio_;
   std::array<MessageBuffer,4> buffers_;             // очереди сообщений по классам QoS
+  std::vector<uint8_t> spare_data_;                 // ёмкость данных последнего завершённого сообщения
+  lockfree::MpscQueue<Submission, DefaultSettings::TX_SUBMIT_QUEUE> submissions_; // заявки других задач
+  std::atomic<uint32_t> submit_rejected_{0};        // отвергнутые заявки
+  std::atomic<uint32_t> submit_lost_{0};            // заявки, не вставшие в очередь класса
   PacketSplitter splitter_;
   std::array<uint8_t,16> key_{};                    // ключ шифрования
   uint32_t pause_ms_ = DefaultSettings::SEND_PAUSE_MS; // пауза между пакетами
   std::chrono::steady_clock::time_point last_send_; // время последней отправки
+  bool airtime_pacing_ = DefaultSettings::USE_AIRTIME_PACING; // пауза по времени в эфире
+  AirtimePacer pacer_{DefaultSettings::RX_TURNAROUND_MS, DefaultSettings::DUTY_CYCLE_PERCENT,
+                      DefaultSettings::DUTY_CYCLE_WINDOW_MS}; // учёт эфира и duty cycle
+  uint32_t last_airtime_us_ = 0;                    // время в эфире последнего кадра
+  bool burst_enabled_ = DefaultSettings::USE_TX_BURST; // серии фрагментов без разворота в RX
+  bool lbt_enabled_ = DefaultSettings::USE_LBT;     // проверка канала перед передачей
+  bool full_duplex_ = false;                        // передача и приём на разных радио
+  bool suspended_ = false;                          // новые отправки временно запрещены
+  bool lbt_scanning_ = false;                       // CAD запущен и ждёт результата
+  uint8_t lbt_busy_streak_ = 0;                     // подряд занятых проверок канала
+  std::chrono::steady_clock::time_point lbt_backoff_until_{}; // конец текущей отсрочки
+  uint32_t lbt_clear_count_ = 0;                    // проверок со свободным каналом
+  uint32_t lbt_busy_count_ = 0;                     // проверок с занятым каналом
+  uint32_t lbt_forced_count_ = 0;                   // передач после исчерпания попыток CAD
+  uint32_t ack_success_count_ = 0;                  // сообщений, подтверждённых ACK
+  uint32_t ack_timeout_count_ = 0;                  // попыток без ACK за тайм-аут
+  std::optional<fec::Profile> fec_override_;        // профиль FEC от адаптации канала
+  bool harq_enabled_ = DefaultSettings::USE_HARQ;   // первая передача 5/6, избыточность по NACK
+  bool puncturing_enabled_ = DefaultSettings::USE_CONV_PUNCTURING; // проколотые скорости свёртки на передаче
+  std::deque<PendingMessage> harq_history_;         // недавние сообщения с входом кодера под NACK
+  uint32_t harq_redundancy_count_ = 0;              // отправленных версий избыточности
+  uint8_t outer_fec_percent_ = DefaultSettings::OUTER_FEC_PERCENT; // избыточность внешнего кода, %
+  uint32_t repair_fragment_count_ = 0;              // подготовлено восстановительных фрагментов
+  uint32_t uep_copy_count_ = 0;                     // повторов маркерных сегментов JPEG
+  bool aggregation_enabled_ = DefaultSettings::USE_AGGREGATION; // склейка коротких сообщений
+  std::atomic<bool> framed_long_enabled_{DefaultSettings::USE_FRAMED_LONG}; // длинные сообщения фрагментами
+  uint32_t aggregated_count_ = 0;                   // сообщений, ушедших в агрегированных кадрах
+  bool airtime_planning_ = DefaultSettings::USE_AIRTIME_PLANNER; // размер частей по времени в эфире
+  bool compression_enabled_ = DefaultSettings::USE_COMPRESSION; // сжатие «сырых» кадров
+  uint32_t compressed_count_ = 0;                   // кадров, ушедших сжатыми
+  uint32_t compression_saved_bytes_ = 0;            // байт, сэкономленных сжатием
+  std::vector<uint8_t> compress_buf_;               // рабочий буфер сжатого кадра
+  bool delta_headers_ = DefaultSettings::USE_DELTA_HEADER; // дельта-заголовки фрагментов
+  uint32_t header_bytes_saved_ = 0;                 // байт заголовков, сэкономленных дельтами
+  std::minstd_rand lbt_rng_;                        // генератор случайной отсрочки
+  AsyncSend async_;                                 // незавершённая асинхронная передача
   bool ack_enabled_ = false;                        // полностью отключаем ACK для прямого режима
   uint8_t ack_retry_limit_ = DefaultSettings::ACK_RETRY_LIMIT; // число повторов
   uint32_t ack_timeout_ms_ = DefaultSettings::ACK_TIMEOUT_MS;  // тайм-аут ожидания
@@ -113,10 +321,12 @@ private:
   std::optional<PendingMessage> inflight_;          // текущий пакет в работе
   std::optional<PendingMessage> delayed_;           // пакет из архива, готовый к отправке
   std::deque<PendingMessage> archive_;              // архив сообщений без ACK
+  std::array<std::optional<PendingMessage>,4> parked_; // частично отправленные сообщения по классам QoS
   std::deque<PendingMessage> ack_queue_;            // очередь мгновенных ACK-сообщений
   uint16_t next_ack_id_ = 0x8000;                   // идентификаторы ACK вне общей очереди
   std::chrono::steady_clock::time_point next_ack_send_time_; // момент, когда ACK можно отправить
   bool encryption_enabled_ = false;                 // шифрование временно отключено
-  std::unordered_set<uint16_t> plain_messages_;     // учёт идентификаторов «сырых» пакетов
+  std::unordered_set<uint32_t> plain_messages_;     // «сырые» пакеты по queueKey(qos, id)
+  std::unordered_set<uint32_t> uep_messages_;       // JPEG, ожидающие нарезки по маркерам
 };
 
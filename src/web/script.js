@@ -2770,6 +2770,15 @@ async function sendTextMessage(text, opts) {
   return null;
 }
 
+// Разбор ответа ETA: время в эфире (мс) по ключу raw_ms или framed_ms
+function parseAirtimeEstimate(text, key) {
+  if (!text) return null;
+  const match = String(text).match(new RegExp(key + "=(\\d+)"));
+  if (!match) return null;
+  const value = Number(match[1]);
+  return Number.isFinite(value) && value > 0 ? value : null;
+}
+
 async function sendImageMessage(prepared, context) {
   const ctx = context || {};
   const meta = ctx.meta ? ctx.meta : null;
@@ -2778,6 +2787,9 @@ async function sendImageMessage(prepared, context) {
     note("Не удалось отправить изображение");
     return null;
   }
+  const eta = await sendCommand("ETA", { v: String(prepared.blob.size) }, { silent: true, timeoutMs: 2000, debugLabel: "ETA IMG" });
+  const etaMs = parseAirtimeEstimate(eta, "framed_ms");
+  if (etaMs != null) note("Изображение: оценка эфира ≈ " + (etaMs / 1000).toFixed(1) + " с");
   status("→ IMG");
   const res = await postImage(prepared.blob, meta, 9000);
   const entries = getChatHistory();
@@ -7164,6 +7176,16 @@ function applySearchResult(text) {
     renderChannels();
     persistChannelsToStorage(channels);
   }
+  // Устройство обходит каналы в фоне и сразу отдаёт кэш — перечитываем таблицу до окончания обхода
+  if (/^SEAR:\s*scanning/im.test(text)) scheduleSearchRefresh();
+}
+let searchRefreshTimer = null;
+function scheduleSearchRefresh() {
+  if (searchRefreshTimer) return;
+  searchRefreshTimer = setTimeout(() => {
+    searchRefreshTimer = null;
+    sendCommand("SEAR", {}, { silent: true, debugLabel: "SEAR (обновление)" });
+  }, 2000);
 }
 function exportChannelsCsv() {
   const lines = [["ch","tx","rx","rssi","snr","status","scan_state","scan"]];
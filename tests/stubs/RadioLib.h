@@ -9,6 +9,7 @@
 
 // Константы статусов и флагов IRQ, используемые в прошивке
 #define RADIOLIB_ERR_NONE 0
+#define RADIOLIB_ERR_TX_TIMEOUT -5
 #define RADIOLIB_ERR_CHANNEL_BUSY -16
 #define RADIOLIB_ERR_CHANNEL_BUSY_LBT -17
 #define RADIOLIB_SX126X_IRQ_NONE 0x0000U
@@ -48,6 +49,15 @@ public:
     ++setFrequencyCalls;              // считаем вызовы смены частоты
     return setFrequencyState;
   }
+  // Неблокирующая передача: заглушка сразу выставляет TX_DONE, как после завершения кадра
+  int16_t startTransmit(uint8_t* data, size_t len) {
+    ++startTransmitCalls;
+    const int16_t state = transmit(data, len);
+    if (state == RADIOLIB_ERR_NONE) {
+      testIrqFlags |= RADIOLIB_SX126X_IRQ_TX_DONE;
+    }
+    return state;
+  }
   int16_t transmit(uint8_t* data, size_t len) {
     lastTransmitLength = len;         // сохраняем длину последней передачи
     ++transmitCalls;                  // считаем количество передач
@@ -76,6 +86,14 @@ public:
     ++startReceiveCalls;              // учитываем попытки запуска приёма
     return startReceiveState;
   }
+  int16_t standby() {
+    ++standbyCalls;                   // учитываем переходы в standby
+    return RADIOLIB_ERR_NONE;
+  }
+  int16_t startChannelScan() {
+    ++startChannelScanCalls;          // учитываем запуски CAD
+    return startChannelScanState;
+  }
   int16_t setDio2AsRfSwitch(bool) { return setDio2AsRfSwitchState; }
   int16_t setDioIrqParams(uint16_t, uint16_t, uint16_t = RADIOLIB_SX126X_IRQ_NONE,
                           uint16_t = RADIOLIB_SX126X_IRQ_NONE) {
@@ -127,7 +145,11 @@ public:
   float previousSetFrequency = 0.0f;   // частота из предыдущего вызова setFrequency()
   size_t setFrequencyCalls = 0;        // количество вызовов setFrequency()
   size_t startReceiveCalls = 0;        // количество вызовов startReceive()
+  size_t standbyCalls = 0;             // количество вызовов standby()
   size_t transmitCalls = 0;            // количество вызовов transmit()
+  size_t startTransmitCalls = 0;       // количество вызовов startTransmit()
+  size_t startChannelScanCalls = 0;    // количество вызовов startChannelScan()
+  int16_t startChannelScanState = RADIOLIB_ERR_NONE; // код возврата startChannelScan()
   size_t lastTransmitLength = 0;       // длина последней переданной полезной нагрузки
   int16_t transmitResult = RADIOLIB_ERR_NONE; // код возврата transmit()
   std::vector<size_t> transmitLengthHistory;           // история длин переданных пакетов
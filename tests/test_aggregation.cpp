@@ -0,0 +1,121 @@
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "libs/protocol/aggregate_utils.h"
+#include "tx_module.h"
+#include "rx_module.h"
+
+// Радиоинтерфейс, запоминающий отправленные кадры
+class RecordingRadio : public IRadio {
+public:
+  std::vector<std::vector<uint8_t>> sent;
+  int16_t send(const uint8_t* data, size_t len) override {
+    sent.emplace_back(data, data + len);
+    return ERR_NONE;
+  }
+  void setReceiveCallback(RxCallback) override {}
+};
+
+static std::vector<uint8_t> bytes(const std::string& s) {
+  return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+// Формат кадра: записи по длине, обычные данные с маркером в начале не разбираются
+static void testFrameFormat() {
+  std::vector<uint8_t> frame;
+  protocol::aggregate::begin(frame);
+  const auto a = bytes("hi");
+  const auto b = bytes("there");
+  assert(protocol::aggregate::append(frame, a.data(), a.size()));
+  assert(!protocol::aggregate::isAggregate(frame.data(), frame.size())); // одна запись — не агрегат
+  assert(protocol::aggregate::append(frame, b.data(), b.size()));
+  assert(frame.size() == protocol::aggregate::HEADER_SIZE + 1 + a.size() + 1 + b.size());
+  std::vector<std::vector<uint8_t>> records;
+  assert(protocol::aggregate::forEach(frame.data(), frame.size(), [&](const uint8_t* d, size_t l) {
+    records.emplace_back(d, d + l);
+  }));
+  assert(records.size() == 2 && records[0] == a && records[1] == b);
+
+  std::vector<uint8_t> tail(frame);
+  tail.push_back(0x00);                                // лишний байт
+  assert(!protocol::aggregate::isAggregate(tail.data(), tail.size()));
+  assert(!protocol::aggregate::isAggregate(frame.data(), frame.size() - 1));
+  const std::vector<uint8_t> text = {protocol::aggregate::MARKER, 'a', 'b', 'c'};
+  assert(!protocol::aggregate::isAggregate(text.data(), text.size()));
+  std::vector<uint8_t> big(protocol::aggregate::MAX_RECORD + 1, 0x41);
+  assert(!protocol::aggregate::append(frame, big.data(), big.size()));
+}
+
+// Накопившиеся короткие сообщения интерактивных классов уходят одним кадром
+static void testTxAggregation() {
+  RecordingRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{8, 8, 8, 8});
+  tx.setSendPause(0);
+  tx.setAirtimePacing(false);
+  tx.setAggregationEnabled(true);
+  const auto m1 = bytes("first");
+  const auto m2 = bytes("second");
+  const std::vector<uint8_t> ack = {0x06};
+  const std::vector<uint8_t> longMsg(DefaultSettings::AGGREGATE_MAX_RECORD + 1, 'L');
+  const auto bulk = bytes("bulk");
+  assert(tx.queue(m1.data(), m1.size(), 0));
+  assert(tx.queue(ack.data(), ack.size(), 0));
+  assert(tx.queue(m2.data(), m2.size(), 1));
+  assert(tx.queue(longMsg.data(), longMsg.size(), 1));
+  assert(tx.queue(bulk.data(), bulk.size(), 2));
+  for (int i = 0; i < 10; ++i) tx.loop();
+
+  assert(radio.sent.size() == 3);
+  std::vector<std::vector<uint8_t>> records;
+  assert(protocol::aggregate::forEach(radio.sent[0].data(), radio.sent[0].size(), [&](const uint8_t* d, size_t l) {
+    records.emplace_back(d, d + l);
+  }));
+  assert(records.size() == 3);
+  assert(records[0] == m1 && records[1] == ack && records[2] == m2);
+  assert(radio.sent[1] == longMsg);                    // длинное сообщение — отдельным кадром
+  assert(radio.sent[2] == bulk);                       // объёмный класс не агрегируется
+  assert(tx.getAggregatedCount() == 3);
+
+  // Без агрегации каждое сообщение — свой кадр
+  RecordingRadio plainRadio;
+  TxModule plain(plainRadio, std::array<size_t,4>{8, 8, 8, 8});
+  plain.setSendPause(0);
+  plain.setAirtimePacing(false);
+  plain.queue(m1.data(), m1.size(), 0);
+  plain.queue(m2.data(), m2.size(), 0);
+  for (int i = 0; i < 10; ++i) plain.loop();
+  assert(plainRadio.sent.size() == 2);
+}
+
+// RxModule разбирает агрегат на отдельные кадры
+static void testRxUnpack() {
+  RxModule rx;
+  std::vector<std::vector<uint8_t>> delivered;
+  rx.setCallback([&](const uint8_t* d, size_t l) { delivered.emplace_back(d, d + l); });
+  std::vector<uint8_t> frame;
+  protocol::aggregate::begin(frame);
+  const auto a = bytes("alpha");
+  const auto b = bytes("beta");
+  protocol::aggregate::append(frame, a.data(), a.size());
+  protocol::aggregate::append(frame, b.data(), b.size());
+  rx.onReceive(frame.data(), frame.size());
+  assert(delivered.size() == 2 && delivered[0] == a && delivered[1] == b);
+  assert(rx.aggregateFrameCount() == 1 && rx.aggregateRecordCount() == 2);
+
+  const std::vector<uint8_t> text = {protocol::aggregate::MARKER, 'x', 'y'};
+  rx.onReceive(text.data(), text.size());              // не агрегат — доставляется как есть
+  assert(delivered.size() == 3 && delivered[2] == text);
+  assert(rx.aggregateFrameCount() == 1);
+}
+
+int main() {
+  testFrameFormat();
+  testTxAggregation();
+  testRxUnpack();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
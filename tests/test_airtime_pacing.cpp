@@ -0,0 +1,193 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "tx_module.h"
+#include "libs/airtime/lora_airtime.h"
+#include "libs/airtime/airtime_pacer.h"
+
+// Заглушка радио с фиксированной оценкой времени в эфире
+class AirtimeRadio : public IRadio {
+public:
+  uint32_t airtime = 0;
+  std::vector<std::vector<uint8_t>> history;
+  int16_t send(const uint8_t* data, size_t len) override {
+    history.emplace_back(data, data + len);
+    return ERR_NONE;
+  }
+  void setReceiveCallback(RxCallback) override {}
+  uint32_t airtimeUs(size_t) const override { return airtime; }
+  std::vector<size_t> bursts;                            // размеры серий sendBurst()
+  int16_t sendBurst(const Frame* frames, size_t count, size_t& sent) override {
+    if (count > 1) bursts.push_back(count);
+    return IRadio::sendBurst(frames, count, sent);
+  }
+};
+
+// Перевод сообщения в кодированный режим с фрагментами
+class TxModuleTestAccessor {
+public:
+  static void makeCoded(TxModule& tx, uint8_t qos, uint16_t id) {
+    tx.plain_messages_.erase(TxModule::queueKey(qos, id));
+  }
+};
+
+static void testTimeOnAir() {
+  // Эталон калькулятора Semtech: SF7, 125 кГц, CR 4/5, преамбула 8, явный заголовок, CRC, 10 байт
+  lora_airtime::ModemParams p;
+  assert(lora_airtime::timeOnAirUs(p, 10) == 41216);
+
+  // SF12 на 125 кГц требует LDRO: символ 32,768 мс
+  assert(lora_airtime::autoLowDataRateOptimize(125.0f, 12));
+  assert(!lora_airtime::autoLowDataRateOptimize(125.0f, 7));
+  p.spreadingFactor = 12;
+  p.lowDataRateOptimize = true;
+  assert(lora_airtime::timeOnAirUs(p, 10) == 991232);
+
+  // Implicit header без CRC короче явного кадра той же длины
+  lora_airtime::ModemParams fast;
+  fast.bandwidthKhz = 15.63f;
+  fast.preambleLength = 24;
+  fast.crc = false;
+  uint32_t explicitUs = lora_airtime::timeOnAirUs(fast, 32);
+  fast.implicitHeader = true;
+  uint32_t implicitUs = lora_airtime::timeOnAirUs(fast, 32);
+  assert(implicitUs < explicitUs);
+  assert(lora_airtime::symbolTimeUs(15.63f, 7) == 8189);
+
+  // Некорректные параметры дают 0
+  fast.spreadingFactor = 4;
+  assert(lora_airtime::timeOnAirUs(fast, 32) == 0);
+}
+
+static void testHeaderChoice() {
+  lora_airtime::ModemParams p;
+  p.bandwidthKhz = 15.63f;
+  p.preambleLength = 24;
+  p.crc = false;
+  const uint16_t table[] = {16, 32, 64, 128, 245};
+
+  // Нарезка кадра: 245 байт в implicit-режиме по 32 — восемь пакетов с преамбулой каждый
+  p.implicitHeader = true;
+  assert(lora_airtime::frameTimeOnAirUs(p, 245, 32, 245) == 8 * lora_airtime::timeOnAirUs(p, 32));
+  p.implicitHeader = false;
+  assert(lora_airtime::frameTimeOnAirUs(p, 245, 32, 245) == lora_airtime::timeOnAirUs(p, 245));
+  assert(lora_airtime::frameTimeOnAirUs(p, 300, 0, 245) ==
+         lora_airtime::timeOnAirUs(p, 245) + lora_airtime::timeOnAirUs(p, 55));
+
+  // Кадры разной длины — выгоднее явный заголовок
+  const uint16_t mixed[] = {16, 48, 96, 160, 245};
+  lora_airtime::HeaderChoice choice = lora_airtime::chooseHeaderMode(p, mixed, 5, table, 5, 245);
+  assert(!choice.implicitHeader);
+  assert(choice.airtimeUs > 0);
+
+  // Кадры фиксированной длины — implicit с этой длиной экономит заголовок
+  const uint16_t fixed[] = {32, 32};
+  choice = lora_airtime::chooseHeaderMode(p, fixed, 2, table, 5, 245);
+  assert(choice.implicitHeader);
+  assert(choice.implicitLength == 32);
+  lora_airtime::ModemParams implicitParams = p;
+  implicitParams.implicitHeader = true;
+  assert(choice.airtimeUs == 2ULL * lora_airtime::timeOnAirUs(implicitParams, 32));
+
+  // Без таблицы implicit-длин остаётся explicit
+  choice = lora_airtime::chooseHeaderMode(p, fixed, 2, nullptr, 0, 245);
+  assert(!choice.implicitHeader);
+}
+
+static void testPacer() {
+  using Clock = AirtimePacer::Clock;
+  AirtimePacer pacer(30, 100, 1000);
+  auto t0 = Clock::now();
+  pacer.onTransmit(t0, 5000);
+  assert(pacer.gapAfterLastMs() == 35);                 // 5 мс эфира + 30 мс разворота
+  assert(pacer.remainingBudgetMs(t0) == 995);
+
+  // При 10 % duty cycle пауза покрывает девятикратное время в эфире
+  pacer.setDutyCycle(10);
+  pacer.onTransmit(t0, 20000);
+  assert(pacer.gapAfterLastMs() == 200);
+  assert(pacer.budgetMs() == 100);
+  assert(pacer.remainingBudgetMs(t0) == 75);
+  // По истечении окна бюджет восстанавливается
+  assert(pacer.remainingBudgetMs(t0 + std::chrono::milliseconds(1500)) == 100);
+}
+
+static void testTxModulePacing() {
+  AirtimeRadio radio;
+  radio.airtime = 2000;                                  // короткий кадр: 2 мс
+  TxModule tx(radio, std::array<size_t,4>{4, 4, 4, 4});
+  tx.setSendPause(370);
+  tx.setAirtimePacing(true);
+  const uint8_t a[] = {1, 2, 3};
+  const uint8_t b[] = {4, 5, 6};
+  assert(tx.queue(a, sizeof(a)) != 0);
+  assert(tx.queue(b, sizeof(b)) != 0);
+  assert(tx.loop());
+  assert(tx.getLastAirtimeUs() == 2000);
+  assert(tx.getEffectivePause() == DefaultSettings::RX_TURNAROUND_MS + 2);
+  assert(!tx.loop());                                    // разворот ещё не истёк
+  std::this_thread::sleep_for(std::chrono::milliseconds(DefaultSettings::RX_TURNAROUND_MS + 10));
+  assert(tx.loop());                                     // без ожидания полной SEND_PAUSE
+  assert(radio.history.size() == 2);
+
+  // Фиксированный режим возвращает прежнюю паузу
+  tx.setAirtimePacing(false);
+  assert(tx.getEffectivePause() == 370);
+  assert(tx.queue(a, sizeof(a)) != 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(DefaultSettings::RX_TURNAROUND_MS + 10));
+  assert(!tx.loop());
+}
+
+static void testTxModuleBurst() {
+  AirtimeRadio radio;
+  radio.airtime = 2000;
+  TxModule tx(radio, std::array<size_t,4>{4, 4, 4, 4});
+  tx.setAirtimePacing(true);
+  std::vector<uint8_t> bulk(200, 0x5A);
+
+  // Все фрагменты сообщения уходят одной серией
+  uint16_t id = tx.queue(bulk.data(), bulk.size(), 2);
+  TxModuleTestAccessor::makeCoded(tx, 2, id);
+  assert(tx.loop());
+  assert(radio.bursts.size() == 1);
+  const size_t frames = radio.bursts[0];
+  assert(frames >= 3);
+  assert(radio.history.size() == frames);
+  assert(tx.getLastAirtimeUs() == frames * 2000);        // пауза считается от всей серии
+  assert(!tx.loop());
+
+  // Чат класса 0 уходит первым, объёмное сообщение — следующей серией
+  std::this_thread::sleep_for(std::chrono::milliseconds(tx.getEffectivePause() + 10));
+  id = tx.queue(bulk.data(), bulk.size(), 2);
+  TxModuleTestAccessor::makeCoded(tx, 2, id);
+  const uint8_t chat[] = {'h', 'i'};
+  assert(tx.queue(chat, sizeof(chat), 0) != 0);
+  assert(tx.loop());
+  assert(radio.bursts.size() == 1);
+  assert(radio.history.back() == std::vector<uint8_t>(chat, chat + sizeof(chat)));
+  std::this_thread::sleep_for(std::chrono::milliseconds(tx.getEffectivePause() + 10));
+  assert(tx.loop());
+  assert(radio.bursts.size() == 2);
+
+  // Фиксированная пауза исключает серии
+  tx.setAirtimePacing(false);
+  tx.setSendPause(0);
+  id = tx.queue(bulk.data(), bulk.size(), 2);
+  TxModuleTestAccessor::makeCoded(tx, 2, id);
+  assert(tx.loop());
+  assert(radio.bursts.size() == 2);
+}
+
+int main() {
+  testTimeOnAir();
+  testHeaderChoice();
+  testPacer();
+  testTxModulePacing();
+  testTxModuleBurst();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
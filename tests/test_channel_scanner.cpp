@@ -0,0 +1,181 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "channel_scanner.h"
+#include "radio_sx1262.h"
+#include "tx_module.h"
+#include "stubs/Arduino.h"
+
+// Доступ к внутреннему SX1262 и обработчику DIO1
+class RadioSX1262TestAccessor {
+public:
+  static RadioSX1262::PublicSX1262& rawRadio(RadioSX1262& radio) { return radio.radio_; }
+  static void dio1(RadioSX1262& radio) { radio.handleDio1(); }
+};
+
+// Флаги IRQ читаются не в handleDio1(), а при следующем опросе радио (scanner.loop()),
+// поэтому выставленные тестом флаги снимаются только после этого опроса
+static uint32_t raiseIrq(RadioSX1262& radio, uint32_t flags) {
+  RadioSX1262TestAccessor::rawRadio(radio).testIrqFlags |= flags;
+  RadioSX1262TestAccessor::dio1(radio);
+  return flags;
+}
+
+static void consumeIrq(RadioSX1262& radio, uint32_t& flags) {
+  RadioSX1262TestAccessor::rawRadio(radio).testIrqFlags &= ~flags;
+  flags = 0;
+}
+
+struct ScanStats {
+  size_t cads = 0;
+  size_t pings = 0;
+};
+
+// Прогон обхода: на каждой вылазке отвечаем CAD и пингу как эфир с заданными каналами
+static ScanStats drive(ChannelScanner& scanner, RadioSX1262& radio, TxModule& tx,
+                       size_t home, size_t busyCh, size_t aliveCh, size_t strangerCh) {
+  auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
+  ScanStats stats;
+  uint32_t injected = 0;
+  while (scanner.isRunning()) {
+    const size_t ch = scanner.progress();
+    const size_t cadBefore = raw.startChannelScanCalls;
+    const size_t txBefore = raw.transmitCalls;
+    scanner.loop();
+    consumeIrq(radio, injected);
+    if (raw.transmitCalls != txBefore) {               // ушёл пинг — отвечаем эхом или молчим
+      ++stats.pings;
+      assert(radio.isPinging());
+      assert(tx.isSuspended());
+      assert(radio.getChannel() == ch);
+      if (ch == aliveCh || ch == strangerCh) {
+        std::vector<uint8_t> echo = raw.transmitPayloadHistory.back();
+        if (ch == strangerCh) echo[0] ^= 0xFF;
+        std::copy(echo.begin(), echo.end(), raw.testReadBuffer.begin());
+        raw.testReadBufferSize = echo.size();
+        raw.testPacketLength = echo.size();
+        injected = raiseIrq(radio, RADIOLIB_SX126X_IRQ_RX_DONE);
+        ArduinoStub::gMicros += 1500;
+      } else {
+        ArduinoStub::gMicros += DefaultSettings::PING_WAIT_MS * 1000UL + 1;
+      }
+    } else if (raw.startChannelScanCalls != cadBefore) { // вылазка началась с CAD
+      ++stats.cads;
+      assert(tx.isSuspended());
+      assert(radio.getChannel() == ch);
+      injected = raiseIrq(radio, RADIOLIB_SX126X_IRQ_CAD_DONE |
+                                     (ch == busyCh ? RADIOLIB_SX126X_IRQ_CAD_DETECTED : 0U));
+    } else if (!scanner.isRunning() || scanner.progress() != ch) {
+      assert(!tx.isSuspended());                       // между вылазками очередь не задерживается
+      assert(radio.getChannel() == home);
+    }
+  }
+  return stats;
+}
+
+static void testScanAndCache() {
+  RadioSX1262 radio;
+  auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
+  assert(radio.begin());
+  assert(radio.setChannel(3));
+  ArduinoStub::gMillis = 1000;
+  raw.testRssi = -71.5f;
+  raw.testSnr = 6.25f;
+  TxModule tx(radio, std::array<size_t,4>{4, 4, 4, 4});
+  tx.setSendPause(0);
+  tx.setListenBeforeTalk(false);
+  ChannelScanner scanner(radio, tx);
+  scanner.setRefreshInterval(0);
+  const size_t count = radio.getBankSize();
+  assert(count >= 6);
+
+  // Первый обход: пингуется каждый канал, рабочий канал восстанавливается
+  assert(!scanner.hasResults());
+  assert(scanner.start());
+  assert(!scanner.start());                            // повторный запуск во время обхода игнорируется
+  ScanStats first = drive(scanner, radio, tx, 3, 1, 2, 5);
+  assert(first.cads == count);
+  assert(first.pings == count);
+  assert(scanner.hasResults());
+  assert(radio.getChannel() == 3);
+  assert(!tx.isSuspended());
+  const auto& alive = scanner.entry(2);
+  assert(alive.status == ChannelScanner::Status::ALIVE);
+  assert(alive.rssi == -71.5f && alive.snr == 6.25f);
+  assert(alive.rttUs == 1500);
+  assert(alive.lastSeenMs == 1000);
+  assert(scanner.entry(5).status == ChannelScanner::Status::ERROR);
+  assert(scanner.entry(1).status == ChannelScanner::Status::NO_RESPONSE);
+  assert(scanner.entry(1).cadActivity);
+  assert(scanner.entry(0).status == ChannelScanner::Status::NO_RESPONSE);
+
+  // Повторный обход: молчащие каналы без активности по CAD не пингуются
+  ArduinoStub::gMillis = 5000;
+  assert(scanner.resultAgeMs() == 4000);
+  assert(scanner.start());
+  ScanStats second = drive(scanner, radio, tx, 3, 1, 2, 5);
+  assert(second.cads == count);
+  assert(second.pings == 3);                           // отвечавший, сбойный и канал с активностью
+  assert(scanner.entry(0).skipped);
+  assert(!scanner.entry(2).skipped);
+  assert(scanner.entry(2).lastSeenMs == 5000);
+
+  // Через SEAR_DEAD_RECHECK_MS молчащие каналы снова проверяются
+  ArduinoStub::gMillis += DefaultSettings::SEAR_DEAD_RECHECK_MS;
+  assert(scanner.start());
+  ScanStats third = drive(scanner, radio, tx, 3, 1, 2, 5);
+  assert(third.pings == count);
+
+  // Фоновое обновление по таймеру после первого обхода
+  scanner.setRefreshInterval(1000);
+  scanner.loop();
+  assert(!scanner.isRunning());
+  ArduinoStub::gMillis += 1000;
+  scanner.loop();
+  assert(scanner.isRunning());
+  drive(scanner, radio, tx, 3, 1, 2, 5);
+}
+
+// Пока радио на чужом канале, TxModule не отправляет; очередь уходит после вылазки
+static void testTxHeldDuringExcursion() {
+  RadioSX1262 radio;
+  auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
+  assert(radio.begin());
+  ArduinoStub::gMillis = 1000;
+  TxModule tx(radio, std::array<size_t,4>{4, 4, 4, 4});
+  tx.setSendPause(0);
+  tx.setListenBeforeTalk(false);
+  ChannelScanner scanner(radio, tx);
+  assert(radio.setChannel(0));
+  assert(scanner.start());
+  scanner.loop();                                      // канал 0: CAD
+  uint32_t injected = raiseIrq(radio, RADIOLIB_SX126X_IRQ_CAD_DONE);
+  scanner.loop();                                      // CAD свободен, пинг отправлен
+  consumeIrq(radio, injected);
+  assert(radio.isPinging());
+
+  const uint8_t msg[] = {'S', 'C', 'A', 'N'};
+  assert(tx.queue(msg, sizeof(msg)) != 0);
+  const size_t startTx = raw.startTransmitCalls;
+  assert(!tx.loop());
+  assert(raw.startTransmitCalls == startTx);
+  size_t sent = 0;
+  const IRadio::Frame frame{msg, sizeof(msg)};
+  assert(radio.startSendBurst(&frame, 1, sent) == IRadio::ERR_TIMEOUT); // пинг ждёт эха
+
+  ArduinoStub::gMicros += DefaultSettings::PING_WAIT_MS * 1000UL + 1;
+  scanner.loop();                                      // тайм-аут пинга, вылазка окончена
+  assert(!radio.isPinging());
+  assert(!tx.isSuspended());
+  tx.loop();
+  assert(raw.startTransmitCalls > startTx);
+}
+
+int main() {
+  testScanAndCache();
+  testTxHeldDuringExcursion();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "libs/chase/chase_combiner.h"
+#include "libs/conv_codec/conv_codec.h"
+#include "libs/bit_interleaver/bit_interleaver.h"
+
+static std::vector<uint8_t> makeInput(size_t len) {
+  std::vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; ++i) data[i] = static_cast<uint8_t>(i * 29 + 3);
+  data.push_back(0x00);                                // хвост кодера
+  return data;
+}
+
+// Копия кадра с плотной пачкой ошибок в заданной части
+static std::vector<uint8_t> corrupt(const std::vector<uint8_t>& frame, size_t from, size_t to) {
+  std::vector<uint8_t> copy(frame);
+  for (size_t i = from; i < to && i < copy.size(); ++i) copy[i] ^= 0x5A;
+  return copy;
+}
+
+// Копия кадра с рассеянными ошибками: около 10 % бит, позиции задаёт seed
+static std::vector<uint8_t> scatter(const std::vector<uint8_t>& frame, uint32_t seed) {
+  std::vector<uint8_t> copy(frame);
+  uint32_t state = seed * 2654435761U;
+  for (size_t i = 0; i < copy.size() * 8; ++i) {
+    state = state * 1664525U + 1013904223U;
+    if ((state >> 24) < 26) copy[i >> 3] ^= static_cast<uint8_t>(1U << (7 - (i & 7)));
+  }
+  return copy;
+}
+
+// Три копии с ошибками в разных местах: мажоритарное сложение восстанавливает кадр без стираний
+static void testMajority() {
+  const std::vector<uint8_t> frame = makeInput(60);
+  chase::Cache cache(4, 128);
+  const uint64_t key = 0x1000;
+  assert(cache.add(key, corrupt(frame, 0, 20).data(), frame.size()) == 1);
+  assert(cache.add(key, corrupt(frame, 20, 40).data(), frame.size()) == 2);
+  assert(cache.add(key, corrupt(frame, 40, 61).data(), frame.size()) == 3);
+  assert(cache.copies(key) == 3);
+  std::vector<uint8_t> out;
+  std::vector<uint8_t> erased;
+  assert(cache.combine(key, out, erased));
+  assert(out == frame);
+  for (uint8_t b : erased) assert(b == 0);
+}
+
+// Две копии с рассеянными ошибками: одна не декодируется, сумма со стираниями на спорных битах — декодируется
+static void testTwoCopiesWithErasures() {
+  const std::vector<uint8_t> data = makeInput(100);
+  std::vector<uint8_t> frame;
+  conv_codec::encodeBits(data.data(), data.size(), frame, conv_codec::Rate::R1_2);
+  bit_interleaver::interleave(frame.data(), frame.size());
+
+  const std::vector<uint8_t> first = scatter(frame, 1);
+  const std::vector<uint8_t> second = scatter(frame, 2);
+  std::vector<uint8_t> single(first);
+  bit_interleaver::deinterleave(single.data(), single.size());
+  std::vector<uint8_t> dec;
+  assert(conv_codec::viterbiDecode(single.data(), single.size(), dec));
+  assert(dec != data);                                 // одиночная копия повреждена безнадёжно
+
+  chase::Cache cache;
+  const uint64_t key = 0x2000;
+  assert(cache.add(key, first.data(), first.size()) == 1);
+  assert(cache.add(key, second.data(), second.size()) == 2);
+  std::vector<uint8_t> combined;
+  std::vector<uint8_t> erased;
+  assert(cache.combine(key, combined, erased));
+  bit_interleaver::deinterleave(combined.data(), combined.size());
+  bit_interleaver::deinterleave(erased.data(), erased.size());
+  assert(conv_codec::viterbiDecodeErasures(combined.data(), erased.data(), combined.size(), dec));
+  assert(dec == data);
+
+  cache.release(key);
+  assert(cache.copies(key) == 0);
+  assert(cache.size() == 0);
+}
+
+// Стирания работают и на проколотой скорости
+static void testPuncturedErasures() {
+  const std::vector<uint8_t> data = makeInput(80);
+  std::vector<uint8_t> frame;
+  conv_codec::encodeBits(data.data(), data.size(), frame, conv_codec::Rate::R3_4);
+  std::vector<uint8_t> erased(frame.size(), 0);
+  std::vector<uint8_t> noisy(frame);
+  for (size_t bit = 5; bit < noisy.size() * 8; bit += 11) {
+    const uint8_t mask = static_cast<uint8_t>(1U << (7 - (bit & 7)));
+    noisy[bit >> 3] ^= mask;
+    erased[bit >> 3] |= mask;                          // испорченные биты помечены стёртыми
+  }
+  std::vector<uint8_t> dec;
+  assert(conv_codec::viterbiDecodeErasures(noisy.data(), erased.data(), noisy.size(), dec,
+                                           conv_codec::Rate::R3_4));
+  assert(dec == data);
+}
+
+// Ограничения кэша: вытеснение давнего слота, смена длины, мягкие решения
+static void testBounds() {
+  chase::Cache cache(2, 16);
+  const uint8_t a[4] = {0xF0, 0x0F, 0xAA, 0x55};
+  const uint8_t big[17] = {};
+  assert(cache.add(1, big, sizeof(big)) == 0);        // длиннее допустимого
+  assert(cache.add(1, a, sizeof(a)) == 1);
+  assert(cache.add(2, a, sizeof(a)) == 1);
+  assert(cache.add(1, a, sizeof(a)) == 2);             // слот 1 обновлён позже слота 2
+  assert(cache.add(3, a, sizeof(a)) == 1);
+  assert(cache.size() == 2);
+  assert(cache.copies(2) == 0);                        // вытеснен самый давний
+  assert(cache.copies(1) == 2);
+  assert(cache.add(1, a, 2) == 1);                     // другая длина — накопление заново
+
+  int8_t llr[8] = {40, -40, 10, -10, 5, -5, 1, -1};
+  assert(cache.addSoft(4, llr, 8) == 1);
+  const uint8_t weak[1] = {0x00};                      // жёсткая копия против уверенных мягких
+  assert(cache.add(4, weak, 1) == 2);
+  std::vector<uint8_t> out;
+  std::vector<uint8_t> erased;
+  assert(cache.combine(4, out, erased));
+  assert(out.size() == 1 && out[0] == 0x80);
+  cache.clear();
+  assert(cache.size() == 0);
+  assert(!cache.combine(4, out, erased));
+}
+
+int main() {
+  testMajority();
+  testTwoCopiesWithErasures();
+  testPuncturedErasures();
+  testBounds();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
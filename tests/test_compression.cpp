@@ -0,0 +1,119 @@
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "libs/lzss/lzss.h"
+#include "libs/text_converter/text_converter.h"
+#include "libs/protocol/aggregate_utils.h"
+#include "tx_module.h"
+#include "rx_module.h"
+
+// Радиоинтерфейс, запоминающий отправленные кадры
+class RecordingRadio : public IRadio {
+public:
+  std::vector<std::vector<uint8_t>> sent;
+  int16_t send(const uint8_t* data, size_t len) override {
+    sent.emplace_back(data, data + len);
+    return ERR_NONE;
+  }
+  void setReceiveCallback(RxCallback) override {}
+};
+
+// Сжатие обратимо, типичный чат со словарём становится заметно короче
+static void testCodec() {
+  const auto ru = utf8ToCp1251("Привет! Как дела? Связь есть, всё в порядке, сообщение получено. До связи, спасибо");
+  const auto en = utf8ToCp1251("status: battery voltage 3.91 V, temperature 21.5, signal RSSI -112 SNR 4.5, OK");
+  assert(lzss::dictionary().size() < lzss::WINDOW);
+  for (const auto* text : {&ru, &en}) {
+    std::vector<uint8_t> packed;
+    assert(lzss::pack(text->data(), text->size(), packed));
+    assert(packed[0] == lzss::MARKER);
+    assert(packed.size() * 10 <= text->size() * 7);   // не меньше 30 % выигрыша
+    std::vector<uint8_t> out;
+    assert(lzss::unpack(packed.data(), packed.size(), out, 512));
+    assert(out == *text);
+
+    // Без словаря поток тоже обратим
+    std::vector<uint8_t> doubled(*text);
+    doubled.insert(doubled.end(), text->begin(), text->end());
+    assert(lzss::pack(doubled.data(), doubled.size(), packed, false));
+    assert(lzss::unpack(packed.data(), packed.size(), out, 512));
+    assert(out == doubled);
+  }
+
+  // Длинные повторы с перекрытием окна
+  std::vector<uint8_t> runs(300, 'x');
+  std::vector<uint8_t> packed;
+  assert(lzss::pack(runs.data(), runs.size(), packed));
+  std::vector<uint8_t> out;
+  assert(lzss::unpack(packed.data(), packed.size(), out, 512));
+  assert(out == runs);
+
+  // Ограничение памяти: заявленная длина больше предела отвергается до распаковки
+  assert(!lzss::unpack(packed.data(), packed.size(), out, 299));
+  assert(out.empty());
+
+  // Несжимаемые данные не упаковываются
+  std::mt19937 rng(7);
+  std::vector<uint8_t> noise(200);
+  for (auto& b : noise) b = static_cast<uint8_t>(rng());
+  assert(!lzss::pack(noise.data(), noise.size(), packed));
+  assert(packed.empty());
+  const uint8_t ack = 0x06;
+  assert(!lzss::pack(&ack, 1, packed));
+
+  // Повреждённый поток и обычный текст с 0x1C в начале не распаковываются
+  assert(lzss::pack(ru.data(), ru.size(), packed));
+  std::vector<uint8_t> cut(packed.begin(), packed.end() - 1);
+  assert(!lzss::unpack(cut.data(), cut.size(), out, 512));
+  std::vector<uint8_t> tail(packed);
+  tail.push_back(0);
+  assert(!lzss::unpack(tail.data(), tail.size(), out, 512));
+  const std::vector<uint8_t> text = {lzss::MARKER, 'a', 'b', 'c', 'd'};
+  assert(!lzss::unpack(text.data(), text.size(), out, 512));
+}
+
+// TxModule сжимает «сырой» кадр (и агрегат целиком), RxModule возвращает исходные сообщения
+static void testTxRx() {
+  RecordingRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{8, 8, 8, 8});
+  tx.setSendPause(0);
+  tx.setAirtimePacing(false);
+  tx.setCompressionEnabled(true);
+  tx.setAggregationEnabled(true);
+  const auto chat = utf8ToCp1251("Как слышно? Приём, на связи");
+  const auto status = utf8ToCp1251("status battery 87, temperature 19");
+  std::mt19937 rng(3);
+  std::vector<uint8_t> noise(120);
+  for (auto& b : noise) b = static_cast<uint8_t>(rng());
+  assert(tx.queue(chat.data(), chat.size(), 0));
+  assert(tx.queue(status.data(), status.size(), 1));
+  assert(tx.queue(noise.data(), noise.size(), 2));
+  for (int i = 0; i < 10; ++i) tx.loop();
+
+  assert(radio.sent.size() == 2);
+  assert(radio.sent[0][0] == lzss::MARKER);
+  assert(radio.sent[1] == noise);                      // без выигрыша кадр уходит как есть
+  assert(tx.getCompressedCount() == 1);
+  assert(radio.sent[0].size() + tx.getCompressionSavedBytes() ==
+         protocol::aggregate::HEADER_SIZE + 2 + chat.size() + status.size());
+
+  RxModule rx;
+  std::vector<std::vector<uint8_t>> delivered;
+  rx.setCallback([&](const uint8_t* d, size_t l) { delivered.emplace_back(d, d + l); });
+  for (const auto& frame : radio.sent) rx.onReceive(frame.data(), frame.size());
+  assert(delivered.size() == 3);
+  assert(delivered[0] == chat && delivered[1] == status && delivered[2] == noise);
+  assert(rx.decompressedCount() == 1 && rx.aggregateFrameCount() == 1);
+}
+
+int main() {
+  testCodec();
+  testTxRx();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+#include "libs/conv_codec/conv_codec.h"
+#include "libs/bit_interleaver/bit_interleaver.h"
+#include "libs/frame/frame_header.h"
+#define private public
+#include "tx_module.h"
+#undef private
+
+using conv_codec::Rate;
+
+// Радиоинтерфейс-заглушка: фрагменты проверяются до отправки
+class NullRadio : public IRadio {
+public:
+  int16_t send(const uint8_t*, size_t) override { return ERR_NONE; }
+  void setReceiveCallback(RxCallback) override {}
+};
+
+// Кодирование и декодирование на всех скоростях, исправление ошибок на проколотом потоке
+static void testCodecRoundTrip() {
+  std::vector<uint8_t> data(120);
+  for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 37 + 11);
+  data.push_back(0x00);                                // хвост для обнуления регистра
+  const size_t expected[] = {data.size() * 2, (data.size() * 8 * 3 / 2 + 7) / 8,
+                             (data.size() * 8 * 4 / 3 + 7) / 8, (data.size() * 8 * 6 / 5 + 7) / 8};
+  for (uint8_t r = 0; r < conv_codec::RATE_COUNT; ++r) {
+    const Rate rate = static_cast<Rate>(r);
+    std::vector<uint8_t> enc;
+    conv_codec::encodeBits(data.data(), data.size(), enc, rate);
+    assert(enc.size() == conv_codec::encodedSize(data.size(), rate));
+    assert(enc.size() == expected[r]);
+    assert(conv_codec::maxInputSize(enc.size(), rate) == data.size());
+    std::vector<uint8_t> dec;
+    assert(conv_codec::viterbiDecode(enc.data(), enc.size(), dec, rate));
+    assert(dec == data);
+
+    // Разнесённые одиночные ошибки исправляются и после прокалывания
+    std::vector<uint8_t> noisy(enc);
+    for (size_t pos = 8; pos + 2 < noisy.size(); pos += 24) noisy[pos] ^= 0x10;
+    assert(conv_codec::viterbiDecode(noisy.data(), noisy.size(), dec, rate));
+    assert(dec == data);
+
+    Rate parsed = Rate::R1_2;
+    assert(conv_codec::parseRate(conv_codec::rateName(rate), parsed));
+    assert(parsed == rate);
+  }
+  Rate parsed = Rate::R1_2;
+  assert(!conv_codec::parseRate("7/8", parsed));
+}
+
+// Фрагменты TxModule: скорость в флагах, размер части под скорость, свёртка на каждом фрагменте;
+// без прокалывания передатчик обязан уйти на 1/2
+static size_t prepareWithRate(Rate requested, const std::vector<uint8_t>& msg, std::vector<uint8_t>& reassembled,
+                              bool puncturing = true) {
+  NullRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{10, 10, 10, 10});
+  tx.setEncryptionEnabled(false);
+  if (puncturing) tx.setPuncturingEnabled(true);
+  assert(tx.isPuncturingEnabled() == puncturing);
+  const Rate rate = puncturing ? requested : Rate::R1_2;
+  fec::Profile profile;
+  profile.use_conv = true;
+  profile.use_bit_interleaver = true;
+  profile.conv_rate = requested;
+  tx.setFecOverride(profile);
+  TxModule::PendingMessage message;
+  message.id = 1;
+  message.data = msg;
+  assert(tx.ensureFragmentsReady(message));
+  reassembled.clear();
+  for (const auto& frag : message.fragments) {
+    const uint8_t flags = frag.header_flags;
+    assert(frag.conv_encoded && frag.bit_interleaved);
+    assert(flags & FrameHeader::FLAG_CONV_ENCODED);
+    assert(((flags & FrameHeader::CONV_RATE_MASK) >> FrameHeader::CONV_RATE_SHIFT) == static_cast<uint8_t>(rate));
+    std::vector<uint8_t> payload(frag.payload);
+    assert(payload.size() == frag.payload_size);
+    bit_interleaver::deinterleave(payload.data(), payload.size());
+    std::vector<uint8_t> dec;
+    assert(conv_codec::viterbiDecode(payload.data(), payload.size(), dec, rate));
+    assert(dec.size() == static_cast<size_t>(frag.plain_len) + 17);
+    dec.resize(frag.plain_len);                        // нулевой тег и хвост кодера
+    if (!dec.empty() && dec[0] == '[') {               // префикс части [TAG|i/n]
+      auto end = std::find(dec.begin(), dec.end(), ']');
+      assert(end != dec.end());
+      dec.erase(dec.begin(), end + 1);
+    }
+    reassembled.insert(reassembled.end(), dec.begin(), dec.end());
+  }
+  return message.fragments.size();
+}
+
+static void testTxRates() {
+  std::vector<uint8_t> msg(600);
+  for (size_t i = 0; i < msg.size(); ++i) msg[i] = static_cast<uint8_t>('a' + i % 26);
+  std::vector<uint8_t> half;
+  std::vector<uint8_t> fast;
+  const size_t halfFrames = prepareWithRate(Rate::R1_2, msg, half);
+  const size_t fastFrames = prepareWithRate(Rate::R5_6, msg, fast);
+  assert(fastFrames < halfFrames);
+  assert(half == msg);
+  assert(fast == msg);
+  // По умолчанию прокалывание выключено: приёмник пока не депрокалывает
+  std::vector<uint8_t> fallback;
+  assert(prepareWithRate(Rate::R5_6, msg, fallback, false) == halfFrames);
+  assert(fallback == msg);
+}
+
+int main() {
+  testCodecRoundTrip();
+  testTxRates();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+#include "libs/frame/delta_header.h"
+#include "libs/scrambler/scrambler.h"
+#define private public
+#include "tx_module.h"
+#undef private
+
+class NullRadio : public IRadio {
+public:
+  int16_t send(const uint8_t*, size_t) override { return ERR_NONE; }
+  void setReceiveCallback(RxCallback) override {}
+};
+
+static FrameHeader makeHdr(uint16_t msg_id, uint16_t frag_cnt, uint16_t idx, uint16_t len) {
+  FrameHeader hdr;
+  hdr.ver = 2;
+  hdr.msg_id = msg_id;
+  hdr.frag_cnt = frag_cnt;
+  hdr.setFlags(FrameHeader::FLAG_CONV_ENCODED);
+  hdr.setFragIdx(idx);
+  hdr.setPayloadLen(len);
+  return hdr;
+}
+
+static bool sameHeader(const FrameHeader& a, const FrameHeader& b) {
+  return a.ver == b.ver && a.msg_id == b.msg_id && a.frag_cnt == b.frag_cnt &&
+         a.packed == b.packed && a.interleave == b.interleave;
+}
+
+// Дельта восстанавливает заголовок из контекста, чужой контекст отвергается по CRC
+static void testCodec() {
+  const FrameHeader context = makeHdr(0x123, 400, 296, 120);
+  delta_header::Decoder decoder;
+  FrameHeader out;
+  size_t header_len = 0;
+  uint8_t ctx_buf[FrameHeader::SIZE];
+  FrameHeader ctx_copy = context;
+  uint8_t payload[120] = {};                           // encode() берёт длину из payload
+  assert(ctx_copy.encode(ctx_buf, sizeof(ctx_buf), payload, sizeof(payload)));
+  assert(decoder.parse(ctx_buf, sizeof(ctx_buf), out, header_len));
+  assert(header_len == FrameHeader::SIZE && sameHeader(out, context));
+
+  // Та же длина — 3 байта, индекс переходит через границу байта
+  const FrameHeader next = makeHdr(0x123, 400, 300, 120);
+  uint8_t delta[delta_header::DELTA_SIZE];
+  assert(delta_header::encodeDelta(context, next, delta, sizeof(delta)) == delta_header::DELTA_SHORT_SIZE);
+  assert(delta_header::isDelta(delta, delta_header::DELTA_SHORT_SIZE));
+  assert(decoder.parse(delta, delta_header::DELTA_SHORT_SIZE, out, header_len));
+  assert(header_len == delta_header::DELTA_SHORT_SIZE && sameHeader(out, next));
+
+  // Короткий последний фрагмент — 4 байта с явной длиной
+  const FrameHeader last = makeHdr(0x123, 400, 399, 37);
+  assert(delta_header::encodeDelta(context, last, delta, sizeof(delta)) == delta_header::DELTA_SIZE);
+  assert(decoder.parse(delta, delta_header::DELTA_SIZE, out, header_len));
+  assert(header_len == delta_header::DELTA_SIZE && sameHeader(out, last));
+  assert(decoder.deltaCount() == 2);
+
+  // Другие флаги дельтой не передаются
+  FrameHeader other_flags = next;
+  other_flags.setFlags(FrameHeader::FLAG_CONV_ENCODED | FrameHeader::FLAG_ENCRYPTED);
+  assert(delta_header::encodeDelta(context, other_flags, delta, sizeof(delta)) == 0);
+
+  // Сообщение с тем же номером контекста, но без своего полного заголовка
+  const FrameHeader alien_ctx = makeHdr(0x133, 400, 0, 120);
+  const FrameHeader alien = makeHdr(0x133, 400, 1, 120);
+  assert(delta_header::encodeDelta(alien_ctx, alien, delta, sizeof(delta)) == delta_header::DELTA_SHORT_SIZE);
+  assert(!decoder.parse(delta, delta_header::DELTA_SHORT_SIZE, out, header_len));
+  assert(decoder.lostContextCount() == 1);
+
+  delta_header::Decoder fresh;
+  assert(!fresh.parse(delta, delta_header::DELTA_SHORT_SIZE, out, header_len));
+  assert(fresh.lostContextCount() == 1);
+}
+
+// TxModule: полный заголовок на фрагментах 0, N, 2N…, остальные — дельты; потеря контекста
+// теряет фрагменты только до следующего полного заголовка
+static void testTxFrames() {
+  NullRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{10, 10, 10, 10});
+  tx.setEncryptionEnabled(false);
+  tx.setDeltaHeaders(true);
+  fec::Profile profile;
+  profile.use_conv = true;
+  profile.use_bit_interleaver = true;
+  tx.setFecOverride(profile);
+  TxModule::PendingMessage message;
+  message.id = 7;
+  message.data.resize(2000);
+  for (size_t i = 0; i < message.data.size(); ++i) message.data[i] = static_cast<uint8_t>(i * 13 + 5);
+  assert(tx.ensureFragmentsReady(message));
+  const size_t count = message.fragments.size();
+  const size_t refresh = DefaultSettings::DELTA_HEADER_REFRESH;
+  assert(count > 2 * refresh);
+
+  std::vector<std::vector<uint8_t>> frames(count);
+  size_t saved = 0;
+  for (size_t i = 0; i < count; ++i) {
+    assert(tx.buildFrame(message, i, frames[i]));
+    scrambler::descramble(frames[i].data(), frames[i].size());
+    saved += FrameHeader::SIZE - tx.headerLength(message, i);
+  }
+  delta_header::Decoder decoder;
+  for (size_t i = 0; i < count; ++i) {
+    const auto& frag = message.fragments[i];
+    FrameHeader hdr;
+    size_t header_len = 0;
+    assert(decoder.parse(frames[i].data(), frames[i].size(), hdr, header_len));
+    assert(header_len == tx.headerLength(message, i));
+    if (i % refresh == 0) assert(header_len == FrameHeader::SIZE);
+    else assert(header_len <= delta_header::DELTA_SIZE);
+    assert(hdr.msg_id == 7 && hdr.getFragIdx() == frag.chunk_idx);
+    assert(hdr.getFlags() == frag.header_flags && hdr.getPayloadLen() == frag.payload_size);
+  }
+  assert(saved > (count - count / refresh - 1) * (FrameHeader::SIZE - delta_header::DELTA_SIZE));
+
+  // Потерян первый кадр: дельты до фрагмента N отбрасываются, дальше приём восстанавливается
+  delta_header::Decoder late;
+  for (size_t i = 1; i < count; ++i) {
+    FrameHeader hdr;
+    size_t header_len = 0;
+    const bool ok = late.parse(frames[i].data(), frames[i].size(), hdr, header_len);
+    assert(ok == (i >= refresh));
+    if (ok) assert(hdr.getFragIdx() == message.fragments[i].chunk_idx);
+  }
+  assert(late.lostContextCount() == refresh - 1);
+
+  // Без дельта-заголовков каждый кадр несёт полный заголовок
+  tx.setDeltaHeaders(false);
+  for (size_t i = 0; i < count; ++i) assert(tx.headerLength(message, i) == FrameHeader::SIZE);
+}
+
+int main() {
+  testCodec();
+  testTxFrames();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
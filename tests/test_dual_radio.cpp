@@ -0,0 +1,122 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "radio_sx1262.h"
+#include "tx_module.h"
+#include "default_settings.h"
+#include "stubs/Arduino.h"
+
+// Доступ к внутреннему SX1262 и обработчику DIO1
+class RadioSX1262TestAccessor {
+public:
+  static RadioSX1262::PublicSX1262& rawRadio(RadioSX1262& radio) { return radio.radio_; }
+  static void dio1(RadioSX1262& radio) { radio.handleDio1(); }
+  static size_t queuedFrames(const RadioSX1262& radio) { return radio.txFrameEnds_.size(); }
+};
+
+// Дуплексная пара: аплинк только передаёт на TX-частоте, даунлинк не покидает RX-частоту
+static void testDuplexPair() {
+  RadioSX1262 uplink;
+  RadioSX1262 downlink(15, 33, 32, 4);
+  uplink.setRole(RadioSX1262::Role::UPLINK);
+  downlink.setRole(RadioSX1262::Role::DOWNLINK);
+  auto& up = RadioSX1262TestAccessor::rawRadio(uplink);
+  auto& down = RadioSX1262TestAccessor::rawRadio(downlink);
+  assert(downlink.begin());
+  assert(uplink.begin());
+  uplink.setDuplexPeer(&downlink);
+  ArduinoStub::gMillis = 1000;
+
+  assert(up.lastSetFrequency == uplink.getTxFrequency());
+  assert(up.startReceiveCalls == 0);                   // аплинк не слушает эфир
+  assert(up.standbyCalls == 1);
+  assert(down.lastSetFrequency == downlink.getRxFrequency());
+  assert(down.startReceiveCalls == 1);
+
+  // Смена канала и модема повторяется на даунлинке, каждая половина берёт свою частоту пары
+  assert(uplink.setChannel(2));
+  assert(downlink.getChannel() == 2);
+  assert(up.lastSetFrequency == uplink.getTxFrequency());
+  assert(down.lastSetFrequency == downlink.getRxFrequency());
+  assert(uplink.setSpreadingFactor(9));
+  assert(downlink.getSpreadingFactor() == 9);
+
+  // Передача через TxModule: без перестройки частоты и без возврата аплинка в приём
+  TxModule tx(uplink, std::array<size_t,4>{4, 4, 4, 4});
+  tx.setSendPause(0);
+  tx.setListenBeforeTalk(false);
+  std::vector<std::vector<uint8_t>> received;
+  downlink.setReceiveCallback([&](const uint8_t* d, size_t l) { received.emplace_back(d, d + l); });
+  const size_t upFreqCalls = up.setFrequencyCalls;
+  const size_t downRxCalls = down.startReceiveCalls;
+  const uint8_t msg[] = {'H', 'I'};
+  assert(tx.queue(msg, sizeof(msg)) != 0);
+  assert(!tx.loop());
+  assert(uplink.isTransmitting());
+
+  // Пока аплинк в эфире, даунлинк принимает встречный кадр
+  const uint8_t packet[] = {subpacket::LAST_BIT, 0x42, 0x43};
+  std::copy(packet, packet + sizeof(packet), down.testReadBuffer.begin());
+  down.testReadBufferSize = sizeof(packet);
+  down.testPacketLength = sizeof(packet);
+  down.testIrqFlags = RADIOLIB_SX126X_IRQ_RX_DONE;
+  RadioSX1262TestAccessor::dio1(downlink);
+  downlink.loop();
+  assert(received.size() == 1);
+  assert((received[0] == std::vector<uint8_t>{0x42, 0x43}));
+  assert(uplink.isTransmitting());
+
+  RadioSX1262TestAccessor::dio1(uplink);
+  assert(tx.loop());
+  assert(!uplink.isTransmitting());
+  assert(up.setFrequencyCalls == upFreqCalls);         // аплинк стоит на TX-частоте
+  assert(up.startReceiveCalls == 0);
+  assert(up.standbyCalls == 2);                        // после серии — standby вместо приёма
+  assert(down.startReceiveCalls == downRxCalls + 1);   // даунлинк перезапустил только свой приём
+
+  // Даунлинк не передаёт
+  size_t sent = 0;
+  const IRadio::Frame frame{msg, sizeof(msg)};
+  const size_t downTx = down.startTransmitCalls;
+  const size_t downFreqCalls = down.setFrequencyCalls;
+  const int16_t state = downlink.startSendBurst(&frame, 1, sent);
+  assert(state != IRadio::ERR_NONE && state != IRadio::ERR_PENDING);
+  assert(down.startTransmitCalls == downTx);
+  // Отказ не оставляет подготовленной серии и не выдаёт «передача идёт» опросу
+  assert(RadioSX1262TestAccessor::queuedFrames(downlink) == 0);
+  assert(down.setFrequencyCalls == downFreqCalls);
+  assert(!downlink.isTransmitting());
+  assert(downlink.pollSend(sent) == IRadio::ERR_NONE && sent == 0);
+}
+
+// Без разворота TX→RX пауза после кадра сокращается до времени в эфире
+static void testFullDuplexPacing() {
+  RadioSX1262 radio;
+  assert(radio.begin());
+  TxModule tx(radio, std::array<size_t,4>{4, 4, 4, 4});
+  tx.setListenBeforeTalk(false);
+  tx.setAirtimePacing(true);
+  const uint8_t msg[] = {1, 2, 3};
+  assert(tx.queue(msg, sizeof(msg)) != 0);
+  while (!tx.loop()) {
+    RadioSX1262TestAccessor::dio1(radio);
+  }
+  const uint32_t halfDuplexPause = tx.getEffectivePause();
+  assert(!tx.isFullDuplex());
+  tx.setFullDuplex(true);
+  assert(tx.isFullDuplex());
+  const uint32_t fullDuplexPause = tx.getEffectivePause();
+  assert(fullDuplexPause < halfDuplexPause);
+  assert(fullDuplexPause >= tx.getLastAirtimeUs() / 1000U);
+  tx.setFullDuplex(false);
+  assert(tx.getEffectivePause() == halfDuplexPause);
+}
+
+int main() {
+  testDuplexPair();
+  testFullDuplexPacing();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
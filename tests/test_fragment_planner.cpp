@@ -0,0 +1,107 @@
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+#include "libs/fragment_planner/fragment_planner.h"
+#include "libs/airtime/lora_airtime.h"
+#include "libs/subpacket/subpacket.h"
+#define private public
+#include "tx_module.h"
+#undef private
+
+// Радио с нарезкой кадра на пакеты implicit-режима фиксированной длины, как RadioSX1262
+class ImplicitRadio : public IRadio {
+public:
+  int16_t send(const uint8_t*, size_t) override { return ERR_NONE; }
+  void setReceiveCallback(RxCallback) override {}
+  uint32_t airtimeUs(size_t len) const override {
+    lora_airtime::ModemParams params;
+    params.spreadingFactor = 9;
+    params.implicitHeader = true;
+    return lora_airtime::frameTimeOnAirUs(params, len, 64, 245, subpacket::OVERHEAD);
+  }
+};
+
+// Ступенчатая стоимость: выгоднее части, укладывающиеся в меньшее число пакетов
+static void testPlanner() {
+  auto cost = [](size_t len) -> uint32_t { return static_cast<uint32_t>(1000 * ((len + 10 + 49) / 50)); };
+  fragment_planner::Plan plan;
+  assert(fragment_planner::plan(200, 1, 95, 100, cost, plan));
+  assert((plan.count - 1) * plan.chunk + plan.last == 200);
+  assert(plan.last >= 1 && plan.last <= plan.chunk);
+  assert(plan.chunk <= 90);                            // 95 байт занимают три пакета вместо двух
+  assert(plan.airtime_us <= 5000 + 3 * 100);
+
+  // Без данных о времени — обычная нарезка по максимуму
+  assert(fragment_planner::plan(200, 1, 95, 0, [](size_t) { return 0U; }, plan));
+  assert(plan.chunk == 95 && plan.count == 3 && plan.last == 10);
+  // Короткое сообщение — одна часть
+  assert(fragment_planner::plan(30, 1, 95, 0, cost, plan));
+  assert(plan.count == 1 && plan.last == 30);
+  assert(!fragment_planner::plan(0, 1, 95, 0, cost, plan));
+}
+
+// Время передачи подготовленных фрагментов сообщения len байт
+static uint64_t sentAirtime(bool planning, size_t len, size_t& fragments) {
+  ImplicitRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{10, 10, 10, 10});
+  tx.setEncryptionEnabled(false);
+  tx.setAirtimePlanning(planning);
+  fec::Profile profile;
+  profile.use_conv = true;
+  profile.use_bit_interleaver = true;
+  tx.setFecOverride(profile);
+  TxModule::PendingMessage message;
+  message.id = 5;
+  message.data.resize(len);
+  for (size_t i = 0; i < len; ++i) message.data[i] = static_cast<uint8_t>(i * 7);
+  assert(tx.ensureFragmentsReady(message));
+  fragments = message.fragments.size();
+  uint64_t total = 0;
+  for (size_t i = 0; i < fragments; ++i) {
+    std::vector<uint8_t> frame;
+    assert(tx.buildFrame(message, i, frame));
+    total += radio.airtimeUs(frame.size()) + tx.frameOverheadUs();
+  }
+  if (planning) {
+    const auto plan = tx.planFragments(len);
+    assert(plan.count == fragments);
+    assert(plan.airtime_us == total);                  // прогноз совпадает с реальными кадрами
+    assert(tx.predictAirtimeUs(len, true) == total);
+  }
+  return total;
+}
+
+// Подобранные части никогда не дольше нарезки по максимуму и на части длин заметно короче
+static void testTxPlanning() {
+  size_t improved = 0;
+  for (size_t len = 40; len <= 1200; len += 37) {
+    size_t planned_frags = 0;
+    size_t fixed_frags = 0;
+    const uint64_t planned = sentAirtime(true, len, planned_frags);
+    const uint64_t fixed = sentAirtime(false, len, fixed_frags);
+    assert(planned <= fixed);
+    if (planned < fixed) ++improved;
+  }
+  assert(improved > 0);
+
+  ImplicitRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{10, 10, 10, 10});
+  assert(tx.predictAirtimeUs(100, false) == radio.airtimeUs(100) + tx.frameOverheadUs());
+  assert(tx.predictAirtimeUs(0, false) == 0);
+}
+
+int main() {
+  testPlanner();
+  testTxPlanning();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,170 @@
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+#include "libs/frame_interleaver/frame_interleaver.h"
+#include "libs/conv_codec/conv_codec.h"
+#include "libs/bit_interleaver/bit_interleaver.h"
+#include "libs/frame/frame_header.h"
+#define private public
+#include "tx_module.h"
+#undef private
+
+class NullRadio : public IRadio {
+public:
+  int16_t send(const uint8_t*, size_t) override { return ERR_NONE; }
+  void setReceiveCallback(RxCallback) override {}
+};
+
+static std::vector<uint8_t> makeData(size_t len, uint8_t seed) {
+  std::vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; ++i) data[i] = static_cast<uint8_t>(i * 41 + seed * 17);
+  data.push_back(0x00);                                // хвост кодера
+  return data;
+}
+
+// Перемежение обратимо, каждый кадр несёт по 1/N байтов каждого блока
+static void testRoundTrip() {
+  const size_t depth = 4;
+  const size_t len = 50;
+  std::vector<std::vector<uint8_t>> blocks(depth);
+  for (size_t i = 0; i < depth; ++i) blocks[i] = std::vector<uint8_t>(len, static_cast<uint8_t>(0x10 * (i + 1)));
+  auto frames = blocks;
+  std::array<uint8_t*, 4> rows{};
+  for (size_t i = 0; i < depth; ++i) rows[i] = frames[i].data();
+  assert(frame_interleaver::interleave(rows.data(), depth, len));
+  for (size_t j = 0; j < depth; ++j) {
+    size_t counts[4] = {};
+    for (uint8_t b : frames[j]) counts[b / 0x10 - 1]++;
+    for (size_t i = 0; i < depth; ++i) assert(counts[i] >= len / depth && counts[i] <= len / depth + 1);
+  }
+  assert(frame_interleaver::deinterleave(rows.data(), depth, len));
+  assert(frames == blocks);
+  assert(!frame_interleaver::interleave(rows.data(), 1, len));
+  assert(!frame_interleaver::interleave(rows.data(), frame_interleaver::MAX_DEPTH + 1, len));
+}
+
+// Потеря целого кадра: без перемежения пропадает блок, с перемежением все блоки декодируются
+static void testFadeRecovery() {
+  const uint8_t depth = 4;
+  std::vector<std::vector<uint8_t>> data(depth);
+  std::vector<std::vector<uint8_t>> frames(depth);
+  std::array<uint8_t*, 4> rows{};
+  for (uint8_t i = 0; i < depth; ++i) {
+    data[i] = makeData(80, i);
+    conv_codec::encodeBits(data[i].data(), data[i].size(), frames[i]);
+    bit_interleaver::interleave(frames[i].data(), frames[i].size());
+    rows[i] = frames[i].data();
+  }
+  const size_t len = frames[0].size();
+  assert(frame_interleaver::interleave(rows.data(), depth, len));
+
+  const uint8_t lost = 2;                              // замирание накрыло третий кадр
+  frame_interleaver::Group group;
+  assert(group.reset(depth, len));
+  for (uint8_t j = 0; j < depth; ++j) {
+    if (j == lost) continue;
+    assert(group.add(j, frames[j].data(), frames[j].size()));
+  }
+  assert(!group.add(0, frames[0].data(), frames[0].size())); // повтор
+  assert(!group.complete());
+  assert(group.receivedCount() == depth - 1);
+
+  for (uint8_t i = 0; i < depth; ++i) {
+    std::vector<uint8_t> block;
+    std::vector<uint8_t> erased;
+    assert(group.block(i, block, erased));
+    size_t erased_bytes = 0;
+    for (size_t c = 0; c < len; ++c) {
+      if (erased[c]) {
+        ++erased_bytes;
+        assert(c + 1 >= len || !erased[c + 1]);        // стирания разнесены
+      }
+    }
+    assert(erased_bytes >= len / depth && erased_bytes <= len / depth + 1);
+    bit_interleaver::deinterleave(block.data(), block.size());
+    bit_interleaver::deinterleave(erased.data(), erased.size());
+    std::vector<uint8_t> dec;
+    assert(conv_codec::viterbiDecodeErasures(block.data(), erased.data(), block.size(), dec));
+    assert(dec == data[i]);
+  }
+
+  // Полная группа восстанавливается без стираний
+  group.reset(depth, len);
+  for (uint8_t j = 0; j < depth; ++j) group.add(j, frames[j].data(), frames[j].size());
+  assert(group.complete());
+  std::vector<uint8_t> block;
+  std::vector<uint8_t> erased;
+  assert(group.block(1, block, erased));
+  bit_interleaver::deinterleave(block.data(), block.size());
+  std::vector<uint8_t> dec;
+  assert(conv_codec::viterbiDecode(block.data(), block.size(), dec));
+  assert(dec == data[1]);
+}
+
+static TxModule::PendingMessage prepare(uint8_t depth, const std::vector<uint8_t>& msg) {
+  NullRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{10, 10, 10, 10});
+  tx.setEncryptionEnabled(false);
+  fec::Profile profile;
+  profile.use_conv = true;
+  profile.use_bit_interleaver = true;
+  profile.frame_interleave = depth;
+  tx.setFecOverride(profile);
+  TxModule::PendingMessage message;
+  message.id = 3;
+  message.data = msg;
+  assert(tx.ensureFragmentsReady(message));
+  return message;
+}
+
+// TxModule перемежает полные группы одинаковых блоков, глубина уходит в заголовок
+static void testTxGroups() {
+  std::vector<uint8_t> msg(900);
+  for (size_t i = 0; i < msg.size(); ++i) msg[i] = static_cast<uint8_t>('A' + i % 23);
+  const auto plain = prepare(1, msg);
+  const auto mixed = prepare(4, msg);
+  assert(plain.fragments.size() == mixed.fragments.size());
+  assert(mixed.fragments.size() >= 5);
+  std::array<std::vector<uint8_t>, 4> group;
+  std::array<uint8_t*, 4> rows{};
+  for (size_t j = 0; j < 4; ++j) {
+    assert(plain.fragments[j].frame_interleave == 0);
+    assert(mixed.fragments[j].frame_interleave == 4);
+    assert(mixed.fragments[j].payload != plain.fragments[j].payload);
+    group[j] = mixed.fragments[j].payload;
+    rows[j] = group[j].data();
+  }
+  assert(frame_interleaver::deinterleave(rows.data(), 4, group[0].size()));
+  for (size_t j = 0; j < 4; ++j) assert(group[j] == plain.fragments[j].payload);
+  const auto& tail = mixed.fragments.back();
+  assert(tail.frame_interleave == 0);                  // неполная группа не перемежается
+  assert(tail.payload == plain.fragments.back().payload);
+
+  // Глубина переживает кодирование заголовка; в укороченном заголовке её нет
+  FrameHeader hdr;
+  hdr.interleave = 4;
+  uint8_t buf[FrameHeader::SIZE];
+  assert(hdr.encode(buf, sizeof(buf), nullptr, 0));
+  FrameHeader parsed;
+  assert(FrameHeader::decode(buf, sizeof(buf), parsed));
+  assert(parsed.interleave == 4);
+  assert(FrameHeader::decode(buf, FrameHeader::MIN_SIZE, parsed));
+  assert(parsed.interleave == 0);
+}
+
+int main() {
+  testRoundTrip();
+  testFadeRecovery();
+  testTxGroups();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,192 @@
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+#include "libs/conv_codec/conv_codec.h"
+#include "libs/harq/harq.h"
+#include "libs/protocol/nack_utils.h"
+#include "libs/frame/frame_header.h"
+#define private public
+#include "tx_module.h"
+#undef private
+
+using conv_codec::Rate;
+
+class NullRadio : public IRadio {
+public:
+  int16_t send(const uint8_t*, size_t) override { return ERR_NONE; }
+  void setReceiveCallback(RxCallback) override {}
+};
+
+static std::vector<uint8_t> makeInput(size_t len) {
+  std::vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; ++i) data[i] = static_cast<uint8_t>(i * 53 + 7);
+  data.push_back(0x00);                                // хвост кодера
+  return data;
+}
+
+// RV0 совпадает с проколотой скоростью 5/6, все версии вместе — полный поток 1/2
+static void testRedundancyVersions() {
+  const std::vector<uint8_t> input = makeInput(100);
+  std::vector<uint8_t> rv0;
+  assert(harq::buildRedundancy(input.data(), input.size(), 0, rv0));
+  std::vector<uint8_t> fast;
+  conv_codec::encodeBits(input.data(), input.size(), fast, Rate::R5_6);
+  assert(rv0 == fast);
+  size_t bits = 0;
+  for (uint8_t rv = 0; rv < harq::RV_COUNT; ++rv) {
+    bits += harq::redundancyBits(input.size(), rv);
+    std::vector<uint8_t> out;
+    assert(harq::buildRedundancy(input.data(), input.size(), rv, out));
+    assert(out.size() == harq::redundancySize(input.size(), rv));
+  }
+  assert(bits == input.size() * 16);
+  assert(harq::inputLenFromFirst(rv0.size()) == input.size());
+  std::vector<uint8_t> out;
+  assert(!harq::buildRedundancy(input.data(), input.size(), harq::RV_COUNT, out));
+}
+
+// Зашумлённая первая передача не декодируется, после досылки избыточности — декодируется
+static void testCombiner() {
+  const std::vector<uint8_t> input = makeInput(100);
+  std::vector<uint8_t> rv[harq::RV_COUNT];
+  for (uint8_t i = 0; i < harq::RV_COUNT; ++i) {
+    assert(harq::buildRedundancy(input.data(), input.size(), i, rv[i]));
+  }
+
+  harq::Combiner clean;
+  clean.reset(input.size());
+  assert(clean.nextRv() == 0);
+  assert(clean.add(0, rv[0].data(), rv[0].size()));
+  assert(clean.has(0) && clean.nextRv() == 1);
+  std::vector<uint8_t> dec;
+  assert(clean.decode(dec));
+  assert(dec == input);
+
+  std::vector<uint8_t> noisy(rv[0]);
+  for (size_t pos = 4; pos < noisy.size(); pos += 9) noisy[pos] ^= 0x21;
+  harq::Combiner comb;
+  comb.reset(input.size());
+  assert(comb.add(0, noisy.data(), noisy.size()));
+  assert(!comb.decode(dec) || dec != input);
+  assert(!comb.add(1, rv[1].data(), rv[1].size() - 1)); // длина не совпадает
+  assert(comb.add(1, rv[1].data(), rv[1].size()));
+  assert(comb.add(2, rv[2].data(), rv[2].size()));
+  assert(comb.nextRv() == harq::RV_COUNT);
+  assert(comb.decode(dec));
+  assert(dec == input);
+}
+
+static void testNackFrame() {
+  protocol::nack::Request req{0x1234, 0x0102, 2};
+  uint8_t frame[protocol::nack::SIZE];
+  protocol::nack::encode(req, frame);
+  protocol::nack::Request parsed{};
+  assert(protocol::nack::decode(frame, sizeof(frame), parsed));
+  assert(parsed.msg_id == req.msg_id && parsed.frag_idx == req.frag_idx && parsed.rv == req.rv);
+  assert(!protocol::nack::decode(frame, sizeof(frame) - 1, parsed));
+  frame[0] = 0x06;
+  assert(!protocol::nack::decode(frame, sizeof(frame), parsed));
+}
+
+// TxModule: первая передача на 5/6, по NACK в приоритетную очередь встаёт только запрошенная версия
+static void testTxNack() {
+  NullRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{10, 10, 10, 10});
+  tx.setEncryptionEnabled(false);
+  tx.setPuncturingEnabled(true);
+  tx.setHarqEnabled(true);
+  fec::Profile profile;
+  profile.use_conv = true;
+  profile.use_bit_interleaver = false;
+  profile.conv_rate = Rate::R1_2;
+  tx.setFecOverride(profile);
+  TxModule::PendingMessage message;
+  message.id = 7;
+  message.data.assign(300, 'x');
+  assert(tx.ensureFragmentsReady(message));
+  assert(message.fragments.size() >= 2);
+  const auto& first = message.fragments[1];
+  assert(((first.header_flags & FrameHeader::CONV_RATE_MASK) >> FrameHeader::CONV_RATE_SHIFT) ==
+         static_cast<uint8_t>(Rate::R5_6));
+  assert(!first.coded_input.empty());
+
+  assert(!tx.onNackReceived(8, 0, 1));                  // неизвестное сообщение
+  assert(!tx.onNackReceived(7, 1, harq::RV_COUNT));     // недопустимая версия
+  assert(tx.onNackReceived(7, 1, 1));
+  assert(tx.getHarqRedundancyCount() == 1);
+  assert(tx.ack_queue_.size() == 1);
+  const auto& queued = tx.ack_queue_.front();
+  assert(queued.is_ack && queued.id == 7 && queued.fragments.size() == 1);
+  const auto& red = queued.fragments.front();
+  assert(red.header_flags & FrameHeader::FLAG_HARQ_REDUNDANCY);
+  assert(red.header_flags & FrameHeader::FLAG_CONV_ENCODED);
+  assert(((red.header_flags & FrameHeader::CONV_RATE_MASK) >> FrameHeader::CONV_RATE_SHIFT) == 1);
+  assert(red.chunk_idx == first.chunk_idx);
+  assert(red.payload.size() == harq::redundancySize(first.coded_input.size(), 1));
+
+  // Приёмник собирает фрагмент из первой передачи и присланной версии
+  harq::Combiner comb;
+  comb.reset(harq::inputLenFromFirst(first.payload.size()));
+  assert(comb.inputLen() == first.coded_input.size());
+  assert(comb.add(0, first.payload.data(), first.payload.size()));
+  assert(comb.add(1, red.payload.data(), red.payload.size()));
+  std::vector<uint8_t> dec;
+  assert(comb.decode(dec));
+  assert(dec == first.coded_input);
+}
+
+// Один и тот же id в разных классах QoS: NACK не должен строить версию из чужого сообщения
+static void testNackAcrossClasses() {
+  NullRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{10, 10, 10, 10});
+  tx.setEncryptionEnabled(false);
+  tx.setPuncturingEnabled(true);
+  tx.setHarqEnabled(true);
+  fec::Profile profile;
+  profile.use_conv = true;
+  profile.use_bit_interleaver = false;
+  profile.conv_rate = Rate::R1_2;
+  tx.setFecOverride(profile);
+  TxModule::PendingMessage chat;
+  chat.id = 1;
+  chat.qos = 0;
+  chat.data.assign(300, 'c');
+  assert(tx.ensureFragmentsReady(chat));
+  assert(tx.onNackReceived(1, 1, 1));                   // пока id однозначен — версия строится
+  assert(tx.ack_queue_.size() == 1);
+  const auto first = tx.ack_queue_.front().fragments.front().payload;
+
+  // Повторный запрос к тому же сообщению (копия в истории и в передаче) не считается неоднозначным
+  tx.inflight_.emplace(chat);
+  assert(tx.onNackReceived(1, 1, 1));
+  assert(tx.ack_queue_.size() == 2 && tx.ack_queue_.back().fragments.front().payload == first);
+  tx.inflight_.reset();
+
+  TxModule::PendingMessage bulk;
+  bulk.id = 1;
+  bulk.qos = 2;
+  bulk.data.assign(300, 'b');
+  assert(tx.ensureFragmentsReady(bulk));
+  assert(!tx.onNackReceived(1, 1, 1));                  // id 1 есть в классах 0 и 2 — отказ
+  assert(tx.ack_queue_.size() == 2);
+  assert(tx.getHarqRedundancyCount() == 2);
+}
+
+int main() {
+  testRedundancyVersions();
+  testCombiner();
+  testNackFrame();
+  testTxNack();
+  testNackAcrossClasses();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
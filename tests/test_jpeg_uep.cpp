@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+#include "libs/jpeg_uep/jpeg_uep.h"
+#include "libs/conv_codec/conv_codec.h"
+#include "libs/bit_interleaver/bit_interleaver.h"
+#include "libs/frame/frame_header.h"
+#define private public
+#include "tx_module.h"
+#undef private
+
+using conv_codec::Rate;
+
+class NullRadio : public IRadio {
+public:
+  int16_t send(const uint8_t*, size_t) override { return ERR_NONE; }
+  void setReceiveCallback(RxCallback) override {}
+};
+
+static void appendSegment(std::vector<uint8_t>& out, uint8_t marker, size_t body, uint8_t fill) {
+  out.push_back(0xFF);
+  out.push_back(marker);
+  out.push_back(static_cast<uint8_t>((body + 2) >> 8));
+  out.push_back(static_cast<uint8_t>(body + 2));
+  out.insert(out.end(), body, fill);
+}
+
+// Синтетический JPEG: заголовки, DRI и скан из intervals интервалов рестарта
+static std::vector<uint8_t> makeJpeg(size_t intervals, size_t interval_len, std::vector<size_t>& restarts) {
+  std::vector<uint8_t> out = {0xFF, 0xD8};
+  appendSegment(out, 0xE0, 14, 0x4A);                  // APP0
+  appendSegment(out, 0xDB, 65, 0x10);                  // DQT
+  appendSegment(out, 0xC0, 15, 0x08);                  // SOF0
+  appendSegment(out, 0xC4, 180, 0x03);                 // DHT
+  appendSegment(out, 0xDD, 2, 0x04);                   // DRI
+  appendSegment(out, 0xDA, 10, 0x01);                  // SOS
+  restarts.clear();
+  for (size_t k = 0; k < intervals; ++k) {
+    if (k) {
+      restarts.push_back(out.size());
+      out.push_back(0xFF);
+      out.push_back(static_cast<uint8_t>(0xD0 + (k - 1) % 8));
+    }
+    for (size_t i = 0; i < interval_len; ++i) {
+      const uint8_t b = static_cast<uint8_t>(i * 7 + k * 13);
+      out.push_back(b);
+      if (b == 0xFF) out.push_back(0x00);              // экранирование в энтропийных данных
+    }
+  }
+  out.push_back(0xFF);
+  out.push_back(0xD9);
+  return out;
+}
+
+static void testParseAndPlan() {
+  std::vector<size_t> restarts;
+  const auto jpeg = makeJpeg(9, 70, restarts);
+  std::vector<jpeg_uep::Segment> segs;
+  assert(jpeg_uep::parse(jpeg.data(), jpeg.size(), segs));
+  assert(segs.size() == 10);                           // заголовок целиком и 9 интервалов
+  assert(segs[0].critical && segs[0].offset == 0);
+  for (size_t i = 1; i < segs.size(); ++i) {
+    assert(!segs[i].critical);
+    assert(segs[i].offset == segs[i - 1].offset + segs[i - 1].len);
+    if (i > 1) assert(segs[i].offset == restarts[i - 2]);
+  }
+  assert(segs.back().offset + segs.back().len == jpeg.size());
+
+  std::vector<jpeg_uep::Segment> parts;
+  assert(jpeg_uep::plan(jpeg.data(), jpeg.size(), 40, 160, parts));
+  size_t pos = 0;
+  size_t critical = 0;
+  for (const auto& part : parts) {
+    assert(part.offset == pos);
+    pos += part.len;
+    if (part.critical) {
+      ++critical;
+      assert(part.len <= 40);
+    } else {
+      assert(part.len <= 160);
+      // Каждая часть скана начинается с маркера рестарта или с начала скана
+      assert(part.offset == segs[1].offset ||
+             std::find(restarts.begin(), restarts.end(), part.offset) != restarts.end());
+    }
+  }
+  assert(pos == jpeg.size());
+  assert(critical == (segs[0].len + 39) / 40);
+
+  // Интервал длиннее части режется по размеру, обрывы и чужие данные отвергаются
+  const auto longJpeg = makeJpeg(2, 400, restarts);
+  assert(jpeg_uep::plan(longJpeg.data(), longJpeg.size(), 40, 160, parts));
+  for (const auto& part : parts) assert(part.len <= (part.critical ? 40U : 160U));
+  assert(!jpeg_uep::parse(jpeg.data(), 30, segs));
+  const uint8_t text[] = "not a jpeg";
+  assert(!jpeg_uep::isJpeg(text, sizeof(text)));
+  assert(!jpeg_uep::plan(text, sizeof(text), 40, 160, parts));
+}
+
+// TxModule: маркерные сегменты на 1/2 и с повтором, скан на 3/4, сообщение собирается по индексам
+static void testTxUep() {
+  std::vector<size_t> restarts;
+  const auto jpeg = makeJpeg(12, 90, restarts);
+  NullRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{10, 10, 10, 10});
+  tx.setEncryptionEnabled(false);
+  tx.setPuncturingEnabled(true);
+  fec::Profile profile;
+  profile.use_conv = true;
+  profile.use_bit_interleaver = true;
+  profile.conv_rate = Rate::R1_2;
+  tx.setFecOverride(profile);
+
+  const uint8_t tiny[] = {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x04, 0x00, 0x00, 0xFF, 0xD9};
+  const uint16_t id = tx.queueImage(tiny, sizeof(tiny), 2);
+  assert(id != 0);
+  assert(tx.uep_messages_.count(TxModule::queueKey(2, id)) == 1);
+  assert(tx.plain_messages_.count(TxModule::queueKey(2, id)) == 0);
+  const uint8_t text[] = "plain text";
+  const uint16_t other = tx.queueImage(text, sizeof(text), 2);
+  assert(other != 0 && tx.uep_messages_.count(TxModule::queueKey(2, other)) == 0);
+
+  TxModule::PendingMessage message;
+  message.id = id;
+  message.data = jpeg;
+  message.jpeg_uep = true;
+  assert(tx.ensureFragmentsReady(message));
+  const size_t unique = message.frag_cnt;
+  assert(unique > 0 && unique < message.fragments.size());
+  assert(tx.getUepCopyCount() == message.fragments.size() - unique);
+
+  std::vector<std::vector<uint8_t>> parts(unique);
+  size_t header_bytes = 0;
+  for (size_t i = 0; i < message.fragments.size(); ++i) {
+    const auto& frag = message.fragments[i];
+    const Rate rate = static_cast<Rate>((frag.header_flags & FrameHeader::CONV_RATE_MASK) >> FrameHeader::CONV_RATE_SHIFT);
+    assert(frag.conv_encoded && frag.bit_interleaved);
+    std::vector<uint8_t> payload(frag.payload);
+    bit_interleaver::deinterleave(payload.data(), payload.size());
+    std::vector<uint8_t> dec;
+    assert(conv_codec::viterbiDecode(payload.data(), payload.size(), dec, rate));
+    dec.resize(frag.plain_len);
+    if (i >= unique) {                                 // повтор — копия защищённого фрагмента
+      assert(rate == Rate::R1_2);
+      assert(dec == parts[frag.chunk_idx]);
+      continue;
+    }
+    assert(frag.chunk_idx == i);
+    if (rate == Rate::R1_2) header_bytes += dec.size();
+    else assert(rate == Rate::R3_4);
+    parts[i] = dec;
+  }
+  std::vector<uint8_t> joined;
+  for (const auto& p : parts) joined.insert(joined.end(), p.begin(), p.end());
+  assert(joined == jpeg);
+  std::vector<jpeg_uep::Segment> segs;
+  assert(jpeg_uep::parse(jpeg.data(), jpeg.size(), segs));
+  assert(header_bytes == segs[0].len);                 // на 1/2 ушли ровно маркерные сегменты
+}
+
+int main() {
+  testParseAndPlan();
+  testTxUep();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
@@ -3,7 +3,7 @@
 #include <vector>
 #include "default_settings.h"
 #include "message_buffer.h"
-#include "packetizer/packet_splitter.h"
+#include "libs/packetizer/packet_splitter.h"
 
 // Проверка, что буфер размещает несколько сообщений по 5000 байт
 int main() {
@@ -17,6 +17,15 @@ int main() {
   }
   // после трёх сообщений должно остаться место ещё под одно
   assert(buf.freeSlots() == DefaultSettings::TX_QUEUE_CAPACITY - 3 * parts);
+
+  // Арена очереди принимает сообщение целиком, без предварительной нарезки
+  MessageBuffer whole(DefaultSettings::TX_QUEUE_CAPACITY);
+  for (int i = 0; i < 4; ++i) {
+    assert(whole.enqueue(data.data(), data.size()) != 0);
+  }
+  assert(whole.usedBytes() == 4 * (data.size() + MessageBuffer::RECORD_HEADER));
+  MessageBuffer::View view;
+  assert(whole.peek(view) && view.len == data.size());
   std::cout << "OK" << std::endl;
   return 0;
 }
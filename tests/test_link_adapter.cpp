@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+
+#include "libs/link_adapt/link_adapter.h"
+#include "libs/protocol/link_control.h"
+
+using link_adapt::LinkAdapter;
+
+static link_adapt::Settings testSettings() {
+  link_adapt::Settings s;
+  s.targetPer = 0.2f;
+  s.marginDb = 3.0f;
+  s.hysteresisDb = 2.0f;
+  s.holdMs = 1000;
+  s.advertMs = 5000;
+  s.fallbackMs = 10000;
+  s.minSamples = 4;
+  return s;
+}
+
+// Несколько кадров с одинаковым SNR
+static void feed(LinkAdapter& la, float snr, bool complete, uint32_t now, int count = 4) {
+  for (int i = 0; i < count; ++i) la.onRxFrame(snr, -90.0f, complete, now);
+}
+
+// Лестница упорядочена по скорости, профиль по умолчанию попадает на свою ступень
+static void testLadder() {
+  const size_t n = link_adapt::rungCount();
+  assert(n >= 2);
+  for (size_t i = 1; i < n; ++i) {
+    const auto& slow = link_adapt::profile(static_cast<uint8_t>(i - 1));
+    const auto& fast = link_adapt::profile(static_cast<uint8_t>(i));
+    assert(link_adapt::relativeRate(fast.spreadingFactor, fast.codingRateDenom, fast.conv) >
+           link_adapt::relativeRate(slow.spreadingFactor, slow.codingRateDenom, slow.conv));
+    assert(fast.requiredSnrDb > slow.requiredSnrDb);
+  }
+  const uint8_t base = link_adapt::matchRung(7, 5, true);
+  assert(link_adapt::profile(base).spreadingFactor == 7);
+  assert(link_adapt::profile(base).conv);
+  assert(link_adapt::matchRung(12, 8, true) == 0);
+  assert(link_adapt::matchRung(5, 5, false) == n - 1);
+}
+
+// Без анонса пира действует базовая ступень; повышение по одной с выдержкой
+static void testConvergeAndUpgrade() {
+  const uint8_t base = link_adapt::matchRung(7, 5, true);
+  LinkAdapter la(base, testSettings());
+  uint32_t now = 100;
+  feed(la, 10.0f, true, now);
+  assert(la.update(now));                              // первый анонс сразу
+  assert(la.localRung() == base);                      // выдержка после старта
+  assert(la.appliedRung() == base);
+
+  now = 1200;
+  feed(la, 10.0f, true, now);
+  assert(la.update(now));
+  assert(la.localRung() == base + 1);
+  assert(la.appliedRung() == base);                    // пир ещё не анонсировал
+  assert(!la.update(now + 10));                        // следующее повышение ждёт holdMs
+
+  la.onPeerAdvert(static_cast<uint8_t>(link_adapt::rungCount() - 1), now + 20);
+  la.update(now + 20);
+  assert(la.appliedRung() == base + 1);                // минимум из своей и чужой рекомендации
+  assert(la.samples() == 0);                           // статистика сброшена при смене профиля
+
+  la.onPeerAdvert(base, now + 30);
+  la.update(now + 30);
+  assert(la.appliedRung() == base);                    // пир слышит хуже — уступаем
+
+  // Без запаса на гистерезис повышения нет
+  LinkAdapter tight(base, testSettings());
+  const float edge = link_adapt::profile(base + 1).requiredSnrDb + 3.5f;
+  feed(tight, edge, true, 2000);
+  tight.update(2000);
+  assert(tight.localRung() == base);
+}
+
+// Падение SNR понижает ступень сразу, без выдержки
+static void testImmediateDowngrade() {
+  const uint8_t base = link_adapt::matchRung(7, 5, true);
+  LinkAdapter la(base, testSettings());
+  la.onPeerAdvert(base, 50);
+  feed(la, -12.0f, true, 100);
+  assert(la.update(100));
+  const uint8_t rung = la.localRung();
+  assert(rung < base);
+  assert(link_adapt::profile(rung).requiredSnrDb + 3.0f <= -12.0f);
+  assert(la.appliedRung() == std::min(rung, base));
+}
+
+// Потери при хорошем SNR: шаг вниз
+static void testPerStepDown() {
+  const uint8_t base = link_adapt::matchRung(7, 5, true);
+  LinkAdapter la(base, testSettings());
+  la.onPeerAdvert(base, 50);
+  feed(la, 10.0f, false, 100, 6);
+  assert(la.per() > 0.2f);
+  la.update(100);
+  assert(la.localRung() == base - 1);
+  assert(la.appliedRung() == base - 1);
+  assert(la.per() == 0.0f);
+
+  // Пропавшие ACK учитываются так же
+  LinkAdapter acks(base, testSettings());
+  acks.onPeerAdvert(base, 50);
+  feed(acks, 10.0f, true, 100);
+  for (int i = 0; i < 6; ++i) acks.onAckResult(false);
+  acks.update(100);
+  assert(acks.localRung() == base - 1);
+}
+
+// Тишина от пира на новом профиле возвращает обе стороны к базе
+static void testFallback() {
+  const uint8_t base = link_adapt::matchRung(7, 5, true);
+  LinkAdapter la(base, testSettings());
+  la.onPeerAdvert(base, 50);
+  feed(la, -12.0f, true, 100);
+  la.update(100);
+  assert(la.appliedRung() != base);
+  assert(!la.update(5000));
+  assert(la.update(100 + 10000));
+  assert(la.appliedRung() == base);
+  assert(la.localRung() == base);
+  assert(!la.peerSeen());
+}
+
+// Управляющий кадр
+static void testControlFrame() {
+  uint8_t frame[protocol::link::SIZE];
+  protocol::link::encodeControl(3, frame);
+  uint8_t rung = 0;
+  assert(protocol::link::decodeControl(frame, sizeof(frame), rung));
+  assert(rung == 3);
+  assert(!protocol::link::decodeControl(frame, sizeof(frame) - 1, rung));
+  frame[1] = protocol::link::VERSION + 1;
+  assert(!protocol::link::decodeControl(frame, sizeof(frame), rung));
+}
+
+int main() {
+  testLadder();
+  testConvergeAndUpgrade();
+  testImmediateDowngrade();
+  testPerStepDown();
+  testFallback();
+  testControlFrame();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <vector>
@@ -41,6 +42,57 @@ int main() {
   assert(zero_buf.pop(read_id, read_payload));
   assert(read_id == zero_id);
   assert(read_payload.size() == 1 && read_payload[0] == payload);
+
+  // Сообщения длиннее прежнего слота в 256 байт встают целиком, учёт байтов точный
+  MessageBuffer arena(4);                 // бюджет 4 * (256 + 4) байт
+  assert(arena.byteBudget() == 4 * (MessageBuffer::DEFAULT_SLOT_SIZE + MessageBuffer::RECORD_HEADER));
+  std::vector<uint8_t> big(700);
+  for (size_t i = 0; i < big.size(); ++i) big[i] = static_cast<uint8_t>(i * 3);
+  uint16_t big_id = arena.enqueue(big.data(), big.size());
+  assert(big_id != 0);
+  assert(arena.usedBytes() == big.size() + MessageBuffer::RECORD_HEADER);
+  std::vector<uint8_t> rest(arena.freeBytes() - MessageBuffer::RECORD_HEADER, 0x5A);
+  assert(arena.enqueue(rest.data(), rest.size() + 1) == 0); // на байт больше свободного
+  assert(arena.enqueue(rest.data(), rest.size()) != 0);     // ровно остаток бюджета
+  assert(arena.freeBytes() == 0);
+  MessageBuffer::View view;
+  assert(arena.peek(view) && view.id == big_id && view.len == big.size());
+  assert(std::equal(big.begin(), big.end(), view.data));    // данные читаются прямо из арены
+  assert(arena.discard() && arena.size() == 1);
+
+  // Кольцо: записи переносятся через край арены, порядок и откат сохраняются
+  MessageBuffer ring(8, 16);
+  uint8_t expected = 0;
+  uint8_t counter = 0;
+  auto push = [&](size_t len) {
+    std::vector<uint8_t> msg(len, counter);
+    if (ring.enqueue(msg.data(), msg.size()) == 0) return false;
+    ++counter;
+    return true;
+  };
+  for (int round = 0; round < 50; ++round) {
+    while (push(5 + round % 20)) {}       // заполняем до отказа записями разной длины
+    assert(ring.freeSlots() == 0 || ring.freeBytes() < MessageBuffer::RECORD_HEADER + 5 + round % 20);
+    if (round % 3 == 0) {
+      assert(ring.dropLast());            // откат последней записи возвращает её байты
+      --counter;
+    }
+    const size_t take = 1 + round % 4;
+    for (size_t i = 0; i < take && ring.hasPending(); ++i) {
+      uint16_t rid = 0;
+      std::vector<uint8_t> got;
+      assert(ring.pop(rid, got));
+      assert(!got.empty() && got.front() == expected && got.back() == expected);
+      ++expected;
+    }
+  }
+  size_t used = 0;
+  while (ring.peek(view)) {
+    assert(view.data[0] == expected++);
+    used += MessageBuffer::RECORD_HEADER + view.len;
+    ring.discard();
+  }
+  assert(used > 0 && expected == counter && ring.usedBytes() == 0);
   std::cout << "OK" << std::endl;
   return 0;
 }
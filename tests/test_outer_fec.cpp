@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+#include "libs/erasure/erasure_code.h"
+#define private public
+#include "tx_module.h"
+#undef private
+
+class NullRadio : public IRadio {
+public:
+  int16_t send(const uint8_t*, size_t) override { return ERR_NONE; }
+  void setReceiveCallback(RxCallback) override {}
+};
+
+static std::vector<uint8_t> makeMessage(size_t len) {
+  std::vector<uint8_t> msg(len);
+  for (size_t i = 0; i < len; ++i) msg[i] = static_cast<uint8_t>(i * 131 + (i >> 8));
+  return msg;
+}
+
+static std::vector<std::vector<uint8_t>> splitParts(const std::vector<uint8_t>& msg, size_t chunk) {
+  std::vector<std::vector<uint8_t>> parts;
+  for (size_t off = 0; off < msg.size(); off += chunk) {
+    const size_t n = std::min(chunk, msg.size() - off);
+    parts.emplace_back(msg.begin() + off, msg.begin() + off + n);
+  }
+  return parts;
+}
+
+// Любые K из K+R фрагментов восстанавливают сообщение, K-1 — нет
+static void testAnyK() {
+  const std::vector<uint8_t> msg = makeMessage(1000);
+  const auto parts = splitParts(msg, 96);             // 11 частей, последняя короче
+  const size_t k = parts.size();
+  const size_t r = erasure::repairCount(k, 40);
+  assert(r == 5);
+  std::vector<std::vector<uint8_t>> repair;
+  assert(erasure::buildRepair(parts, r, repair));
+  assert(repair.size() == r);
+  assert(repair[0].size() == erasure::LEN_PREFIX + 96);
+  std::vector<std::vector<uint8_t>> direct;           // те же символы прямо из буфера сообщения
+  assert(erasure::buildRepair(msg.data(), msg.size(), 96, r, direct));
+  assert(direct == repair);
+
+  // Теряем по r фрагментов в разных местах, включая последнюю исходную часть
+  const std::vector<std::vector<size_t>> losses = {
+      {0, 1, 2, 3, 4}, {10, 9, 5, 11, 15}, {2, 4, 6, 8, 10}, {11, 12, 13, 14, 15}, {0, 10, 12, 13, 3}};
+  for (const auto& lost : losses) {
+    erasure::Decoder dec;
+    dec.reset(static_cast<uint16_t>(k));
+    for (size_t idx = 0; idx < k + r; ++idx) {
+      if (std::find(lost.begin(), lost.end(), idx) != lost.end()) continue;
+      const auto& frag = idx < k ? parts[idx] : repair[idx - k];
+      assert(dec.add(static_cast<uint16_t>(idx), frag.data(), frag.size()));
+    }
+    assert(dec.complete());
+    std::vector<uint8_t> out;
+    assert(dec.decode(out));
+    assert(out == msg);
+  }
+
+  erasure::Decoder shortDec;
+  shortDec.reset(static_cast<uint16_t>(k));
+  for (size_t idx = 1; idx < k; ++idx) {
+    assert(shortDec.add(static_cast<uint16_t>(idx), parts[idx].data(), parts[idx].size()));
+  }
+  assert(!shortDec.add(1, parts[1].data(), parts[1].size())); // повтор не считается
+  assert(!shortDec.complete());
+  std::vector<uint8_t> out;
+  assert(!shortDec.decode(out));
+  assert(shortDec.add(static_cast<uint16_t>(k + 2), repair[2].data(), repair[2].size()));
+  assert(shortDec.decode(out));
+  assert(out == msg);
+
+  // Все исходные части без восстановительных — простая склейка
+  erasure::Decoder plain;
+  plain.reset(static_cast<uint16_t>(k));
+  for (size_t idx = 0; idx < k; ++idx) plain.add(static_cast<uint16_t>(idx), parts[idx].data(), parts[idx].size());
+  assert(plain.decode(out));
+  assert(out == msg);
+
+  assert(erasure::repairCount(250, 50) == 5);         // K + R не выходит за GF(256)
+  assert(erasure::repairCount(8, 0) == 0);
+}
+
+// TxModule: восстановительные фрагменты после исходных, frag_cnt = K, сборка из неполного набора
+static void testTxRepairFragments() {
+  NullRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{10, 10, 10, 10});
+  tx.setEncryptionEnabled(false);
+  fec::Profile profile;
+  profile.use_conv = false;
+  profile.use_rs = false;
+  profile.use_bit_interleaver = false;
+  tx.setFecOverride(profile);
+  tx.setOuterFec(25);
+  const std::vector<uint8_t> msg = makeMessage(1500);
+  TxModule::PendingMessage message;
+  message.id = 9;
+  message.data = msg;
+  assert(tx.ensureFragmentsReady(message));
+  const size_t k = message.frag_cnt;
+  assert(k >= DefaultSettings::OUTER_FEC_MIN_FRAGMENTS);
+  const size_t r = message.fragments.size() - k;
+  assert(r == erasure::repairCount(k, 25));
+  assert(tx.getRepairFragmentCount() == r);
+  for (size_t i = 0; i < message.fragments.size(); ++i) {
+    assert(message.fragments[i].chunk_idx == i);
+  }
+
+  erasure::Decoder dec;
+  dec.reset(static_cast<uint16_t>(k));
+  for (size_t i = r; i < message.fragments.size(); ++i) { // первые r исходных потеряны
+    const auto& frag = message.fragments[i];
+    assert(dec.add(frag.chunk_idx, frag.payload.data(), frag.plain_len));
+  }
+  std::vector<uint8_t> out;
+  assert(dec.decode(out));
+  assert(out == msg);
+
+  // Короткие сообщения и выключенный код идут без восстановительных фрагментов
+  TxModule::PendingMessage small;
+  small.id = 10;
+  small.data = makeMessage(200);
+  assert(tx.ensureFragmentsReady(small));
+  assert(small.frag_cnt == 0);
+  tx.setOuterFec(0);
+  TxModule::PendingMessage off;
+  off.id = 11;
+  off.data = msg;
+  assert(tx.ensureFragmentsReady(off));
+  assert(off.frag_cnt == 0);
+  assert(off.fragments.size() < message.fragments.size());
+}
+
+int main() {
+  testAnyK();
+  testTxRepairFragments();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
@@ -5,7 +5,8 @@
 #include <string>
 #include <vector>
 #include "message_buffer.h"
-#include "packetizer/packet_splitter.h"
+#include "libs/packetizer/packet_splitter.h"
+#include "libs/packetizer/fragment_cursor.h"
 
 // Проверка разделения данных на пакеты
 int main() {
@@ -45,6 +46,28 @@ int main() {
     assert(seen.size() == 3);
   }
 
+  // Курсор фрагментов выдаёт участки исходного буфера без копирования и префиксов
+  {
+    packetizer::FragmentCursor cursor(data.data(), data.size(), 32);
+    assert(cursor.count() == 4);
+    packetizer::Span span;
+    size_t covered = 0;
+    uint16_t expected_idx = 0;
+    while (cursor.next(span)) {
+      assert(span.index == expected_idx++);
+      assert(span.data == data.data() + covered); // указатель в исходное сообщение
+      assert(span.offset == covered);
+      covered += span.len;
+    }
+    assert(covered == data.size() && span.len == 4); // хвост 100 - 3*32
+    assert(!cursor.at(4, span));
+    assert(cursor.at(1, span) && span.data == data.data() + 32 && span.len == 32);
+    cursor.rewind();
+    assert(cursor.next(span) && span.index == 0);
+    packetizer::FragmentCursor empty(nullptr, 10, 32);
+    assert(empty.count() == 0 && !empty.next(span));
+  }
+
   std::cout << "OK" << std::endl;
   return 0;
 }
@@ -1,10 +1,13 @@
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
 #include <vector>
 #include <iostream>
 
 #include "radio_sx1262.h"
 #include "default_settings.h"
+#include "stubs/Arduino.h"
 
 // Доступ к внутреннему состоянию RadioSX1262 для модульных тестов
 class RadioSX1262TestAccessor {
@@ -12,21 +15,25 @@ public:
   static RadioSX1262::PublicSX1262& rawRadio(RadioSX1262& radio) { return radio.radio_; }
   static bool implicitEnabled(const RadioSX1262& radio) { return radio.implicitHeaderEnabled_; }
   static size_t implicitLength(const RadioSX1262& radio) { return radio.implicitHeaderLength_; }
+  static void dio1(RadioSX1262& radio) { radio.handleDio1(); }
   static void forceImplicit(RadioSX1262& radio, bool enabled, size_t len) {
     radio.implicitHeaderEnabled_ = enabled;
     radio.implicitHeaderLength_ = len;
   }
 };
 
-static void resetStub(RadioSX1262::PublicSX1262& raw) {
+static void resetStub(SX1262& raw) {
   raw.transmitCalls = 0;
+  raw.startTransmitCalls = 0;
+  raw.setFrequencyCalls = 0;
+  raw.startReceiveCalls = 0;
   raw.transmitLengthHistory.clear();
   raw.transmitPayloadHistory.clear();
   raw.implicitHeaderCalls = 0;
   raw.explicitHeaderCalls = 0;
 }
 
-// Проверяем, что данные разбиваются на несколько implicit-фрагментов
+// Проверяем, что данные разбиваются на несколько implicit-пакетов с маркерами
 static void testImplicitFragmentation() {
   RadioSX1262 radio;
   auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
@@ -35,13 +42,14 @@ static void testImplicitFragmentation() {
   raw.transmitResult = RADIOLIB_ERR_NONE;
 
   assert(radio.begin());
+  RadioSX1262TestAccessor::forceImplicit(radio, true, 32); // имитируем implicit-режим длиной 32 байта
   assert(RadioSX1262TestAccessor::implicitEnabled(radio));
   const size_t implicitLen = RadioSX1262TestAccessor::implicitLength(radio);
-  assert(implicitLen > 0);
+  const size_t chunk = subpacket::chunkPayload(implicitLen); // данные одного пакета без маркера
 
   resetStub(raw);
 
-  const size_t payloadSize = implicitLen * 2 + implicitLen / 2; // три фрагмента: 32,32,16 (при implicitLen=32)
+  const size_t payloadSize = chunk * 2 + chunk / 2; // три пакета: 31, 31 и хвост 15 байт
   std::vector<uint8_t> payload(payloadSize);
   for (size_t i = 0; i < payload.size(); ++i) {
     payload[i] = static_cast<uint8_t>(i & 0xFFU);
@@ -58,23 +66,26 @@ static void testImplicitFragmentation() {
 
   const auto& first = raw.transmitPayloadHistory[0];
   assert(first.size() == implicitLen);
-  for (size_t i = 0; i < implicitLen; ++i) {
-    assert(first[i] == payload[i]);
+  assert(first[0] == 0x00);                                // пакет 0, не последний
+  for (size_t i = 0; i < chunk; ++i) {
+    assert(first[1 + i] == payload[i]);
   }
 
   const auto& second = raw.transmitPayloadHistory[1];
-  assert(second.size() == implicitLen);
-  for (size_t i = 0; i < implicitLen; ++i) {
-    assert(second[i] == payload[implicitLen + i]);
+  assert(second[0] == 0x01);
+  for (size_t i = 0; i < chunk; ++i) {
+    assert(second[1 + i] == payload[chunk + i]);
   }
 
   const auto& third = raw.transmitPayloadHistory[2];
   assert(third.size() == implicitLen);
-  const size_t remainder = payloadSize - 2 * implicitLen;
+  const size_t remainder = payloadSize - 2 * chunk;
+  assert(third[0] == (subpacket::LAST_BIT | subpacket::PAD_BIT | 2));
+  assert(third[1] == remainder);                           // длина данных хвоста
   for (size_t i = 0; i < remainder; ++i) {
-    assert(third[i] == payload[2 * implicitLen + i]);
+    assert(third[2 + i] == payload[2 * chunk + i]);
   }
-  for (size_t i = remainder; i < implicitLen; ++i) {
+  for (size_t i = 2 + remainder; i < implicitLen; ++i) {
     assert(third[i] == 0U); // оставшиеся байты должны быть обнулены
   }
 
@@ -82,7 +93,7 @@ static void testImplicitFragmentation() {
   assert(raw.explicitHeaderCalls == 0);
 }
 
-// Проверяем фрагментацию в явном режиме (explicit header)
+// Проверяем нарезку в явном режиме (explicit header)
 static void testExplicitFragmentation() {
   RadioSX1262 radio;
   auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
@@ -96,7 +107,8 @@ static void testExplicitFragmentation() {
   resetStub(raw);
 
   constexpr size_t kMaxPacketSize = 245; // лимит SX1262
-  const size_t payloadSize = kMaxPacketSize + 17; // гарантированно больше одного кадра
+  constexpr size_t kChunk = kMaxPacketSize - subpacket::OVERHEAD;
+  const size_t payloadSize = kChunk + 17; // гарантированно больше одного пакета
   std::vector<uint8_t> payload(payloadSize);
   for (size_t i = 0; i < payload.size(); ++i) {
     payload[i] = static_cast<uint8_t>((i * 3) & 0xFFU);
@@ -108,21 +120,213 @@ static void testExplicitFragmentation() {
   assert(raw.transmitLengthHistory.size() == 2);
   assert(raw.transmitPayloadHistory.size() == 2);
   assert(raw.transmitLengthHistory[0] == kMaxPacketSize);
-  assert(raw.transmitLengthHistory[1] == 17);
+  assert(raw.transmitLengthHistory[1] == 17 + subpacket::OVERHEAD);
 
   const auto& tail = raw.transmitPayloadHistory[1];
-  assert(tail.size() == 17);
-  for (size_t i = 0; i < tail.size(); ++i) {
-    assert(tail[i] == payload[kMaxPacketSize + i]);
+  assert(tail[0] == (subpacket::LAST_BIT | 1));            // без заполнителя: длина пакета точная
+  for (size_t i = 0; i < 17; ++i) {
+    assert(tail[1 + i] == payload[kChunk + i]);
   }
 
   assert(raw.implicitHeaderCalls == 0);
   assert(raw.explicitHeaderCalls == 0);
 }
 
+// Серия кадров: одна перестройка на TX и один запуск приёма на всю серию
+static void testBurst() {
+  RadioSX1262 radio;
+  auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
+  assert(radio.begin());
+  RadioSX1262TestAccessor::forceImplicit(radio, true, 32);
+  const size_t implicitLen = RadioSX1262TestAccessor::implicitLength(radio);
+  assert(implicitLen > 0);
+
+  resetStub(raw);
+  const size_t chunk = subpacket::chunkPayload(implicitLen);
+  std::vector<uint8_t> a(chunk + 3, 0x11);                // два implicit-пакета
+  std::vector<uint8_t> b(chunk, 0x22);                    // один пакет
+  std::vector<uint8_t> c(5, 0x33);
+  const IRadio::Frame frames[] = {{a.data(), a.size()}, {b.data(), b.size()}, {c.data(), c.size()}};
+  size_t sent = 0;
+  assert(radio.sendBurst(frames, 3, sent) == RADIOLIB_ERR_NONE);
+  assert(sent == 3);
+  assert(raw.startTransmitCalls == 4);
+  assert(raw.setFrequencyCalls == 2);                     // TX в начале и RX в конце
+  assert(std::fabs(raw.lastSetFrequency - radio.getRxFrequency()) < 1e-3f);
+  assert(raw.startReceiveCalls == 1);
+  // Метка чередуется между кадрами серии, нумерация пакетов начинается заново
+  assert((raw.transmitPayloadHistory[0][0] & subpacket::TAG_BIT) == 0);
+  assert(raw.transmitPayloadHistory[2][0] == (subpacket::TAG_BIT | subpacket::LAST_BIT));
+  assert(raw.transmitPayloadHistory[2][1] == 0x22);
+  assert((raw.transmitPayloadHistory[3][0] & (subpacket::TAG_BIT | subpacket::SEQ_MASK)) == 0);
+
+  // Ошибка в серии: возвращается код RadioLib, радио возвращается в RX
+  resetStub(raw);
+  raw.transmitResult = -7;
+  assert(radio.sendBurst(frames, 3, sent) == -7);
+  assert(sent == 0);
+  assert(raw.startReceiveCalls == 1);
+  raw.transmitResult = RADIOLIB_ERR_NONE;
+
+  // Пустой кадр в серии отклоняется без обращения к радио
+  resetStub(raw);
+  const IRadio::Frame bad[] = {{a.data(), a.size()}, {nullptr, 0}};
+  assert(radio.sendBurst(bad, 2, sent) != RADIOLIB_ERR_NONE);
+  assert(raw.startTransmitCalls == 0);
+
+  // Кадр длиннее MAX_CHUNKS пакетов не передаётся
+  std::vector<uint8_t> huge(chunk * subpacket::MAX_CHUNKS + 1, 0x44);
+  assert(radio.send(huge.data(), huge.size()) != RADIOLIB_ERR_NONE);
+  assert(raw.startTransmitCalls == 0);
+}
+
+// Доставка пакета через DIO1 и loop(), как при реальном приёме
+static void receivePacket(RadioSX1262& radio, const std::vector<uint8_t>& packet) {
+  auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
+  std::copy(packet.begin(), packet.end(), raw.testReadBuffer.begin());
+  raw.testReadBufferSize = packet.size();
+  raw.testPacketLength = packet.size();
+  raw.testIrqFlags = RADIOLIB_SX126X_IRQ_RX_DONE;
+  RadioSX1262TestAccessor::dio1(radio);
+  radio.loop();
+}
+
+// Сборка кадра на приёме: целый кадр, потеря среднего пакета и тайм-аут без последнего
+static void testReassembly() {
+  RadioSX1262 tx;
+  auto& txRaw = RadioSX1262TestAccessor::rawRadio(tx);
+  assert(tx.begin());
+  RadioSX1262TestAccessor::forceImplicit(tx, true, 32);
+  RadioSX1262 rx;
+  assert(rx.begin());
+  RadioSX1262TestAccessor::forceImplicit(rx, true, 32);
+
+  std::vector<std::vector<uint8_t>> frames;
+  std::vector<subpacket::FrameInfo> infos;
+  rx.setReceiveFrameCallback([&](const uint8_t* d, size_t l, const subpacket::FrameInfo& info) {
+    frames.emplace_back(d, d + l);
+    infos.push_back(info);
+  });
+
+  std::vector<uint8_t> payload(80);
+  for (size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<uint8_t>(i + 1);
+  resetStub(txRaw);
+  assert(tx.send(payload.data(), payload.size()) == RADIOLIB_ERR_NONE);
+  const auto packets = txRaw.transmitPayloadHistory;       // 31 + 31 + 18 байт
+  assert(packets.size() == 3);
+
+  for (const auto& p : packets) receivePacket(rx, p);
+  assert(frames.size() == 1);
+  assert(frames[0] == payload);                            // заполнитель хвоста отброшен
+  assert(infos[0].complete);
+  assert(infos[0].chunks == 3);
+  assert(infos[0].paddedMask == 0x4);
+
+  // Потерян средний пакет: кадр приходит целиком по длине, дыра отмечена в карте
+  receivePacket(rx, packets[0]);
+  receivePacket(rx, packets[2]);
+  assert(frames.size() == 2);
+  assert(!infos[1].complete);
+  assert(infos[1].lastReceived);
+  assert(infos[1].missingMask == 0x2);
+  assert(frames[1].size() == payload.size());
+  assert(frames[1][31] == 0 && frames[1][61] == 0);        // стёртый пакет заполнен нулями
+  assert(frames[1][62] == payload[62]);
+  assert(rx.getPartialFrames() == 1);
+
+  // Последний пакет не пришёл — кадр отдаётся по тайм-ауту
+  ArduinoStub::gMillis = 1000;
+  receivePacket(rx, packets[0]);
+  rx.loop();
+  assert(frames.size() == 2);
+  ArduinoStub::gMillis += 60000;
+  rx.loop();
+  assert(frames.size() == 3);
+  assert(!infos[2].lastReceived);
+  assert(frames[2].size() == subpacket::chunkPayload(32));
+
+  // Без колбэка кадров обычный колбэк получает только целые кадры
+  RadioSX1262 plain;
+  assert(plain.begin());
+  size_t delivered = 0;
+  plain.setReceiveCallback([&](const uint8_t*, size_t l) { delivered = l; });
+  std::vector<uint8_t> single = {subpacket::LAST_BIT, 'h', 'i'};
+  receivePacket(plain, single);
+  assert(delivered == 2);
+}
+
+// Автоматический выбор заголовка: при настройках по умолчанию выгоднее explicit,
+// и кадр максимальной длины уходит одним пакетом вместо восьми implicit-пакетов
+static void testHeaderModeSelection() {
+  RadioSX1262 radio;
+  auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
+  raw.implicitHeaderCalls = 0;
+  raw.explicitHeaderCalls = 0;
+  assert(radio.begin());
+  assert(!radio.isImplicitHeader());
+  assert(radio.getImplicitLength() == 0);
+  assert(raw.explicitHeaderCalls >= 1);
+
+  resetStub(raw);
+  std::vector<uint8_t> payload(244, 0x5A);                // максимум данных одного пакета с маркером
+  assert(radio.send(payload.data(), payload.size()) == RADIOLIB_ERR_NONE);
+  assert(raw.transmitCalls == 1);
+  assert(raw.transmitLengthHistory[0] == 245);
+
+  // Время в эфире explicit-кадра меньше, чем у той же нагрузки в 32-байтных implicit-пакетах
+  const uint32_t explicitUs = radio.airtimeUs(244);
+  RadioSX1262TestAccessor::forceImplicit(radio, true, 32);
+  assert(explicitUs < radio.airtimeUs(244));
+  RadioSX1262TestAccessor::forceImplicit(radio, false, 0);
+
+  // Смена SF пересчитывает режим, но не трогает радио, если он не изменился
+  resetStub(raw);
+  assert(radio.setSpreadingFactor(9));
+  assert(raw.implicitHeaderCalls == 0);
+  assert(raw.explicitHeaderCalls == 0);
+  assert(!radio.isImplicitHeader());
+}
+
+// Приём перезапускается сразу после чтения FIFO, до колбэков; пакет, пришедший во время
+// обработки предыдущего кадра, забирается в кольцо и собирается без потерь
+static void testRxRearmBeforeProcessing() {
+  RadioSX1262 rx;
+  auto& raw = RadioSX1262TestAccessor::rawRadio(rx);
+  assert(rx.begin());
+  std::vector<std::vector<uint8_t>> frames;
+  size_t rxCallsInCallback = 0;
+  bool injected = false;
+  const std::vector<uint8_t> second = {subpacket::TAG_BIT | subpacket::LAST_BIT, 'B'};
+  rx.setReceiveCallback([&](const uint8_t* d, size_t l) {
+    frames.emplace_back(d, d + l);
+    if (!injected) {
+      injected = true;
+      rxCallsInCallback = raw.startReceiveCalls;
+      // Следующий пакет приходит, пока пользователь обрабатывает первый кадр
+      std::copy(second.begin(), second.end(), raw.testReadBuffer.begin());
+      raw.testReadBufferSize = second.size();
+      raw.testPacketLength = second.size();
+      raw.testIrqFlags = RADIOLIB_SX126X_IRQ_RX_DONE;
+      RadioSX1262TestAccessor::dio1(rx);
+    }
+  });
+  raw.startReceiveCalls = 0;
+  receivePacket(rx, {subpacket::LAST_BIT, 'A'});
+  assert(rxCallsInCallback == 1);                          // RX уже перезапущен до колбэка
+  assert(frames.size() == 2);                              // второй пакет прочитан в том же loop()
+  assert(frames[0] == std::vector<uint8_t>{'A'});
+  assert(frames[1] == std::vector<uint8_t>{'B'});
+  assert(raw.startReceiveCalls == 2);
+  assert(rx.getRxRingOverflows() == 0);
+}
+
 int main() {
   testImplicitFragmentation();
   testExplicitFragmentation();
+  testBurst();
+  testHeaderModeSelection();
+  testReassembly();
+  testRxRearmBeforeProcessing();
   std::cout << "OK" << std::endl;
   return 0;
 }
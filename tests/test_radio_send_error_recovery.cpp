@@ -52,7 +52,7 @@ int main() {
   const size_t expectedTxLen = RadioSX1262TestAccessor::implicitEnabled(radio) &&
                                       RadioSX1262TestAccessor::implicitLength(radio) > 0
                                   ? RadioSX1262TestAccessor::implicitLength(radio)
-                                  : sizeof(payload);
+                                  : sizeof(payload) + subpacket::OVERHEAD; // маркер пакета
   assert(raw.lastTransmitLength == expectedTxLen);
 
   std::cout << "OK" << std::endl;
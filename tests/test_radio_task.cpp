@@ -0,0 +1,142 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "radio_sx1262.h"
+#include "libs/lockfree/mpsc_queue.h"
+#include "stubs/Arduino.h"
+
+// Доступ к внутреннему SX1262 и обработчику DIO1
+class RadioSX1262TestAccessor {
+public:
+  static RadioSX1262::PublicSX1262& rawRadio(RadioSX1262& radio) { return radio.radio_; }
+  static void dio1(RadioSX1262& radio) { radio.handleDio1(); }
+  static void forceImplicit(RadioSX1262& radio, size_t len) {
+    radio.implicitHeaderEnabled_ = true;
+    radio.implicitHeaderLength_ = len;
+  }
+};
+
+// Ожидание условия, которое выполняет задача-владелец радио
+template <typename Pred>
+static bool waitFor(Pred pred) {
+  for (int i = 0; i < 2000; ++i) {
+    if (pred()) return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return pred();
+}
+
+static void testQueue() {
+  lockfree::MpscQueue<int, 4> queue;
+  int value = 0;
+  assert(queue.empty());
+  assert(!queue.tryPop(value));
+  for (int i = 1; i <= 4; ++i) assert(queue.tryPush(i));
+  assert(!queue.tryPush(5));                           // ёмкость фиксирована
+  assert(queue.tryPop(value) && value == 1);
+  assert(queue.tryPush(5));                            // освобождённая ячейка доступна на следующем круге
+  for (int expected = 2; expected <= 5; ++expected) {
+    assert(queue.tryPop(value) && value == expected);
+  }
+  assert(queue.empty());
+
+  // Несколько производителей: каждый элемент доставляется ровно один раз
+  lockfree::MpscQueue<uint32_t, 64> shared;
+  constexpr uint32_t kPerThread = 5000;
+  std::vector<std::thread> producers;
+  for (uint32_t t = 0; t < 3; ++t) {
+    producers.emplace_back([&shared, t]() {
+      for (uint32_t i = 0; i < kPerThread; ++i) {
+        while (!shared.tryPush(t * kPerThread + i)) std::this_thread::yield();
+      }
+    });
+  }
+  std::vector<bool> seen(3 * kPerThread, false);
+  std::vector<uint32_t> lastPerThread(3, 0);
+  size_t received = 0;
+  while (received < seen.size()) {
+    uint32_t item = 0;
+    if (!shared.tryPop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    assert(!seen[item]);
+    seen[item] = true;
+    const uint32_t producer = item / kPerThread;
+    assert(item % kPerThread >= lastPerThread[producer]); // порядок одного производителя сохраняется
+    lastPerThread[producer] = item % kPerThread;
+    ++received;
+  }
+  for (auto& p : producers) p.join();
+  assert(shared.empty());
+}
+
+static void testOwnerTask() {
+  RadioSX1262 radio;
+  auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
+  assert(radio.begin());
+  RadioSX1262TestAccessor::forceImplicit(radio, 32);
+  ArduinoStub::gMillis = 1000;
+  assert(radio.startTask());
+  assert(radio.isTaskRunning());
+
+  // Настройка выполняется в задаче-владельце, результат возвращается вызывающему
+  assert(radio.setChannel(1));
+  assert(radio.getChannel() == 1);
+  assert(!radio.setChannel(250));
+
+  // Серию продвигает задача по DIO1, вызывающий только забирает итог без обращения к SX1262
+  raw.startTransmitCalls = 0;
+  std::vector<uint8_t> payload(80, 0x5A);
+  const IRadio::Frame frame{payload.data(), payload.size()};
+  size_t sent = 0;
+  assert(radio.startSendBurst(&frame, 1, sent) == IRadio::ERR_PENDING);
+  assert(radio.pollSend(sent) == IRadio::ERR_PENDING);
+  assert(radio.startSendBurst(&frame, 1, sent) == IRadio::ERR_TIMEOUT); // занятость видит владелец
+  for (size_t chunk = 1; chunk <= 3; ++chunk) {
+    assert(waitFor([&]() { return raw.startTransmitCalls == chunk; }));
+    RadioSX1262TestAccessor::dio1(radio);
+  }
+  assert(waitFor([&]() { return !radio.isTransmitting(); }));
+  assert(radio.pollSend(sent) == RADIOLIB_ERR_NONE);
+  assert(sent == 1);
+
+  // Приём: владелец читает FIFO и перезапускает RX сам, loop() лишь разбирает кольцо
+  std::vector<std::vector<uint8_t>> frames;
+  radio.setReceiveCallback([&](const uint8_t* data, size_t len) { frames.emplace_back(data, data + len); });
+  const uint8_t packet[] = {subpacket::LAST_BIT, 0x11, 0x22, 0x33};
+  std::copy(packet, packet + sizeof(packet), raw.testReadBuffer.begin());
+  raw.testReadBufferSize = sizeof(packet);
+  raw.testPacketLength = sizeof(packet);
+  raw.testIrqFlags = RADIOLIB_SX126X_IRQ_RX_DONE;
+  const size_t rxBefore = raw.startReceiveCalls;
+  RadioSX1262TestAccessor::dio1(radio);
+  assert(waitFor([&]() { return raw.startReceiveCalls > rxBefore; }));
+  assert(frames.empty());                              // колбэки вызываются только из loop()
+  radio.loop();
+  assert(frames.size() == 1);
+  assert((frames[0] == std::vector<uint8_t>{0x11, 0x22, 0x33}));
+
+  // Блокирующая отправка из другого контекста дожидается завершения серии
+  raw.testIrqFlags = 0;
+  const uint8_t small[] = {1, 2, 3, 4};
+  std::thread sender([&]() { assert(radio.send(small, sizeof(small)) == RADIOLIB_ERR_NONE); });
+  assert(waitFor([&]() { return radio.isTransmitting(); }));
+  RadioSX1262TestAccessor::dio1(radio);
+  sender.join();
+
+  radio.stopTask();
+  assert(!radio.isTaskRunning());
+  assert(radio.setChannel(2));                         // без задачи вызовы снова выполняются напрямую
+}
+
+int main() {
+  testQueue();
+  testOwnerTask();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
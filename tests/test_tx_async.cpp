@@ -0,0 +1,146 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "tx_module.h"
+#include "radio_sx1262.h"
+#include "stubs/Arduino.h"
+
+// Заглушка асинхронного радио: передача завершается по команде теста
+class AsyncRadio : public IRadio {
+public:
+  std::vector<std::vector<uint8_t>> history;
+  bool busy = false;
+  int16_t result = ERR_NONE;
+  size_t frames = 0;
+  size_t ensureCalls = 0;
+  int16_t send(const uint8_t* data, size_t len) override {
+    history.emplace_back(data, data + len);
+    return ERR_NONE;
+  }
+  void setReceiveCallback(RxCallback) override {}
+  int16_t ensureReceiveMode() override { ++ensureCalls; return ERR_NONE; }
+  int16_t startSendBurst(const Frame* f, size_t count, size_t& sent) override {
+    sent = 0;
+    for (size_t i = 0; i < count; ++i) history.emplace_back(f[i].data, f[i].data + f[i].len);
+    frames = count;
+    busy = true;
+    return ERR_PENDING;
+  }
+  int16_t pollSend(size_t& sent) override {
+    sent = busy ? 0 : (result == ERR_NONE ? frames : 0);
+    return busy ? ERR_PENDING : result;
+  }
+};
+
+// Доступ к внутреннему SX1262 и обработчику DIO1
+class RadioSX1262TestAccessor {
+public:
+  static RadioSX1262::PublicSX1262& rawRadio(RadioSX1262& radio) { return radio.radio_; }
+  static void dio1(RadioSX1262& radio) { radio.handleDio1(); }
+  static void forceImplicit(RadioSX1262& radio, size_t len) {
+    radio.implicitHeaderEnabled_ = true;
+    radio.implicitHeaderLength_ = len;
+  }
+};
+
+static void testTxModuleAsync() {
+  AsyncRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{4, 4, 4, 4});
+  tx.setSendPause(0);
+  tx.setAirtimePacing(false);
+  const uint8_t a[] = {1, 2, 3};
+  const uint8_t b[] = {4, 5, 6};
+  assert(tx.queue(a, sizeof(a)) != 0);
+  assert(tx.queue(b, sizeof(b)) != 0);
+
+  // Запуск передачи не блокирует цикл, пока кадр в эфире
+  assert(!tx.loop());
+  assert(tx.isSending());
+  assert(radio.history.size() == 1);
+  assert(!tx.loop());
+  assert(!tx.loop());
+  assert(radio.history.size() == 1);                   // следующий кадр ждёт окончания передачи
+
+  // Завершение фиксируется при опросе, затем уходит следующее сообщение
+  radio.busy = false;
+  assert(tx.loop());
+  assert(!tx.isSending());
+  assert(!tx.loop());
+  assert(radio.history.size() == 2);
+
+  // Ошибка передачи оставляет сообщение в очереди для повтора
+  radio.result = -5;
+  radio.busy = false;
+  assert(!tx.loop());
+  radio.result = IRadio::ERR_NONE;
+  assert(!tx.loop());
+  assert(radio.history.size() == 3);
+  assert(radio.history[2] == radio.history[1]);
+  radio.busy = false;
+  tx.waitForSendCompletion();
+  assert(!tx.isSending());
+  assert(!tx.loop());                                  // очередь пуста
+}
+
+static void testRadioAsync() {
+  RadioSX1262 radio;
+  auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
+  assert(radio.begin());
+  RadioSX1262TestAccessor::forceImplicit(radio, 32);
+  ArduinoStub::gMillis = 1000;
+  raw.startTransmitCalls = 0;
+  raw.startReceiveCalls = 0;
+
+  // Три implicit-фрагмента: send не ждёт окончания, каждый TX_DONE запускает следующий
+  std::vector<uint8_t> payload(80, 0x42);
+  const IRadio::Frame frame{payload.data(), payload.size()};
+  size_t sent = 0;
+  assert(radio.startSendBurst(&frame, 1, sent) == IRadio::ERR_PENDING);
+  assert(radio.isTransmitting());
+  assert(raw.startTransmitCalls == 1);
+  assert(radio.pollSend(sent) == IRadio::ERR_PENDING);
+  assert(raw.startTransmitCalls == 1);                 // без DIO1 до истечения времени в эфире ждём
+  assert(radio.ensureReceiveMode() == RADIOLIB_ERR_NONE);
+  assert(raw.startReceiveCalls == 0);                  // приём не прерывает передачу
+  assert(radio.startSendBurst(&frame, 1, sent) == IRadio::ERR_TIMEOUT);
+
+  RadioSX1262TestAccessor::dio1(radio);
+  radio.loop();                                        // основной цикл продвигает серию
+  assert(raw.startTransmitCalls == 2);
+  RadioSX1262TestAccessor::dio1(radio);
+  assert(radio.pollSend(sent) == IRadio::ERR_PENDING);
+  assert(raw.startTransmitCalls == 3);
+  RadioSX1262TestAccessor::dio1(radio);
+  assert(radio.pollSend(sent) == RADIOLIB_ERR_NONE);
+  assert(sent == 1);
+  assert(!radio.isTransmitting());
+  assert(raw.startReceiveCalls == 1);
+
+  // Пропущенный DIO1: после расчётного времени в эфире TX_DONE читается из регистра
+  raw.testIrqFlags = 0;
+  assert(radio.startSendBurst(&frame, 1, sent) == IRadio::ERR_PENDING);
+  ArduinoStub::gMillis += 5000;
+  while (radio.pollSend(sent) == IRadio::ERR_PENDING) {
+    ArduinoStub::gMillis += 5000;
+  }
+  assert(sent == 1);
+
+  // TX_DONE так и не пришёл — тайм-аут и возврат в приём
+  const size_t rxBefore = raw.startReceiveCalls;
+  const IRadio::Frame shortFrame{payload.data(), 4};
+  assert(radio.startSendBurst(&shortFrame, 1, sent) == IRadio::ERR_PENDING);
+  raw.testIrqFlags = 0;
+  ArduinoStub::gMillis += 60000;
+  assert(radio.pollSend(sent) == RADIOLIB_ERR_TX_TIMEOUT);
+  assert(sent == 0);
+  assert(raw.startReceiveCalls == rxBefore + 1);
+}
+
+int main() {
+  testTxModuleAsync();
+  testRadioAsync();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
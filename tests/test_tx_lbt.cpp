@@ -0,0 +1,140 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "tx_module.h"
+#include "radio_sx1262.h"
+#include "stubs/Arduino.h"
+
+// Заглушка радио с управляемыми результатами CAD
+class CadRadio : public IRadio {
+public:
+  std::vector<std::vector<uint8_t>> history;
+  std::deque<ChannelState> results;                    // ответы pollChannelScan() по порядку
+  size_t scans = 0;
+  int16_t send(const uint8_t* data, size_t len) override {
+    history.emplace_back(data, data + len);
+    return ERR_NONE;
+  }
+  void setReceiveCallback(RxCallback) override {}
+  uint32_t airtimeUs(size_t) const override { return 2000; }
+  bool supportsChannelScan() const override { return true; }
+  int16_t startChannelScan() override { ++scans; return ERR_NONE; }
+  ChannelState pollChannelScan() override {
+    if (results.empty()) return ChannelState::CLEAR;
+    ChannelState st = results.front();
+    results.pop_front();
+    return st;
+  }
+};
+
+// Доступ к внутреннему SX1262 и обработчику DIO1
+class RadioSX1262TestAccessor {
+public:
+  static RadioSX1262::PublicSX1262& rawRadio(RadioSX1262& radio) { return radio.radio_; }
+  static void dio1(RadioSX1262& radio) { radio.handleDio1(); }
+};
+
+static void testTxModuleLbt() {
+  CadRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{4, 4, 4, 4});
+  tx.setSendPause(370);
+  tx.setAirtimePacing(false);
+  assert(tx.isListenBeforeTalkEnabled());
+  assert(tx.getEffectivePause() == 0);                 // слепую паузу заменяет CAD
+
+  const uint8_t a[] = {1, 2, 3};
+  const uint8_t b[] = {4, 5, 6};
+  assert(tx.queue(a, sizeof(a)) != 0);
+  assert(tx.queue(b, sizeof(b)) != 0);
+
+  // Пока CAD идёт, кадр ждёт и не считается проваленным
+  radio.results = {ChannelState::PENDING, ChannelState::CLEAR};
+  assert(!tx.loop());
+  assert(radio.history.empty());
+  assert(radio.scans == 1);
+  assert(tx.loop());
+  assert(radio.history.size() == 1);
+  assert(radio.scans == 1);
+  assert(tx.getLbtClearCount() == 1);
+  assert(tx.getEffectivePause() == DefaultSettings::RX_TURNAROUND_MS + 2);
+
+  // Занятый канал: случайная отсрочка без повторного CAD до её окончания
+  std::this_thread::sleep_for(std::chrono::milliseconds(DefaultSettings::RX_TURNAROUND_MS + 10));
+  radio.results = {ChannelState::BUSY, ChannelState::CLEAR};
+  assert(!tx.loop());
+  assert(tx.getLbtBusyCount() == 1);
+  assert(!tx.loop());
+  assert(radio.scans == 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(DefaultSettings::LBT_BACKOFF_MIN_MS * 2 + 10));
+  assert(tx.loop());
+  assert(radio.scans == 3);
+  assert(radio.history.size() == 2);
+
+  // Радио без ответа CAD не задерживает кадр
+  std::this_thread::sleep_for(std::chrono::milliseconds(DefaultSettings::RX_TURNAROUND_MS + 10));
+  radio.results = {ChannelState::UNSUPPORTED};
+  assert(tx.queue(a, sizeof(a)) != 0);
+  assert(tx.loop());
+  assert(radio.history.size() == 3);
+
+  // Без LBT возвращается фиксированная пауза и CAD не запускается
+  tx.setListenBeforeTalk(false);
+  assert(tx.getEffectivePause() == 370);
+  const size_t scans = radio.scans;
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  assert(tx.queue(b, sizeof(b)) != 0);
+  assert(tx.loop());
+  assert(radio.scans == scans);
+}
+
+static void testRadioCad() {
+  RadioSX1262 radio;
+  auto& raw = RadioSX1262TestAccessor::rawRadio(radio);
+  assert(radio.begin());
+  assert(radio.supportsChannelScan());
+  ArduinoStub::gMillis = 1000;
+
+  // CAD_DONE вместе с CAD_DETECTED — канал занят, приём перезапускается
+  assert(radio.startChannelScan() == RADIOLIB_ERR_NONE);
+  assert(raw.startChannelScanCalls == 1);
+  assert(radio.pollChannelScan() == ChannelState::PENDING);
+  size_t rxCalls = raw.startReceiveCalls;
+  raw.testIrqFlags = RADIOLIB_SX126X_IRQ_CAD_DONE | RADIOLIB_SX126X_IRQ_CAD_DETECTED;
+  RadioSX1262TestAccessor::dio1(radio);
+  assert(radio.pollChannelScan() == ChannelState::BUSY);
+  assert(raw.startReceiveCalls == rxCalls + 1);
+  assert(radio.pollChannelScan() == ChannelState::UNSUPPORTED); // повторный опрос без запуска
+
+  // Только CAD_DONE — канал свободен
+  assert(radio.startChannelScan() == RADIOLIB_ERR_NONE);
+  raw.testIrqFlags = RADIOLIB_SX126X_IRQ_CAD_DONE;
+  RadioSX1262TestAccessor::dio1(radio);
+  assert(radio.pollChannelScan() == ChannelState::CLEAR);
+
+  // Без CAD_DONE проверка завершается по тайм-ауту
+  assert(radio.startChannelScan() == RADIOLIB_ERR_NONE);
+  raw.testIrqFlags = 0;
+  rxCalls = raw.startReceiveCalls;
+  assert(radio.ensureReceiveMode() == RADIOLIB_ERR_NONE);
+  assert(raw.startReceiveCalls == rxCalls);            // приём не сбивает идущий CAD
+  ArduinoStub::gMillis += 5000;
+  assert(radio.pollChannelScan() == ChannelState::UNSUPPORTED);
+  assert(raw.startReceiveCalls == rxCalls + 1);
+
+  // Ошибка запуска возвращается вызывающему коду
+  raw.startChannelScanState = -5;
+  assert(radio.startChannelScan() == -5);
+  assert(radio.pollChannelScan() == ChannelState::UNSUPPORTED);
+}
+
+int main() {
+  testTxModuleLbt();
+  testRadioCad();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
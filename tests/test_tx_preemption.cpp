@@ -0,0 +1,94 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "tx_module.h"
+#include "libs/frame/frame_header.h"
+#include "libs/scrambler/scrambler.h"
+
+// Заглушка радио: запоминает все отправленные кадры
+class MockRadio : public IRadio {
+public:
+  std::vector<std::vector<uint8_t>> history;
+  int16_t send(const uint8_t* data, size_t len) override {
+    history.emplace_back(data, data + len);
+    return ERR_NONE;
+  }
+  void setReceiveCallback(RxCallback) override {}
+};
+
+// Доступ к внутреннему состоянию TxModule: переводим сообщение в кодированный режим
+class TxModuleTestAccessor {
+public:
+  static void makeCoded(TxModule& tx, uint8_t qos, uint16_t id) {
+    tx.plain_messages_.erase(TxModule::queueKey(qos, id));
+  }
+  static bool hasParked(const TxModule& tx, uint8_t qos) { return static_cast<bool>(tx.parked_[qos]); }
+};
+
+// Разбор заголовка кодированного кадра
+static bool decodeHeader(const std::vector<uint8_t>& raw, FrameHeader& hdr) {
+  if (raw.size() < FrameHeader::SIZE) return false;
+  std::vector<uint8_t> copy(raw);
+  scrambler::descramble(copy.data(), copy.size());
+  return FrameHeader::decode(copy.data(), copy.size(), hdr);
+}
+
+int main() {
+  MockRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{4, 4, 4, 4});
+  tx.setSendPause(0);
+
+  // Объёмное сообщение класса 2 разбивается на несколько кодированных фрагментов
+  std::vector<uint8_t> bulk(200);
+  for (size_t i = 0; i < bulk.size(); ++i) bulk[i] = static_cast<uint8_t>(i);
+  uint16_t bulk_id = tx.queue(bulk.data(), bulk.size(), 2);
+  assert(bulk_id != 0);
+  TxModuleTestAccessor::makeCoded(tx, 2, bulk_id);
+
+  assert(tx.loop());
+  assert(radio.history.size() == 1);
+  FrameHeader hdr;
+  assert(decodeHeader(radio.history[0], hdr));
+  assert(hdr.msg_id == bulk_id);
+  assert(hdr.getFragIdx() == 0);
+  const uint16_t total = hdr.frag_cnt;
+  assert(total >= 3);
+
+  // Короткое сообщение чата вклинивается между фрагментами объёмной передачи
+  const uint8_t chat[] = {'h', 'i'};
+  uint16_t chat_id = tx.queue(chat, sizeof(chat), 0);
+  assert(chat_id != 0);
+  assert(tx.loop());
+  assert(radio.history.size() == 2);
+  assert(radio.history[1] == std::vector<uint8_t>(chat, chat + sizeof(chat)));
+  assert(TxModuleTestAccessor::hasParked(tx, 2));
+
+  // Затем передача возобновляется со следующего фрагмента, а не с начала
+  for (uint16_t idx = 1; idx < total; ++idx) {
+    assert(tx.loop());
+    FrameHeader next;
+    assert(decodeHeader(radio.history.back(), next));
+    assert(next.msg_id == bulk_id);
+    assert(next.getFragIdx() == idx);
+  }
+  assert(!TxModuleTestAccessor::hasParked(tx, 2));
+  assert(!tx.loop());
+
+  // Сообщения одного класса не вытесняют друг друга
+  uint16_t first = tx.queue(bulk.data(), bulk.size(), 1);
+  TxModuleTestAccessor::makeCoded(tx, 1, first);
+  assert(tx.loop());
+  uint16_t same = tx.queue(chat, sizeof(chat), 1);
+  assert(same != 0);
+  size_t before = radio.history.size();
+  assert(tx.loop());
+  assert(radio.history.size() == before + 1);
+  assert(decodeHeader(radio.history.back(), hdr));
+  assert(hdr.msg_id == first);
+  assert(!TxModuleTestAccessor::hasParked(tx, 1));
+
+  std::cout << "OK" << std::endl;
+  return 0;
+}
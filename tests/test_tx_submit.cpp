@@ -0,0 +1,151 @@
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#define private public
+#include "tx_module.h"
+#undef private
+
+// Радиоинтерфейс, запоминающий отправленные кадры
+class RecordingRadio : public IRadio {
+public:
+  std::vector<std::vector<uint8_t>> sent;
+  int16_t send(const uint8_t* data, size_t len) override {
+    sent.emplace_back(data, data + len);
+    return ERR_NONE;
+  }
+  void setReceiveCallback(RxCallback) override {}
+};
+
+static std::vector<uint8_t> payload(size_t len, uint8_t seed) {
+  std::vector<uint8_t> out(len);
+  for (size_t i = 0; i < len; ++i) out[i] = static_cast<uint8_t>(seed + i * 31);
+  return out;
+}
+
+// Несколько задач ставят заявки одновременно, потребитель переносит их по ходу
+static void testConcurrentProducers() {
+  RecordingRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{64, 64, 64, 64});
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 40;
+  std::array<std::map<uint16_t, std::vector<uint8_t>>, kThreads> issued;
+  std::atomic<int> done{0};
+  std::vector<std::thread> producers;
+  for (int t = 0; t < kThreads; ++t) {
+    producers.emplace_back([&, t]() {
+      for (int i = 0; i < kPerThread; ++i) {
+        // каждая четвёртая заявка длиннее ячейки и идёт через отдельный блок
+        const size_t len = (i % 4 == 3) ? DefaultSettings::TX_SUBMIT_INLINE + 100 + i : 1 + i;
+        const auto data = payload(len, static_cast<uint8_t>(t * 50 + i));
+        uint16_t id = 0;
+        while ((id = tx.submit(data.data(), data.size(), static_cast<uint8_t>(t))) == 0) {
+          std::this_thread::yield();                     // очередь заявок заполнена — повторяем
+        }
+        assert(issued[t].emplace(id, data).second);      // идентификаторы класса не повторяются
+      }
+      done.fetch_add(1);
+    });
+  }
+  size_t moved = 0;
+  while (done.load() < kThreads) {
+    moved += tx.drainSubmissions();
+    std::this_thread::yield();
+  }
+  for (auto& th : producers) th.join();
+  moved += tx.drainSubmissions();
+  assert(moved == static_cast<size_t>(kThreads * kPerThread));
+  assert(tx.getSubmitLostCount() == 0);
+
+  for (int t = 0; t < kThreads; ++t) {
+    MessageBuffer& buf = tx.buffers_[t];
+    assert(buf.size() == static_cast<size_t>(kPerThread));
+    std::set<uint16_t> seen;
+    uint16_t id = 0;
+    std::vector<uint8_t> out;
+    while (buf.pop(id, out)) {
+      assert(issued[t].count(id) == 1);
+      assert(issued[t][id] == out);                       // данные дошли без искажений
+      assert(seen.insert(id).second);
+    }
+    assert(seen.size() == issued[t].size());
+  }
+}
+
+// Отказы: пустой ввод, слишком длинный plain, переполнение очереди заявок и очереди класса
+static void testRejectAndLoss() {
+  RecordingRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{2, 64, 64, 64});
+  const auto small = payload(8, 1);
+  const auto tooLong = payload(DefaultSettings::TX_PLAIN_MAX_LEN + 1, 2);
+  assert(tx.submit(nullptr, 4) == 0);
+  assert(tx.submit(small.data(), 0) == 0);
+  assert(tx.submit(tooLong.data(), tooLong.size(), 1, TxModule::SubmitMode::PLAIN) == 0);
+  assert(tx.getSubmitRejectedCount() == 3);
+
+  for (size_t i = 0; i < DefaultSettings::TX_SUBMIT_QUEUE; ++i) {
+    assert(tx.submit(small.data(), small.size(), 1) != 0);
+  }
+  assert(tx.submit(small.data(), small.size(), 1) == 0);    // заявки не перенесены — места нет
+  assert(tx.getSubmitRejectedCount() == 4);
+  assert(tx.drainSubmissions() == DefaultSettings::TX_SUBMIT_QUEUE);
+  assert(tx.buffers_[1].size() == DefaultSettings::TX_SUBMIT_QUEUE);
+
+  for (int i = 0; i < 3; ++i) assert(tx.submit(small.data(), small.size(), 0) != 0);
+  assert(tx.drainSubmissions() == 2);                       // в классе 0 только два места
+  assert(tx.getSubmitLostCount() == 1);
+}
+
+// Режимы заявок помечают сообщения так же, как queue()/queuePlain(), а loop() их отправляет
+static void testModesAndLoop() {
+  RecordingRadio radio;
+  TxModule tx(radio, std::array<size_t,4>{8, 8, 8, 8});
+  tx.setSendPause(0);
+  tx.setAirtimePacing(false);
+  const auto shortMsg = payload(12, 3);
+  const auto longMsg = payload(DefaultSettings::TX_PLAIN_MAX_LEN + 40, 4);
+  assert(tx.submit(longMsg.data(), longMsg.size(), 3) == 0);   // без явного включения — отказ
+  assert(tx.queue(longMsg.data(), longMsg.size(), 3) == 0);
+  tx.setFramedLongEnabled(true);
+  const uint16_t a = tx.submit(shortMsg.data(), shortMsg.size(), 2, TxModule::SubmitMode::PLAIN);
+  const uint16_t b = tx.submit(longMsg.data(), longMsg.size(), 3);
+  assert(a && b);
+  assert(tx.drainSubmissions() == 2);
+  assert(tx.plain_messages_.count(TxModule::queueKey(2, a)) == 1);
+  assert(tx.plain_messages_.count(TxModule::queueKey(3, b)) == 0); // длинное — фрагментами
+
+  RecordingRadio sendRadio;
+  TxModule sender(sendRadio, std::array<size_t,4>{8, 8, 8, 8});
+  sender.setSendPause(0);
+  sender.setAirtimePacing(false);
+  assert(sender.submit(shortMsg.data(), shortMsg.size()) != 0);
+  for (int i = 0; i < 5 && sendRadio.sent.empty(); ++i) sender.loop(); // перенос в начале loop()
+  assert(sendRadio.sent.size() == 1 && sendRadio.sent[0] == shortMsg);
+  // Ёмкость данных отправленного сообщения переходит следующему извлечённому из очереди
+  assert(sender.spare_data_.capacity() >= shortMsg.size());
+  const uint8_t* reused = sender.spare_data_.data();
+  assert(sender.queue(shortMsg.data(), shortMsg.size()) != 0);
+  for (int i = 0; i < 5 && sendRadio.sent.size() < 2; ++i) sender.loop();
+  assert(sendRadio.sent.size() == 2 && sendRadio.sent[1] == shortMsg);
+  assert(sender.spare_data_.data() == reused);
+
+  // Непринятые заявки с отдельным блоком освобождает деструктор
+  TxModule pending(sendRadio, std::array<size_t,4>{8, 8, 8, 8});
+  pending.setFramedLongEnabled(true);
+  assert(pending.submit(longMsg.data(), longMsg.size()) != 0);
+}
+
+int main() {
+  testConcurrentProducers();
+  testRejectAndLoss();
+  testModesAndLoop();
+  std::cout << "OK" << std::endl;
+  return 0;
+}